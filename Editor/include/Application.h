@@ -3,7 +3,9 @@
 #include <Starry.h>
 
 #include "FrameMetricDisplay.h"
+#include "ProfilerDisplay.h"
 
+#include <chrono>
 #include <memory>
  
 namespace Editor
@@ -11,6 +13,8 @@ namespace Editor
     struct ApplicationConfig {
 		bool enableFileLogging = false;
 		bool managerExitRights = true;
+		// Restores the scene saved on the last exit instead of building it, and saves it again on exit
+		bool sceneSnapshot = false;
 		const std::string packageName = "starry-editor";
     };
 
@@ -34,11 +38,22 @@ namespace Editor
         void init();
         void mainLoop();
         void cleanup();
+        // The scene built in code, unless a snapshot was asked for and could be read
+        void buildScene();
+
+        // Window only offers polling, so input is polled this often instead of in a spin
+        constexpr static std::chrono::milliseconds EVENT_POLL_INTERVAL = std::chrono::milliseconds(4);
+        // Keeps the render thread off a core it does not need, above common refresh rates
+        constexpr static double FRAME_RATE_LIMIT = 144.0;
+        // With ApplicationConfig::sceneSnapshot, saved on exit and loaded in place of buildScene on the next launch
+        constexpr static const char* SCENE_SNAPSHOT_PATH = "starry_out/scene.sscene";
+        static inline bool s_sceneSnapshot = false;
 
 		std::shared_ptr<Starry::Renderer> m_renderer = nullptr;
 		std::shared_ptr<Starry::Window> m_window = nullptr;
         std::shared_ptr<Starry::Scene> m_scene = nullptr;
 
         std::shared_ptr<FrameMetricDisplay> m_metricDisplay = nullptr;
+        std::shared_ptr<ProfilerDisplay> m_profilerDisplay = nullptr;
     };
 }
\ No newline at end of file
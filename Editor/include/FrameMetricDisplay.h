@@ -11,6 +11,7 @@ namespace Editor
             ~FrameMetricDisplay() {};
 
             void Init(size_t rendererUUID);
+            void setScene(std::shared_ptr<Starry::Scene>& sceneInput) { scene = sceneInput; }
             void Draw() override;
 
             OBJECT_NAME("Frame Metric");
@@ -18,5 +19,6 @@ namespace Editor
             void Overlay(std::string message);
 
             Starry::ResourceHandle<Starry::Timer> timer;
+            std::shared_ptr<Starry::Scene> scene = nullptr;
     };
 }
\ No newline at end of file
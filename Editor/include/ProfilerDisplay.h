@@ -0,0 +1,35 @@
+#pragma once
+
+#include <Starry.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace Editor
+{
+    // Flame view of the newest profiled frame on the render thread, with a button that saves a Chrome trace
+    class ProfilerDisplay : public Starry::UIElement
+    {
+        public:
+            ProfilerDisplay() {};
+            ~ProfilerDisplay() {};
+
+            void Draw() override;
+
+            OBJECT_NAME("Profiler");
+        private:
+            void refresh();
+            void drawFlame();
+
+            // Copying the rings is not free, so the view follows the frames a few times a second
+            constexpr static float REFRESH_SECONDS = 0.25f;
+            constexpr static float ROW_HEIGHT = 18.0f;
+            constexpr static const char* TRACE_FILE = "starry-trace.json";
+
+            bool paused = false;
+            std::vector<Starry::ProfileRecord> frame;
+            std::chrono::steady_clock::time_point lastRefresh{};
+            std::string status;
+    };
+}
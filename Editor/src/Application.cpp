@@ -25,11 +25,14 @@ namespace Editor
 	void Application::setConfig(const ApplicationConfig& config) 
 	{
 		Starry::AssetManager::InitManager(config.packageName);
+		s_sceneSnapshot = config.sceneSnapshot;
 
 		auto manager = Starry::AssetManager::get().lock();
 		if (!manager) return;
 		manager->setFileLogging(config.enableFileLogging);
 		manager->setExitRights(config.managerExitRights);
+		// Kept apart from the manager's log, two writers appending to one file would interleave mid line
+		if (config.enableFileLogging) Starry::AsyncLog::get().setLogFile("starry_out/async_log");
 	}
 
 	void Application::init() 
@@ -48,18 +51,35 @@ namespace Editor
 #endif
 		m_renderer = std::make_shared<Starry::Renderer>(m_window, config); ERROR_HANDLER_CHECK;
 		m_renderer->setScene(m_scene);
+		m_renderer->setFrameRateLimit(FRAME_RATE_LIMIT);
 
 		m_metricDisplay = std::make_shared<FrameMetricDisplay>();
 		m_metricDisplay->Init(m_renderer->getUUID());
+		m_metricDisplay->setScene(m_scene);
 		auto ptr = static_pointer_cast<Starry::UIElement>(m_metricDisplay);
 		m_renderer->loadUIElement(ptr, 1);
 
+		m_profilerDisplay = std::make_shared<ProfilerDisplay>();
+		auto profilerPtr = static_pointer_cast<Starry::UIElement>(m_profilerDisplay);
+		m_renderer->loadUIElement(profilerPtr, 2);
+
+		if (!s_sceneSnapshot || !Starry::SceneLoader::load(*m_scene, SCENE_SNAPSHOT_PATH)) {
+			buildScene();
+		}
+
+		ERROR_HANDLER_CHECK;
+
+		Alert(STARRY_INITIALIZE_SUCCESS, BANNER);
+	}
+	void Application::buildScene()
+	{
 		std::shared_ptr<Starry::CameraObject> camera = std::make_shared<Starry::CameraObject>();
 		camera->setFOV(60.0f);
 
 		std::shared_ptr<Starry::MeshObject> radio = std::make_shared<Starry::MeshObject>("Radio");
 #ifdef MODEL_PATH
-		radio->loadMeshFromFile(MODEL_PATH "radio.obj");
+		// Imported in the background, a placeholder draws until it is in
+		radio->loadMeshAsync(MODEL_PATH "radio.obj");
 #else
 #error "MODEL_PATH not defined!"
 #endif
@@ -73,11 +93,8 @@ namespace Editor
 		m_scene->pushObject(radioObject); 
 		auto cameraObject = static_pointer_cast<Starry::SceneObject>(camera);
 		m_scene->pushObject(cameraObject);
-
-		ERROR_HANDLER_CHECK;
-
-		Alert(STARRY_INITIALIZE_SUCCESS, BANNER);
 	}
+
 	void Application::mainLoop() 
 	{
 		m_renderer->disbatchRenderer(); 
@@ -86,8 +103,14 @@ namespace Editor
 		while (!m_window->shouldClose() && m_renderer->isRenderRunning().load()) {
 			m_window->pollEvents();
 			m_renderer->UIPollEvents();
+			// Sleeps between polls, a stopping render thread cuts it short
+			m_renderer->waitWhileRunning(EVENT_POLL_INTERVAL);
 		}
 		m_renderer->joinRenderer();
+
+		if (s_sceneSnapshot && !ERROR_HANDLER->isFatal() && !m_scene->save(SCENE_SNAPSHOT_PATH).get()) {
+			Alert("Could not save the scene snapshot.", WARNING);
+		}
 	}
 
 	// Destroy renderer then window last
@@ -96,6 +119,7 @@ namespace Editor
 		m_scene.reset();
 		m_renderer.reset();
 		m_window.reset();
+		Starry::AsyncLog::get().flush();
 
 		if (ERROR_HANDLER->isFatal()) {
 			Alert("\n----------> Program ended prematurly due to an error.\n", BANNER);
@@ -1,21 +1,37 @@
 #include "FrameMetricDisplay.h"
 
+#include <format>
+
 namespace Editor
 {
     void FrameMetricDisplay::Init(size_t rendererUUID)
     {
+        // Not waited on, Draw shows N/A until the renderer has answered
         timer = Request<Starry::Timer>(rendererUUID, "timer");
-        auto code = timer.wait();
     }
     
     void FrameMetricDisplay::Draw()
     {
         if (timer) {
-            std::string message = std::string("Frame Metrics:\n") + 
-                "FPS: " +
-                std::to_string((*timer).getFPS()) +
-                ", MS/frame: " +
-                std::format("{:0<4.3}", (*timer).getDeltaTimeMilliSeconds());
+            Starry::FrameTimeStats frames = (*timer).getFrameStats();
+            std::string message = std::string("Frame Metrics:\n") +
+                std::format("FPS: {:.0f}, MS/frame: {:.2f} avg over {} frames", frames.fps, frames.averageMs, frames.frames) +
+                std::format("\np50 {:.2f} / p95 {:.2f} / p99 {:.2f} / max {:.2f} ms", frames.p50Ms, frames.p95Ms, frames.p99Ms, frames.maxMs) +
+                std::format("\nHitches: {} recent, {} total", frames.hitches, frames.totalHitches);
+            if (scene) {
+                message += std::format("\nObjects: {} / {} visible", scene->getVisibleObjectCount(), scene->getTotalObjectCount());
+                // Every object is still its own draw, batches are what instancing would bring it down to
+                message += std::format("\nDraws: {}, batches (potential): {}", scene->getVisibleObjectCount(), scene->getInstanceBatchCount());
+            }
+            size_t loading = Starry::AssetLoader::get().pendingCount();
+            if (loading > 0) {
+                message += std::format("\nLoading: {} assets", loading);
+            }
+            Starry::MeshRegistryStats meshes = Starry::MeshRegistry::get().getStats();
+            if (meshes.meshes > 0) {
+                message += std::format("\nMeshes: {} unique / {} refs, {:.1f} MB (unshared {:.1f} MB)", meshes.meshes, meshes.references,
+                    meshes.bytes / (1024.0 * 1024.0), meshes.unsharedBytes / (1024.0 * 1024.0));
+            }
             Overlay(message);
         }
         else {
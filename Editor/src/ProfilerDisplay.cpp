@@ -0,0 +1,92 @@
+#include "ProfilerDisplay.h"
+
+#include <algorithm>
+#include <format>
+#include <functional>
+#include <string_view>
+
+namespace Editor
+{
+    void ProfilerDisplay::Draw()
+    {
+        ImGui::SetNextWindowSize(ImVec2(640.0f, 200.0f), ImGuiCond_FirstUseEver);
+        ImGui::Begin("Profiler");
+
+#ifdef STARRY_PROFILING
+        ImGui::Checkbox("Pause", &paused);
+        ImGui::SameLine();
+        if (ImGui::Button("Save Trace")) {
+            status = Starry::Profiler::writeChromeTrace(TRACE_FILE) ?
+                std::format("Saved {}, open it in Perfetto", TRACE_FILE) :
+                std::format("Could not write {}", TRACE_FILE);
+        }
+        if (!status.empty()) {
+            ImGui::SameLine();
+            ImGui::Text("%s", status.c_str());
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if (!paused && std::chrono::duration<float>(now - lastRefresh).count() >= REFRESH_SECONDS) {
+            refresh();
+            lastRefresh = now;
+        }
+        drawFlame();
+#else
+        ImGui::Text("Profiling is compiled out, configure Starry with STARRY_ENABLE_PROFILING");
+#endif
+        ImGui::End();
+    }
+
+    void ProfilerDisplay::refresh()
+    {
+        std::vector<Starry::ProfileRecord> latest;
+        // Keeps showing the last frame when the rings have nothing newer
+        if (Starry::Profiler::collectLatest("Frame", latest)) {
+            frame = std::move(latest);
+        }
+    }
+
+    void ProfilerDisplay::drawFlame()
+    {
+        if (frame.empty()) {
+            ImGui::Text("No frames recorded yet");
+            return;
+        }
+
+        const Starry::ProfileRecord& root = frame.front();
+        double frameNanos = static_cast<double>(std::max<uint64_t>(root.end - root.start, 1));
+        ImGui::Text("Frame: %.3f ms, %zu scopes", frameNanos / 1'000'000.0, frame.size());
+
+        ImDrawList* drawList = ImGui::GetWindowDrawList();
+        ImVec2 origin = ImGui::GetCursorScreenPos();
+        float width = std::max(ImGui::GetContentRegionAvail().x, 1.0f);
+
+        uint32_t rows = 1;
+        for (const Starry::ProfileRecord& record : frame) {
+            uint32_t row = record.depth - root.depth;
+            rows = std::max(rows, row + 1);
+
+            float x0 = origin.x + static_cast<float>((record.start - root.start) / frameNanos) * width;
+            float x1 = origin.x + static_cast<float>((record.end - root.start) / frameNanos) * width;
+            x1 = std::max(x1, x0 + 1.0f);
+            ImVec2 min(x0, origin.y + row * ROW_HEIGHT);
+            ImVec2 max(x1, min.y + ROW_HEIGHT - 1.0f);
+
+            // Same scope, same color from frame to frame
+            float hue = static_cast<float>(std::hash<std::string_view>{}(record.name) % 360) / 360.0f;
+            drawList->AddRectFilled(min, max, ImColor::HSV(hue, 0.45f, 0.75f));
+
+            float milliseconds = static_cast<float>((record.end - record.start) / 1'000'000.0);
+            if (x1 - x0 > 40.0f) {
+                std::string label = std::format("{} {:.2f}", record.name, milliseconds);
+                drawList->PushClipRect(min, max, true);
+                drawList->AddText(ImVec2(min.x + 3.0f, min.y + 2.0f), IM_COL32(20, 20, 20, 255), label.c_str());
+                drawList->PopClipRect();
+            }
+            if (ImGui::IsMouseHoveringRect(min, max)) {
+                ImGui::SetTooltip("%s\n%.3f ms", record.name, milliseconds);
+            }
+        }
+        ImGui::Dummy(ImVec2(width, rows * ROW_HEIGHT));
+    }
+}
@@ -1,7 +1,13 @@
 #include "Application.h"
 
-int main() {
-    const Editor::ApplicationConfig config;
+#include <string_view>
+
+int main(int argc, char** argv) {
+    Editor::ApplicationConfig config;
+    for (int i = 1; i < argc; i++) {
+        // Opt in, otherwise edits to buildScene would be hidden behind the last saved scene
+        if (std::string_view(argv[i]) == "--snapshot") config.sceneSnapshot = true;
+    }
 
 	Editor::Application::setConfig(config);
 
@@ -9,6 +9,18 @@ layout(location = 0) out vec3 fragColor;
 layout(location = 1) out vec4 fragNorm;
 layout(location = 2) out vec2 fragTexCoord;
 
+#ifdef STARRY_OBJECT_BUFFER
+// Starry::ObjectData, packed for every object once per frame by Starry::ObjectDataBuffer.
+// Each instanced draw passes its Starry::InstanceBatch firstInstance, the instances walk the entries after it.
+struct ObjectData {
+    mat4 modelViewProjection;
+    mat3x4 normalMatrix;
+};
+
+layout(std430, binding = 3) readonly buffer ObjectBuffer {
+    ObjectData objects[];
+};
+#else
 layout(binding = 0) uniform UniformBufferObject {
     mat4 model;
     mat4 view;
@@ -21,12 +33,19 @@ vec4 localToWorldNorm(vec3 localNormal, mat4 modelMatrix)
     vec3 worldNormal = normalize(normalMatrix * localNormal);
     return vec4(worldNormal, 0.0);
 }
+#endif
 
 void main() 
 {
+#ifdef STARRY_OBJECT_BUFFER
+    ObjectData object = objects[gl_InstanceIndex];
+    gl_Position = object.modelViewProjection * vec4(inPosition, 1.0);
+    fragNorm = vec4(normalize(mat3(object.normalMatrix) * inNorm), 0.0);
+#else
     mat4 mvpMatrix = ubo.proj * ubo.view * ubo.model;
     gl_Position = mvpMatrix * vec4(inPosition, 1.0);
-    fragColor = inColor;
     fragNorm = localToWorldNorm(inNorm, ubo.model);
+#endif
+    fragColor = inColor;
     fragTexCoord = inTexCoord;
-}
\ No newline at end of file
+}
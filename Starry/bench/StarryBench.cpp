@@ -0,0 +1,1183 @@
+#include <StarryManager.h>
+#include <StarryRender.h>
+
+#include "CameraObject.h"
+#include "CompactVertex.h"
+#include "DynamicAabbTree.h"
+#include "FrameLimiter.h"
+#include "FrameTimeRecorder.h"
+#include "InstanceBatcher.h"
+#include "JobSystem.h"
+#include "MeshObject.h"
+#include "MeshRegistry.h"
+#include "Meshlet.h"
+#include "NullBackend.h"
+#include "ObjectDataBuffer.h"
+#include "ObjImporter.h"
+#include "Renderer.h"
+#include "Scene.h"
+#include "SceneFile.h"
+#include "SlotMap.h"
+#include "SoftwareRasterizer.h"
+#include "TextureCache.h"
+#include "TextureCooker.h"
+#include "TransformStore.h"
+#include "TransformKernels.h"
+#include "Parallel.h"
+#include "VertexWelder.h"
+
+#include <glm/gtc/constants.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#ifndef BENCH_MODEL_PATH
+#define BENCH_MODEL_PATH ""
+#endif
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	using BenchVertex = Render::Vertex;
+	using BenchVertexHash = std::hash<Render::Vertex>;
+	using BenchWelder = Starry::VertexWelder<BenchVertex, BenchVertexHash>;
+
+	// Every number printed is also kept here for --json
+	struct Metric {
+		std::string group;
+		std::string name;
+		double value = 0.0;
+		std::string unit;
+	};
+	std::vector<Metric> metrics;
+
+	void report(const std::string& group, const std::string& name, double value, const std::string& unit)
+	{
+		metrics.push_back({ group, name, value, unit });
+	}
+
+	std::string jsonString(const std::string& text)
+	{
+		std::string quoted = "\"";
+		for (char c : text) {
+			if (c == '"' || c == '\\') quoted += '\\';
+			if (static_cast<unsigned char>(c) < 0x20) continue;
+			quoted += c;
+		}
+		return quoted + "\"";
+	}
+
+	bool writeJson(const std::string& filePath, const std::string& model, int iterations, int frames)
+	{
+		std::FILE* file = std::fopen(filePath.c_str(), "w");
+		if (file == nullptr) return false;
+
+#ifdef STARRY_HEADLESS
+		const char* build = "headless";
+#else
+		const char* build = "full";
+#endif
+		std::fprintf(file, "{\n  \"benchmark\": \"starry_bench\",\n  \"config\": {\n");
+		std::fprintf(file, "    \"build\": \"%s\",\n    \"model\": %s,\n", build, jsonString(model).c_str());
+		std::fprintf(file, "    \"iterations\": %d,\n    \"frames\": %d,\n", iterations, frames);
+		std::fprintf(file, "    \"threads\": %zu,\n    \"transformKernel\": \"%s\"\n  },\n", Starry::defaultThreadCount(),
+			Starry::TransformKernels::activeKernel());
+		std::fprintf(file, "  \"results\": [\n");
+		for (size_t i = 0; i < metrics.size(); i++) {
+			const Metric& metric = metrics[i];
+			std::fprintf(file, "    { \"group\": %s, \"name\": %s, \"value\": %.6g, \"unit\": %s }%s\n", jsonString(metric.group).c_str(),
+				jsonString(metric.name).c_str(), metric.value, jsonString(metric.unit).c_str(), i + 1 < metrics.size() ? "," : "");
+		}
+		std::fprintf(file, "  ]\n}\n");
+		return std::fclose(file) == 0;
+	}
+
+	struct Result {
+		double bestSeconds = 0.0;
+		size_t triangles = 0; // Or whatever count the work reports
+	};
+
+	template <typename Work>
+	Result measure(int iterations, Work&& work)
+	{
+		Result result{};
+		for (int i = 0; i < iterations; i++) {
+			auto start = Clock::now();
+			size_t triangles = work();
+			double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+			if (i == 0 || seconds < result.bestSeconds) {
+				result.bestSeconds = seconds;
+			}
+			result.triangles = triangles;
+		}
+		return result;
+	}
+
+	double megabytesPerSecond(size_t bytes, double seconds)
+	{
+		if (seconds <= 0.0) return 0.0;
+		return (static_cast<double>(bytes) / (1024.0 * 1024.0)) / seconds;
+	}
+
+	// Encode time and size of the 16 byte layout against Render::Vertex and 32 bit indices, with the worst
+	// round trip error of each attribute
+	void benchVertexCompression(int iterations, const std::vector<BenchVertex>& vertices, const std::vector<uint32_t>& indices)
+	{
+		Starry::CompactMesh compact;
+		Result encoded = measure(iterations, [&]() {
+			Starry::VertexCompression::encode(compact, vertices, indices);
+			return compact.vertices.size();
+		});
+
+		float positionError = 0.0f, normalError = 0.0f, texCoordError = 0.0f;
+		for (size_t i = 0; i < vertices.size(); i++) {
+			float position[3], normal[3], texCoord[2];
+			Starry::VertexCompression::decodePosition(compact, compact.vertices[i], position);
+			Starry::VertexCompression::decodeNormal(compact.vertices[i], normal);
+			Starry::VertexCompression::decodeTexCoord(compact.vertices[i], texCoord);
+			for (int c = 0; c < 3; c++) {
+				positionError = std::max(positionError, std::abs(position[c] - vertices[i].position[c]));
+			}
+			float length = glm::length(vertices[i].normal);
+			if (length > 0.0f) {
+				float cosine = glm::dot(glm::vec3(normal[0], normal[1], normal[2]), vertices[i].normal / length);
+				normalError = std::max(normalError, glm::degrees(std::acos(std::clamp(cosine, -1.0f, 1.0f))));
+			}
+			for (int c = 0; c < 2; c++) {
+				texCoordError = std::max(texCoordError, std::abs(texCoord[c] - vertices[i].texCoord[c]));
+			}
+		}
+
+		size_t standardBytes = vertices.size() * sizeof(BenchVertex) + indices.size() * sizeof(uint32_t);
+		size_t compactBytes = compact.vertexBytes() + compact.indexBytes();
+		std::printf("Vertex compression: %zu vertices, %zu indices (best of %d)\n", vertices.size(), indices.size(), iterations);
+		std::printf("  %-10s %10.3f ms %10.2f MB -> %.2f MB, %d bit indices%s\n", "encode", encoded.bestSeconds * 1000.0,
+			standardBytes / (1024.0 * 1024.0), compactBytes / (1024.0 * 1024.0), compact.hasShortIndices() ? 16 : 32,
+			compact.hasColorStream() ? ", color stream" : "");
+		std::printf("  %-10s position %.2e, normal %.3f deg, texCoord %.2e\n", "max error", positionError, normalError, texCoordError);
+		report("vertex_compression", "encode", encoded.bestSeconds * 1000.0, "ms");
+		report("vertex_compression", "ratio", standardBytes > 0 ? static_cast<double>(compactBytes) / standardBytes : 0.0, "");
+	}
+
+	// 100k objects scattered over a field much larger than the view distance. A tenth of them drift every
+	// frame while the camera circles the middle.
+	void benchSceneCulling(int frames)
+	{
+		const size_t objectCount = 100000;
+		const float fieldSize = 4000.0f;
+		const float viewDistance = 500.0f;
+
+		std::mt19937 random(7);
+		std::uniform_real_distribution<float> position(-fieldSize * 0.5f, fieldSize * 0.5f);
+		std::uniform_real_distribution<float> size(0.5f, 3.0f);
+		std::uniform_real_distribution<float> speed(-0.05f, 0.05f);
+
+		std::vector<Starry::Aabb> bounds(objectCount);
+		std::vector<glm::vec3> velocities(objectCount, glm::vec3(0.0f));
+		for (size_t i = 0; i < objectCount; i++) {
+			glm::vec3 center(position(random), position(random) * 0.01f, position(random));
+			glm::vec3 half(size(random));
+			bounds[i] = { center - half, center + half };
+			if (i % 10 == 0) velocities[i] = { speed(random), 0.0f, speed(random) };
+		}
+
+		Starry::DynamicAabbTree tree;
+		std::vector<int32_t> proxies(objectCount);
+		auto buildStart = Clock::now();
+		for (size_t i = 0; i < objectCount; i++) {
+			proxies[i] = tree.createProxy(bounds[i], &bounds[i]);
+		}
+		double buildSeconds = std::chrono::duration<double>(Clock::now() - buildStart).count();
+
+		glm::mat4 proj = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, viewDistance);
+		proj[1][1] *= -1;
+
+		double refitSeconds = 0.0, treeSeconds = 0.0, bruteSeconds = 0.0;
+		size_t visible = 0, reinserted = 0;
+		for (int frame = 0; frame < frames; frame++) {
+			auto refitStart = Clock::now();
+			for (size_t i = 0; i < objectCount; i += 10) {
+				bounds[i].min += velocities[i];
+				bounds[i].max += velocities[i];
+				reinserted += tree.moveProxy(proxies[i], bounds[i], velocities[i]);
+			}
+			refitSeconds += std::chrono::duration<double>(Clock::now() - refitStart).count();
+
+			float angle = glm::two_pi<float>() * frame / frames;
+			glm::vec3 eye = glm::vec3(std::cos(angle), 0.05f, std::sin(angle)) * viewDistance * 0.5f;
+			Starry::Frustum frustum(proj * glm::lookAt(eye, glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f)));
+
+			auto treeStart = Clock::now();
+			size_t found = 0;
+			tree.queryFrustum(frustum, [&](void*) { found++; });
+			treeSeconds += std::chrono::duration<double>(Clock::now() - treeStart).count();
+			visible += found;
+
+			auto bruteStart = Clock::now();
+			size_t bruteFound = 0;
+			for (const auto& box : bounds) {
+				bruteFound += frustum.intersectsAabb(box.min, box.max);
+			}
+			bruteSeconds += std::chrono::duration<double>(Clock::now() - bruteStart).count();
+		}
+
+		std::printf("Scene culling: %zu objects, tree height %d, build %.3f ms\n", objectCount, tree.getHeight(), buildSeconds * 1000.0);
+		std::printf("  %d frames: %.1f visible avg, %.1f reinserts per frame\n", frames,
+			static_cast<double>(visible) / frames, static_cast<double>(reinserted) / frames);
+		std::printf("  %-10s %10.3f ms per frame\n", "refit", refitSeconds * 1000.0 / frames);
+		std::printf("  %-10s %10.3f ms per frame\n", "tree", treeSeconds * 1000.0 / frames);
+		std::printf("  %-10s %10.3f ms per frame\n", "brute", bruteSeconds * 1000.0 / frames);
+
+		report("scene_culling", "build", buildSeconds * 1000.0, "ms");
+		report("scene_culling", "refit", refitSeconds * 1000.0 / frames, "ms/frame");
+		report("scene_culling", "tree", treeSeconds * 1000.0 / frames, "ms/frame");
+		report("scene_culling", "brute", bruteSeconds * 1000.0 / frames, "ms/frame");
+	}
+
+	void benchTransforms(int iterations)
+	{
+		const size_t objectCount = 100000;
+
+		Starry::TransformStore store;
+		for (size_t i = 0; i < objectCount; i++) {
+			float offset = static_cast<float>(i);
+			Starry::LocalTransform local;
+			local.translation = glm::vec3(offset, 0.0f, -offset);
+			local.rotation = glm::angleAxis(offset, glm::vec3(0.0f, 1.0f, 0.0f));
+			store.create(local);
+		}
+		store.updateWorldMatrices();
+		glm::mat4 viewProjection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 1000.0f) *
+			glm::lookAt(glm::vec3(0.0f, 10.0f, 30.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+
+		std::vector<glm::mat4> output(objectCount);
+		Result scalar = measure(iterations, [&]() {
+			Starry::TransformKernels::multiplyScalar(viewProjection, store.modelData(), output.data(), objectCount);
+			return objectCount;
+		});
+		// Batched the way Scene::present runs it
+		Result batched = measure(iterations, [&]() {
+			Starry::JobSystem::get().parallelFor(objectCount, Starry::TransformStore::PARALLEL_MATRICES, [&](size_t begin, size_t end) {
+				Starry::TransformKernels::multiply(viewProjection, store.modelData() + begin, output.data() + begin, end - begin);
+			});
+			return objectCount;
+		});
+
+		auto rate = [&](double seconds) { return seconds > 0.0 ? (objectCount / 1e6) / seconds : 0.0; };
+
+		std::printf("Model view projection: %zu transforms (best of %d)\n", objectCount, iterations);
+		std::printf("  %-10s %10.3f ms %10.1f Mmatrices/s\n", "scalar", scalar.bestSeconds * 1000.0, rate(scalar.bestSeconds));
+		std::printf("  %-10s %10.3f ms %10.1f Mmatrices/s\n", Starry::TransformKernels::activeKernel(),
+			batched.bestSeconds * 1000.0, rate(batched.bestSeconds));
+
+		report("model_view_projection", "scalar", rate(scalar.bestSeconds), "Mmatrices/s");
+		report("model_view_projection", Starry::TransformKernels::activeKernel(), rate(batched.bestSeconds), "Mmatrices/s");
+	}
+
+	// Chains of ten transforms where one root in a hundred moves per frame
+	void benchHierarchy(int iterations)
+	{
+		const size_t chainLength = 10;
+		const size_t chainCount = 10000;
+
+		Starry::TransformStore store;
+		std::vector<Starry::TransformStore::Handle> roots;
+		for (size_t chain = 0; chain < chainCount; chain++) {
+			Starry::TransformStore::Handle parent = Starry::TransformStore::INVALID_HANDLE;
+			for (size_t i = 0; i < chainLength; i++) {
+				Starry::LocalTransform local;
+				local.translation = glm::vec3(1.0f, 0.0f, 0.0f);
+				local.rotation = glm::angleAxis(0.1f, glm::vec3(0.0f, 1.0f, 0.0f));
+				Starry::TransformStore::Handle handle = store.create(local);
+				store.setParent(handle, parent);
+				if (parent == Starry::TransformStore::INVALID_HANDLE) roots.push_back(handle);
+				parent = handle;
+			}
+		}
+		store.updateWorldMatrices();
+
+		size_t frame = 0;
+		Result dirty = measure(iterations, [&]() {
+			for (size_t chain = frame++ % 100; chain < chainCount; chain += 100) {
+				Starry::LocalTransform local = store.getLocal(roots[chain]);
+				local.translation.y += 0.01f;
+				store.setLocal(roots[chain], local);
+			}
+			return store.updateWorldMatrices();
+		});
+		Result full = measure(iterations, [&]() {
+			for (Starry::TransformStore::Handle root : roots) {
+				store.setLocal(root, store.getLocal(root));
+			}
+			return store.updateWorldMatrices();
+		});
+
+		std::printf("Transform hierarchy: %zu transforms in chains of %zu (best of %d)\n", store.size(), chainLength, iterations);
+		std::printf("  %-10s %10.3f ms %10zu updated\n", "full", full.bestSeconds * 1000.0, full.triangles);
+		std::printf("  %-10s %10.3f ms %10zu updated\n", "dirty", dirty.bestSeconds * 1000.0, dirty.triangles);
+
+		report("transform_hierarchy", "full", full.bestSeconds * 1000.0, "ms");
+		report("transform_hierarchy", "dirty", dirty.bestSeconds * 1000.0, "ms");
+	}
+
+	// Per-object uniform writes against one packed pass over the object buffer
+	void benchObjectData(int iterations)
+	{
+		const size_t objectCount = 100000;
+
+		std::mt19937 random(7);
+		std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+		std::vector<glm::mat4> models(objectCount);
+		for (auto& model : models) {
+			Starry::LocalTransform local;
+			local.translation = glm::vec3(unit(random), unit(random), unit(random)) * 100.0f;
+			local.rotation = glm::angleAxis(unit(random) * 3.0f, glm::normalize(glm::vec3(unit(random), 1.0f, unit(random))));
+			local.scale = glm::vec3(1.5f + unit(random), 1.0f, 1.5f - unit(random));
+			model = local.matrix();
+		}
+		glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 10.0f, 30.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+		glm::mat4 proj = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 1000.0f);
+
+		std::printf("Object data: %zu objects (best of %d)\n", objectCount, iterations);
+
+		// What every MeshObject writes into its own uniform today, one small allocation each
+		std::vector<std::unique_ptr<Render::UniformData>> uniforms(objectCount);
+		for (auto& uniform : uniforms) {
+			uniform = std::make_unique<Render::UniformData>(1.0f, 1.0f, 1.0f);
+		}
+		Result perObject = measure(iterations, [&]() {
+			for (size_t i = 0; i < objectCount; i++) {
+				uniforms[i]->model = models[i];
+				uniforms[i]->view = view;
+				uniforms[i]->proj = proj;
+			}
+			return objectCount;
+		});
+		std::printf("  %-10s %10.3f ms %10.2f MB, matrices multiplied per vertex\n", "uniforms",
+			perObject.bestSeconds * 1000.0, objectCount * sizeof(Render::UniformData) / (1024.0 * 1024.0));
+		report("object_data", "uniforms", perObject.bestSeconds * 1000.0, "ms");
+
+		Starry::ObjectDataBuffer buffer;
+		Result packed = measure(iterations, [&]() {
+			buffer.pack(proj * view, models.data(), objectCount);
+			return objectCount;
+		});
+
+		std::printf("  %-10s %10.3f ms %10.2f MB, MVP and normal matrix precomputed\n", "packed",
+			packed.bestSeconds * 1000.0, objectCount * sizeof(Starry::ObjectData) / (1024.0 * 1024.0));
+		report("object_data", "packed", packed.bestSeconds * 1000.0, "ms");
+	}
+
+	// 100k objects drawn from 50 meshes and 4 textures, pushed in random order. Loads go through the
+	// registry, draws through the batcher.
+	void benchInstancing(int iterations, const Starry::ObjMeshData& mesh)
+	{
+		const size_t objectCount = 100000;
+		const size_t meshCount = 50;
+		const size_t textureCount = 4;
+
+		std::mt19937 random(11);
+		std::vector<uint64_t> keys(objectCount);
+		std::vector<uint64_t> meshKeys(objectCount);
+		for (size_t i = 0; i < objectCount; i++) {
+			meshKeys[i] = 1 + random() % meshCount;
+			keys[i] = meshKeys[i] * textureCount + random() % textureCount;
+		}
+		std::printf("Instancing: %zu objects, %zu meshes x %zu textures (best of %d)\n", objectCount, meshCount, textureCount, iterations);
+
+		std::vector<std::shared_ptr<Starry::MeshGeometry>> loaded(objectCount);
+		auto start = Clock::now();
+		for (size_t i = 0; i < objectCount; i++) {
+			loaded[i] = Starry::MeshRegistry::get().acquire(meshKeys[i], [&](Starry::MeshGeometry& geometry) {
+				geometry.indices.resize(mesh.corners.size());
+				geometry.vertices.resize(mesh.positions.size() / 3);
+				return true;
+			});
+		}
+		double loadSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+		Starry::MeshRegistryStats stats = Starry::MeshRegistry::get().getStats();
+
+		std::printf("  %-10s %10.3f ms %10zu builds for %zu requests, %.2f MB instead of %.2f MB\n", "registry", loadSeconds * 1000.0,
+			stats.builds, stats.requests, stats.bytes / (1024.0 * 1024.0), stats.unsharedBytes / (1024.0 * 1024.0));
+		report("instancing", "registry", loadSeconds * 1000.0, "ms");
+
+		Starry::InstanceBatcher batcher;
+		Result batched = measure(iterations, [&]() {
+			batcher.build(keys.data(), keys.size());
+			return batcher.getBatches().size();
+		});
+
+		std::printf("  %-10s %10.3f ms %10zu draws instead of %zu\n", "batching", batched.bestSeconds * 1000.0, batched.triangles, objectCount);
+		report("instancing", "batching", batched.bestSeconds * 1000.0, "ms");
+	}
+
+	// 2048x2048 RGBA8 texture through mips, block compression and the .stex cache. The bench has no image
+	// decoder, so the "file" is raw pixels behind a size header.
+	void benchTextureCooking(int iterations)
+	{
+		Starry::TextureImageData image;
+		image.width = 2048;
+		image.height = 2048;
+		image.pixels.resize(static_cast<size_t>(image.width) * image.height * 4);
+		for (uint32_t y = 0; y < image.height; y++) {
+			for (uint32_t x = 0; x < image.width; x++) {
+				uint8_t* texel = &image.pixels[(static_cast<size_t>(y) * image.width + x) * 4];
+				texel[0] = static_cast<uint8_t>(128.0f + 127.0f * std::sin(x * 0.013f + y * 0.002f));
+				texel[1] = static_cast<uint8_t>(128.0f + 127.0f * std::cos(y * 0.017f));
+				texel[2] = static_cast<uint8_t>((x ^ y) & 0xff);
+				texel[3] = 255;
+			}
+		}
+
+		std::vector<uint8_t> mip((image.width / 2) * (image.height / 2) * 4);
+		Result mips = measure(iterations, [&]() {
+			Starry::TextureCooker::downsample(image.pixels.data(), image.width, image.height, mip.data());
+			return mip.size();
+		});
+
+		std::vector<uint8_t> blocks(Starry::TextureCooker::levelSize(Starry::TextureFormat::BC3, image.width, image.height));
+		Result bc1 = measure(iterations, [&]() {
+			Starry::TextureCooker::encodeBC1(image.pixels.data(), image.width, image.height, blocks.data());
+			return blocks.size();
+		});
+		Result bc3 = measure(iterations, [&]() {
+			Starry::TextureCooker::encodeBC3(image.pixels.data(), image.width, image.height, blocks.data());
+			return blocks.size();
+		});
+
+		std::filesystem::path rawPath = std::filesystem::temp_directory_path() / "starry_bench_texture.raw";
+		{
+			std::ofstream raw(rawPath, std::ios::binary | std::ios::trunc);
+			raw.write(reinterpret_cast<const char*>(&image.width), sizeof(uint32_t));
+			raw.write(reinterpret_cast<const char*>(&image.height), sizeof(uint32_t));
+			raw.write(reinterpret_cast<const char*>(image.pixels.data()), static_cast<std::streamsize>(image.pixels.size()));
+		}
+		Starry::TextureCooker::setDecoder([](const char* data, size_t size, Starry::TextureImageData& decoded) {
+			if (size < 8) return false;
+			std::memcpy(&decoded.width, data, sizeof(uint32_t));
+			std::memcpy(&decoded.height, data + 4, sizeof(uint32_t));
+			decoded.pixels.assign(data + 8, data + size);
+			return true;
+		});
+
+		Starry::TextureCookOptions options{};
+		Starry::CookedTexture cooked;
+		std::string cachePath = Starry::TextureCache::cachePathFor(rawPath.string(), "", 0);
+		Result cold = measure(iterations, [&]() {
+			std::filesystem::remove(cachePath);
+			Starry::TextureCooker::cookFile(rawPath.string(), "", options, cooked);
+			return cooked.data.size();
+		});
+		Result warm = measure(iterations, [&]() {
+			Starry::TextureCooker::cookFile(rawPath.string(), "", options, cooked);
+			return cooked.data.size();
+		});
+
+		size_t uncompressed = 0;
+		for (const auto& level : cooked.mips) {
+			uncompressed += Starry::TextureCooker::levelSize(Starry::TextureFormat::RGBA8, level.width, level.height);
+		}
+		std::filesystem::remove(cachePath);
+		std::filesystem::remove(rawPath);
+		Starry::TextureCooker::setDecoder({});
+
+		std::printf("Texture cooking: %ux%u RGBA8 (best of %d)\n", image.width, image.height, iterations);
+		std::printf("  %-10s %10.3f ms\n", "mip", mips.bestSeconds * 1000.0);
+		std::printf("  %-10s %10.3f ms\n", "bc1", bc1.bestSeconds * 1000.0);
+		std::printf("  %-10s %10.3f ms\n", "bc3", bc3.bestSeconds * 1000.0);
+		std::printf("  %-10s %10.3f ms %10.2f MB -> %.2f MB with %zu mips\n", "cold", cold.bestSeconds * 1000.0,
+			uncompressed / (1024.0 * 1024.0), cooked.data.size() / (1024.0 * 1024.0), cooked.mips.size());
+		std::printf("  %-10s %10.3f ms from the cache\n", "warm", warm.bestSeconds * 1000.0);
+
+		report("texture_cooking", "mip", mips.bestSeconds * 1000.0, "ms");
+		report("texture_cooking", "bc1", bc1.bestSeconds * 1000.0, "ms");
+		report("texture_cooking", "bc3", bc3.bestSeconds * 1000.0, "ms");
+		report("texture_cooking", "cold", cold.bestSeconds * 1000.0, "ms");
+		report("texture_cooking", "warm", warm.bestSeconds * 1000.0, "ms");
+	}
+
+	// Per object animation, composition and model view projection, the shape of the scene update, on pools of growing size
+	void benchJobScaling(int iterations)
+	{
+		const size_t objectCount = 100000;
+
+		std::vector<Starry::LocalTransform> locals(objectCount);
+		std::vector<glm::mat4> output(objectCount);
+		for (size_t i = 0; i < objectCount; i++) {
+			locals[i].translation = glm::vec3(static_cast<float>(i % 100), 0.0f, static_cast<float>(i / 100));
+		}
+		glm::quat step = glm::angleAxis(0.01f, glm::vec3(0.0f, 1.0f, 0.0f));
+		glm::mat4 viewProjection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 1000.0f);
+
+		std::printf("Job system: %zu object updates (best of %d)\n", objectCount, iterations);
+		double singleSeconds = 0.0;
+		for (size_t threads = 1; threads <= Starry::defaultThreadCount(); threads *= 2) {
+			Starry::JobSystem jobs(threads - 1);
+			Result result = measure(iterations, [&]() {
+				jobs.parallelFor(objectCount, 64, [&](size_t begin, size_t end) {
+					for (size_t i = begin; i < end; i++) {
+						locals[i].rotation = glm::normalize(locals[i].rotation * step);
+						output[i] = viewProjection * locals[i].matrix();
+					}
+				});
+				return objectCount;
+			});
+			if (threads == 1) singleSeconds = result.bestSeconds;
+
+			std::printf("  %2zu threads %10.3f ms %8.2fx\n", threads, result.bestSeconds * 1000.0,
+				result.bestSeconds > 0.0 ? singleSeconds / result.bestSeconds : 0.0);
+			report("job_scaling", std::to_string(threads) + " threads", result.bestSeconds * 1000.0, "ms");
+		}
+	}
+
+	// Orbits the origin at the same radius whatever the scene size, so the visible set stays about the same
+	class OrbitCamera : public Starry::CameraObject {
+		public:
+			explicit OrbitCamera(int ticksPerOrbit) : CameraObject("Orbit"), ticksPerOrbit(ticksPerOrbit) {}
+
+			void Update(Starry::Renderer* renderer) override
+			{
+				float orbit = glm::two_pi<float>() * tick++ / ticksPerOrbit;
+				glm::vec3 eye = glm::vec3(std::cos(orbit) * 20.0f, 8.0f, std::sin(orbit) * 20.0f);
+				mvpBufferData.view = glm::lookAt(eye, glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+				CameraObject::Update(renderer);
+			}
+
+		private:
+			int ticksPerOrbit;
+			int tick = 0;
+	};
+
+	// Scene::updateObjects on a generated scene with the density held constant, drawn by the null backend.
+	// Meshes spin in their Update, so each tick recomputes and refits world matrices before the orbiting
+	// camera picks the visible set that is batched into instanced draws. Only updateObjects is timed.
+	void benchSceneUpdate(int frames, size_t objectCount)
+	{
+		const size_t meshCount = 50;
+		const float fieldSize = 4.0f * std::sqrt(static_cast<float>(objectCount));
+
+		std::mt19937 random(static_cast<uint32_t>(objectCount));
+		std::uniform_real_distribution<float> position(-fieldSize * 0.5f, fieldSize * 0.5f);
+		std::uniform_real_distribution<float> angle(0.0f, glm::two_pi<float>());
+
+		std::shared_ptr<Starry::Window> window = nullptr;
+		Starry::RenderConfig config("", "", Starry::RenderConfig::MSAAOptions::MSAA_DISABLED, { 0.0f, 0.0f, 0.0f });
+		config.backend = Starry::RenderBackendType::NONE;
+		Starry::Renderer renderer(window, config);
+		Starry::Scene scene("Bench");
+
+		// A unit quad per mesh, told apart by colour so each hashes to its own registry entry
+		std::vector<std::vector<Render::Vertex>> meshVertices(meshCount, std::vector<Render::Vertex>(4));
+		const std::vector<uint32_t> meshIndices = { 0, 1, 2, 2, 3, 0 };
+		for (size_t mesh = 0; mesh < meshCount; mesh++) {
+			for (int corner = 0; corner < 4; corner++) {
+				Render::Vertex& vertex = meshVertices[mesh][corner];
+				vertex.position = glm::vec3(corner == 1 || corner == 2 ? 0.5f : -0.5f, corner >= 2 ? 0.5f : -0.5f, 0.0f);
+				vertex.normal = glm::vec3(0.0f, 0.0f, 1.0f);
+				vertex.color = glm::vec3(static_cast<float>(mesh) / meshCount, 1.0f, 1.0f);
+			}
+		}
+
+		std::vector<std::shared_ptr<Starry::SceneObject>> objects;
+		objects.reserve(objectCount + 1);
+		for (size_t i = 0; i < objectCount; i++) {
+			auto mesh = std::make_shared<Starry::MeshObject>("Bench " + std::to_string(i));
+			mesh->addVertexData(meshVertices[random() % meshCount], meshIndices);
+			Starry::LocalTransform local;
+			local.translation = glm::vec3(position(random), 0.0f, position(random));
+			local.rotation = glm::angleAxis(angle(random), glm::vec3(0.0f, 1.0f, 0.0f));
+			mesh->setLocalTransform(local);
+			objects.push_back(mesh);
+		}
+		objects.push_back(std::make_shared<OrbitCamera>(frames));
+		scene.pushObjects(objects);
+		scene.loadObjects(&renderer);
+
+		size_t visibleTotal = 0, batchTotal = 0, drawTotal = 0;
+		double seconds = 0.0;
+		for (int frame = 0; frame < frames; frame++) {
+			auto start = Clock::now();
+			scene.updateObjects(&renderer);
+			seconds += std::chrono::duration<double>(Clock::now() - start).count();
+
+			visibleTotal += scene.getVisibleObjectCount();
+			batchTotal += scene.getInstanceBatchCount();
+			// Swaps out the recorded frame, which would otherwise grow by every upload of every tick
+			renderer.context().Draw();
+			drawTotal += static_cast<Starry::NullBackend&>(renderer.context()).getLastFrameStats().draws;
+		}
+		double tickMs = seconds * 1000.0 / frames;
+
+		std::printf("  %8zu objects %10.3f ms per tick %10.1f visible %8.1f batches %8.1f draws\n", objectCount, tickMs,
+			static_cast<double>(visibleTotal) / frames, static_cast<double>(batchTotal) / frames,
+			static_cast<double>(drawTotal) / frames);
+		report("scene_update", std::to_string(objectCount) + " objects", tickMs, "ms/tick");
+	}
+
+	// Recording runs on the render thread every frame, snapshots come from the overlay a few times a second
+	void benchFrameTimes(int iterations)
+	{
+		const size_t frameCount = 1000000;
+		const int snapshots = 100;
+
+		// Mostly 60 Hz with some jitter and a hitch every few hundred frames
+		std::mt19937 random(5);
+		std::lognormal_distribution<double> jitter(std::log(16.6e6), 0.08);
+		std::vector<uint64_t> samples(frameCount);
+		for (size_t i = 0; i < frameCount; i++) {
+			samples[i] = static_cast<uint64_t>(jitter(random) * (random() % 300 == 0 ? 3.0 : 1.0));
+		}
+
+		auto recorder = std::make_unique<Starry::FrameTimeRecorder>();
+		Result recording = measure(iterations, [&]() {
+			recorder->reset();
+			for (uint64_t sample : samples) {
+				recorder->record(sample);
+			}
+			return frameCount;
+		});
+
+		Starry::FrameTimeStats stats{};
+		Result snapshot = measure(iterations, [&]() {
+			for (int i = 0; i < snapshots; i++) {
+				stats = recorder->snapshot();
+			}
+			return stats.frames;
+		});
+
+		double recordNs = recording.bestSeconds * 1e9 / frameCount;
+		double snapshotUs = snapshot.bestSeconds * 1e6 / snapshots;
+		std::printf("Frame times: %zu frames (best of %d)\n", frameCount, iterations);
+		std::printf("  %-10s %10.2f ns per frame\n", "record", recordNs);
+		std::printf("  %-10s %10.2f us per snapshot, p50 %.2f ms, p99 %.2f ms, %zu hitches in the window\n", "snapshot", snapshotUs,
+			stats.p50Ms, stats.p99Ms, stats.hitches);
+		report("frame_times", "record", recordNs, "ns/frame");
+		report("frame_times", "snapshot", snapshotUs, "us");
+	}
+
+	// Scene object storage before and after handles: a name keyed map against the slot map, holding shared
+	// pointers as Scene does. Churn spawns and despawns a tenth of the objects per round.
+	void benchObjectStorage(int iterations)
+	{
+		const size_t objectCount = 100000;
+		const size_t churnCount = objectCount / 10;
+		struct Object {
+			float value = 1.0f;
+		};
+
+		std::vector<std::string> names(objectCount + churnCount);
+		for (size_t i = 0; i < names.size(); i++) {
+			names[i] = "Object " + std::to_string(i);
+		}
+		std::vector<std::shared_ptr<Object>> objects(names.size());
+		for (auto& object : objects) {
+			object = std::make_shared<Object>();
+		}
+
+		std::map<std::string, std::shared_ptr<Object>> named;
+		Starry::SlotMap<std::shared_ptr<Object>> slots;
+		std::vector<Starry::SlotMap<std::shared_ptr<Object>>::Handle> handles(names.size());
+		for (size_t i = 0; i < objectCount; i++) {
+			named.emplace(names[i], objects[i]);
+			handles[i] = slots.insert(objects[i]);
+		}
+
+		float sink = 0.0f;
+		Result mapIterate = measure(iterations, [&]() {
+			for (auto& entry : named) sink += entry.second->value;
+			return named.size();
+		});
+		Result slotIterate = measure(iterations, [&]() {
+			for (auto& object : slots) sink += object->value;
+			return slots.size();
+		});
+		Result mapLookup = measure(iterations, [&]() {
+			for (size_t i = 0; i < objectCount; i++) sink += named.find(names[i])->second->value;
+			return objectCount;
+		});
+		Result slotLookup = measure(iterations, [&]() {
+			for (size_t i = 0; i < objectCount; i++) sink += (*slots.get(handles[i]))->value;
+			return objectCount;
+		});
+
+		// Removes churnCount objects and adds them back under new names, leaving the storage as it was
+		size_t round = 0;
+		Result mapChurn = measure(iterations, [&]() {
+			size_t first = (round++ % 10) * churnCount;
+			for (size_t i = 0; i < churnCount; i++) named.erase(names[first + i]);
+			for (size_t i = 0; i < churnCount; i++) named.emplace(names[first + i], objects[first + i]);
+			return churnCount;
+		});
+		round = 0;
+		Result slotChurn = measure(iterations, [&]() {
+			size_t first = (round++ % 10) * churnCount;
+			for (size_t i = 0; i < churnCount; i++) slots.remove(handles[first + i]);
+			for (size_t i = 0; i < churnCount; i++) handles[first + i] = slots.insert(objects[first + i]);
+			return churnCount;
+		});
+		bool staleRejected = !slots.contains(Starry::SlotMap<std::shared_ptr<Object>>::Handle(1) << 32);
+
+		auto nsPer = [](const Result& result, size_t count) { return result.bestSeconds * 1e9 / static_cast<double>(count); };
+		std::printf("Object storage: %zu objects, churn %zu (best of %d)%s\n", objectCount, churnCount, iterations, sink > 0.0f ? "" : " ");
+		std::printf("  %-10s %8.2f ns iterate %8.2f ns lookup %8.2f ns spawn + despawn\n", "map", nsPer(mapIterate, objectCount),
+			nsPer(mapLookup, objectCount), nsPer(mapChurn, churnCount));
+		std::printf("  %-10s %8.2f ns iterate %8.2f ns lookup %8.2f ns spawn + despawn, stale handles %s\n", "slot map",
+			nsPer(slotIterate, objectCount), nsPer(slotLookup, objectCount), nsPer(slotChurn, churnCount), staleRejected ? "rejected" : "ACCEPTED");
+		report("object_storage", "map_churn", nsPer(mapChurn, churnCount), "ns/object");
+		report("object_storage", "slot_map_churn", nsPer(slotChurn, churnCount), "ns/object");
+		report("object_storage", "map_lookup", nsPer(mapLookup, objectCount), "ns/object");
+		report("object_storage", "slot_map_lookup", nsPer(slotLookup, objectCount), "ns/object");
+	}
+
+	// Writes and maps back a 50k object snapshot. Open is the map plus validation of every record, read walks the
+	// records the way SceneLoader does before it constructs anything.
+	void benchSceneFile(int iterations)
+	{
+		const uint32_t objectCount = 50000;
+		const uint32_t meshCount = 64;
+		const uint32_t textureCount = 16;
+		std::filesystem::path path = std::filesystem::temp_directory_path() / "starry_bench_scene.sscene";
+
+		std::vector<std::string> names(objectCount);
+		for (uint32_t i = 0; i < objectCount; i++) {
+			names[i] = "Mesh, Object " + std::to_string(i);
+		}
+
+		bool written = true;
+		size_t fileBytes = 0;
+		Result write = measure(iterations, [&]() {
+			Starry::SceneFileWriter writer;
+			writer.reserve(objectCount);
+			for (uint32_t i = 0; i < objectCount; i++) {
+				Starry::SceneObjectRecord record{};
+				record.mesh = writer.addAsset(Starry::SceneAssetKind::MESH, "models/mesh_" + std::to_string(i % meshCount) + ".obj", i % meshCount + 1);
+				record.texture = writer.addAsset(Starry::SceneAssetKind::TEXTURE, "images/texture_" + std::to_string(i % textureCount) + ".png", i % textureCount + 1);
+				// Every fourth object hangs off an earlier one
+				if (i % 4 == 3) record.parent = i - 3;
+				record.translation[0] = static_cast<float>(i % 100);
+				record.translation[2] = static_cast<float>(i / 100);
+				writer.addObject(record, names[i]);
+			}
+			written = written && writer.write(path.string());
+			return static_cast<size_t>(objectCount);
+		});
+		fileBytes = written ? static_cast<size_t>(std::filesystem::file_size(path)) : 0;
+
+		bool opened = true;
+		Result open = measure(iterations, [&]() {
+			Starry::SceneFile file;
+			opened = opened && file.open(path.string());
+			return file.getObjects().size();
+		});
+
+		Starry::SceneFile file;
+		opened = opened && file.open(path.string());
+		float sink = 0.0f;
+		Result read = measure(iterations, [&]() {
+			for (const Starry::SceneObjectRecord& record : file.getObjects()) {
+				glm::vec3 translation(record.translation[0], record.translation[1], record.translation[2]);
+				sink += translation.x + static_cast<float>(file.getName(record).size() + file.getPath(*file.getAsset(record.mesh)).size());
+			}
+			return file.getObjects().size();
+		});
+		file.close();
+		std::filesystem::remove(path);
+
+		std::printf("Scene file: %u objects, %zu KiB (best of %d)%s\n", objectCount, fileBytes / 1024, iterations, sink > 0.0f ? "" : " ");
+		std::printf("  write %8.3f ms  open %8.3f ms  read %8.3f ms%s\n", write.bestSeconds * 1000.0, open.bestSeconds * 1000.0,
+			read.bestSeconds * 1000.0, written && opened ? "" : "  FAILED");
+		report("scene_file", "write", write.bestSeconds * 1000.0, "ms");
+		report("scene_file", "open", open.bestSeconds * 1000.0, "ms");
+		report("scene_file", "read", read.bestSeconds * 1000.0, "ms");
+	}
+
+	// A 240 Hz loop paced by sleep_until alone and by FrameLimiter. Jitter is how far each frame interval lands
+	// from the period, CPU is the share of wall time the loop kept a core busy.
+	void benchFrameLimiter()
+	{
+		const double rate = 240.0;
+		const int frames = 480;
+		const int warmup = 8;
+		const double periodUs = 1e6 / rate;
+
+		struct Pacing {
+			double p50Us = 0.0;
+			double p99Us = 0.0;
+			double maxUs = 0.0;
+			double cpuPercent = 0.0;
+		};
+		auto pace = [&](auto&& wait) {
+			std::vector<double> jitter;
+			jitter.reserve(frames);
+			auto last = Clock::now();
+			auto wallStart = last;
+			std::clock_t cpuStart = std::clock();
+			for (int i = 0; i < frames + warmup; i++) {
+				wait();
+				auto now = Clock::now();
+				if (i >= warmup) jitter.push_back(std::abs(std::chrono::duration<double, std::micro>(now - last).count() - periodUs));
+				last = now;
+			}
+			double cpuSeconds = static_cast<double>(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+			double wallSeconds = std::chrono::duration<double>(Clock::now() - wallStart).count();
+
+			std::sort(jitter.begin(), jitter.end());
+			Pacing pacing;
+			pacing.p50Us = jitter[jitter.size() / 2];
+			pacing.p99Us = jitter[std::min(jitter.size() - 1, jitter.size() * 99 / 100)];
+			pacing.maxUs = jitter.back();
+			pacing.cpuPercent = wallSeconds > 0.0 ? 100.0 * cpuSeconds / wallSeconds : 0.0;
+			return pacing;
+		};
+
+		auto period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / rate));
+		auto next = Clock::now();
+		Pacing sleeping = pace([&]() {
+			next += period;
+			std::this_thread::sleep_until(next);
+		});
+
+		Starry::FrameLimiter limiter;
+		limiter.setTargetRate(rate);
+		Pacing limited = pace([&]() { limiter.wait(); });
+
+		std::printf("Frame limiter: %.0f Hz, %d frames\n", rate, frames);
+		for (auto [name, pacing] : { std::pair<const char*, Pacing>{ "sleep", sleeping }, { "limiter", limited } }) {
+			std::printf("  %-10s jitter p50 %8.1f us, p99 %8.1f us, max %8.1f us, %5.1f%% cpu\n", name, pacing.p50Us, pacing.p99Us,
+				pacing.maxUs, pacing.cpuPercent);
+			report("frame_limiter", std::string(name) + "_p99", pacing.p99Us, "us");
+			report("frame_limiter", std::string(name) + "_cpu", pacing.cpuPercent, "%");
+		}
+		std::printf("  %-10s spin margin %.1f us\n", "", std::chrono::duration<double, std::micro>(limiter.getSpinMargin()).count());
+	}
+
+	// The editor's scene on the CPU rasterizer: one textured model framed by the camera and turning, at 720p.
+	// The scalar coverage path is the reference, the image of every other configuration is checked against it.
+	void benchSoftwareRaster(int iterations, const std::string& label, const Starry::ObjMeshData& mesh)
+	{
+		const uint32_t width = 1280;
+		const uint32_t height = 720;
+		if (mesh.corners.empty()) return;
+
+		std::vector<Starry::RasterVertex> vertices(mesh.corners.size());
+		std::vector<uint32_t> indices(mesh.corners.size());
+		glm::vec3 boundsMin(std::numeric_limits<float>::max());
+		glm::vec3 boundsMax(std::numeric_limits<float>::lowest());
+		for (size_t i = 0; i < vertices.size(); i++) {
+			const Starry::ObjCorner& corner = mesh.corners[i];
+			vertices[i].position = { mesh.positions[3 * corner.position + 0], mesh.positions[3 * corner.position + 1], mesh.positions[3 * corner.position + 2] };
+			if (corner.texCoord >= 0) {
+				vertices[i].texCoord = { mesh.texCoords[2 * corner.texCoord + 0], 1.0f - mesh.texCoords[2 * corner.texCoord + 1] };
+			}
+			indices[i] = static_cast<uint32_t>(i);
+			boundsMin = glm::min(boundsMin, vertices[i].position);
+			boundsMax = glm::max(boundsMax, vertices[i].position);
+		}
+		glm::vec3 center = (boundsMin + boundsMax) * 0.5f;
+		float radius = std::max(glm::length(boundsMax - boundsMin) * 0.5f, 1e-3f);
+
+		Starry::TextureImageData texture;
+		texture.width = texture.height = 256;
+		texture.pixels.resize(static_cast<size_t>(texture.width) * texture.height * 4);
+		for (uint32_t y = 0; y < texture.height; y++) {
+			for (uint32_t x = 0; x < texture.width; x++) {
+				uint8_t* texel = &texture.pixels[(static_cast<size_t>(y) * texture.width + x) * 4];
+				uint8_t checker = ((x / 32 + y / 32) & 1) ? 220 : 60;
+				texel[0] = checker;
+				texel[1] = static_cast<uint8_t>(x);
+				texel[2] = static_cast<uint8_t>(y);
+				texel[3] = 255;
+			}
+		}
+
+		glm::mat4 proj = glm::perspective(glm::radians(60.0f), static_cast<float>(width) / height, 0.01f * radius, 10.0f * radius);
+		proj[1][1] *= -1;
+		glm::mat4 view = glm::lookAt(center + glm::vec3(0.0f, 0.5f, 2.2f) * radius, center, glm::vec3(0.0f, 1.0f, 0.0f));
+
+		struct Config {
+			uint32_t samples;
+			bool simd;
+		};
+		const Config configs[] = { { 1, false }, { 1, true }, { 4, false }, { 4, true }, { 8, true } };
+
+		size_t triangles = indices.size() / 3;
+		std::printf("Software raster: %s, %zu tris at %ux%u, %zu threads (best of %d)\n", label.c_str(), triangles, width, height,
+			Starry::JobSystem::get().threadCount(), iterations);
+
+		Starry::SoftwareRasterizer rasterizer;
+		rasterizer.setClearColor(glm::vec4(0.05f, 0.05f, 0.05f, 1.0f));
+		std::vector<uint8_t> reference;
+		uint32_t referenceSamples = 0;
+		for (const Config& config : configs) {
+			rasterizer.setTarget(width, height, config.samples);
+			rasterizer.setSimd(config.simd);
+
+			auto renderFrame = [&](int frame) {
+				Starry::RasterDraw draw;
+				draw.vertices = vertices.data();
+				draw.vertexCount = vertices.size();
+				draw.indices = indices.data();
+				draw.indexCount = indices.size();
+				glm::mat4 model = glm::rotate(glm::mat4(1.0f), 0.1f * frame, glm::vec3(0.0f, 1.0f, 0.0f));
+				draw.modelViewProjection = proj * view * glm::translate(model, -center);
+				draw.texture = &texture;
+				rasterizer.begin();
+				rasterizer.draw(draw);
+				rasterizer.render();
+			};
+
+			int frame = 0;
+			Result result = measure(iterations, [&]() {
+				renderFrame(frame++);
+				return rasterizer.getStats().shadedPixels;
+			});
+
+			// Same frame on both paths, the wide one has to match the scalar one exactly
+			renderFrame(0);
+			const char* kernel = config.simd ? Starry::SoftwareRasterizer::activeKernel() : "scalar";
+			std::string match;
+			if (!config.simd) {
+				reference = rasterizer.getImage();
+				referenceSamples = config.samples;
+			}
+			else if (referenceSamples == config.samples) {
+				Starry::ImageDifference difference = Starry::SoftwareRasterizer::compare(reference.data(), rasterizer.getImage().data(), width, height, 0);
+				match = difference.differingPixels == 0 ? ", matches scalar" : ", " + std::to_string(difference.differingPixels) + " pixels differ from scalar";
+			}
+
+			double framesPerSecond = result.bestSeconds > 0.0 ? 1.0 / result.bestSeconds : 0.0;
+			double trianglesPerSecond = framesPerSecond * triangles / 1e6;
+			std::string name = label + " " + std::to_string(config.samples) + "x " + kernel;
+			std::printf("  %-24s %10.3f ms %10.2f Mtris/s %8.1f frames/s %10zu pixels shaded%s\n", name.c_str(), result.bestSeconds * 1000.0,
+				trianglesPerSecond, framesPerSecond, result.triangles, match.c_str());
+			report("software_raster", name, trianglesPerSecond, "Mtris/s");
+			report("software_raster", name, framesPerSecond, "frames/s");
+		}
+	}
+}
+
+// Usage: starry_bench [model.obj] [iterations] [--json results.json]
+int main(int argc, char** argv)
+{
+	std::string filePath = BENCH_MODEL_PATH "sphere.obj";
+	int iterations = 10;
+	std::string jsonPath;
+
+	std::vector<std::string> positional;
+	for (int i = 1; i < argc; i++) {
+		if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+			jsonPath = argv[++i];
+		}
+		else {
+			positional.push_back(argv[i]);
+		}
+	}
+	if (positional.size() > 0) filePath = positional[0];
+	if (positional.size() > 1) iterations = std::max(1, std::atoi(positional[1].c_str()));
+
+	Starry::ObjImporter importer;
+	Starry::ObjMeshData mesh;
+	if (!importer.importFile(filePath, mesh)) {
+		std::fprintf(stderr, "Could not import %s: %s\n", filePath.c_str(), importer.getError().c_str());
+		return EXIT_FAILURE;
+	}
+	size_t bytes = importer.getStats().bytes;
+
+	Result native = measure(iterations, [&]() {
+		importer.importFile(filePath, mesh);
+		return mesh.triangleCount();
+	});
+
+	std::printf("OBJ import: %s (%.2f MB, best of %d)\n", filePath.c_str(), bytes / (1024.0 * 1024.0), iterations);
+#ifndef STARRY_HEADLESS
+	Result tinyobjPath = measure(iterations, [&]() {
+		tinyobj::attrib_t attrib;
+		std::vector<tinyobj::shape_t> shapes;
+		std::vector<tinyobj::material_t> materials;
+		std::string warn, err;
+		tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, filePath.c_str());
+
+		size_t triangles = 0;
+		for (const auto& shape : shapes) {
+			triangles += shape.mesh.indices.size() / 3;
+		}
+		return triangles;
+	});
+
+	std::printf("  %-10s %10.3f ms %10.1f MB/s %10zu tris\n", "tinyobj",
+		tinyobjPath.bestSeconds * 1000.0, megabytesPerSecond(bytes, tinyobjPath.bestSeconds), tinyobjPath.triangles);
+	report("obj_import", "tinyobj", megabytesPerSecond(bytes, tinyobjPath.bestSeconds), "MB/s");
+#endif
+	std::printf("  %-10s %10.3f ms %10.1f MB/s %10zu tris (%zu chunks)\n", "starry",
+		native.bestSeconds * 1000.0, megabytesPerSecond(bytes, native.bestSeconds), native.triangles, importer.getStats().chunks);
+	report("obj_import", "starry", megabytesPerSecond(bytes, native.bestSeconds), "MB/s");
+
+	std::vector<BenchVertex> corners(mesh.corners.size());
+	for (size_t i = 0; i < corners.size(); i++) {
+		const Starry::ObjCorner& corner = mesh.corners[i];
+		corners[i].position = { mesh.positions[3 * corner.position + 0], mesh.positions[3 * corner.position + 1], mesh.positions[3 * corner.position + 2] };
+		if (corner.normal >= 0) {
+			corners[i].normal = { mesh.normals[3 * corner.normal + 0], mesh.normals[3 * corner.normal + 1], mesh.normals[3 * corner.normal + 2] };
+		}
+		if (corner.texCoord >= 0) {
+			corners[i].texCoord = { mesh.texCoords[2 * corner.texCoord + 0], 1.0f - mesh.texCoords[2 * corner.texCoord + 1] };
+		}
+		corners[i].color = { 1.0f, 1.0f, 1.0f };
+	}
+
+	Result mapWeld = measure(iterations, [&]() {
+		std::unordered_map<BenchVertex, uint32_t, BenchVertexHash> uniqueVertices{};
+		std::vector<BenchVertex> vertices;
+		std::vector<uint32_t> indices;
+		for (const auto& vertex : corners) {
+			if (uniqueVertices.count(vertex) == 0) {
+				uniqueVertices[vertex] = static_cast<uint32_t>(vertices.size());
+				vertices.push_back(vertex);
+			}
+			indices.push_back(uniqueVertices[vertex]);
+		}
+		return vertices.size();
+	});
+
+	Result welderWeld = measure(iterations, [&]() {
+		BenchWelder welder;
+		welder.reserve(corners.size());
+		std::vector<uint32_t> indices(corners.size());
+		for (size_t i = 0; i < corners.size(); i++) {
+			indices[i] = welder.weld(corners[i]);
+		}
+		return welder.uniqueCount();
+	});
+
+	Result parallelWeld = measure(iterations, [&]() {
+		std::vector<BenchVertex> vertices;
+		std::vector<uint32_t> indices;
+		BenchWelder::weldParallel(corners.data(), corners.size(), vertices, indices);
+		return vertices.size();
+	});
+
+	auto cornerRate = [&](double seconds) { return seconds > 0.0 ? (corners.size() / 1e6) / seconds : 0.0; };
+
+	std::printf("Vertex weld: %zu corners (best of %d)\n", corners.size(), iterations);
+	std::printf("  %-10s %10.3f ms %10.1f Mcorners/s %10zu verts\n", "map",
+		mapWeld.bestSeconds * 1000.0, cornerRate(mapWeld.bestSeconds), mapWeld.triangles);
+	std::printf("  %-10s %10.3f ms %10.1f Mcorners/s %10zu verts\n", "welder",
+		welderWeld.bestSeconds * 1000.0, cornerRate(welderWeld.bestSeconds), welderWeld.triangles);
+	std::printf("  %-10s %10.3f ms %10.1f Mcorners/s %10zu verts\n", "parallel",
+		parallelWeld.bestSeconds * 1000.0, cornerRate(parallelWeld.bestSeconds), parallelWeld.triangles);
+	report("vertex_weld", "map", cornerRate(mapWeld.bestSeconds), "Mcorners/s");
+	report("vertex_weld", "welder", cornerRate(welderWeld.bestSeconds), "Mcorners/s");
+	report("vertex_weld", "parallel", cornerRate(parallelWeld.bestSeconds), "Mcorners/s");
+
+	std::vector<BenchVertex> welded;
+	std::vector<uint32_t> weldedIndices;
+	BenchWelder::weldParallel(corners.data(), corners.size(), welded, weldedIndices);
+	if (welded.empty()) return EXIT_SUCCESS;
+	benchVertexCompression(iterations, welded, weldedIndices);
+
+	Starry::MeshletMesh meshlets;
+	Result meshletBuild = measure(iterations, [&]() {
+		meshlets = Starry::MeshletBuilder::build(weldedIndices, &welded[0].position[0], sizeof(BenchVertex), welded.size());
+		return meshlets.meshlets.size();
+	});
+
+	glm::vec3 boundsMin = welded[0].position;
+	glm::vec3 boundsMax = welded[0].position;
+	for (const auto& vertex : welded) {
+		boundsMin = glm::min(boundsMin, vertex.position);
+		boundsMax = glm::max(boundsMax, vertex.position);
+	}
+	glm::vec3 center = (boundsMin + boundsMax) * 0.5f;
+	float radius = glm::length(boundsMax - boundsMin) * 0.5f;
+
+	// Orbit that swings between a close up, where most clusters leave the frustum, and a full view
+	const int frames = 120;
+	glm::mat4 proj = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.01f * radius, 100.0f * radius);
+	proj[1][1] *= -1;
+
+	Starry::MeshletCullStats total{};
+	std::vector<uint8_t> visibility;
+	std::vector<uint32_t> culledIndices;
+	auto cullStart = Clock::now();
+	for (int frame = 0; frame < frames; frame++) {
+		float angle = glm::two_pi<float>() * frame / frames;
+		float distance = radius * (1.75f + 1.25f * std::cos(angle * 2.0f));
+		glm::vec3 eye = center + glm::vec3(std::cos(angle), 0.35f, std::sin(angle)) * distance;
+		glm::mat4 view = glm::lookAt(eye, center, glm::vec3(0.0f, 1.0f, 0.0f));
+
+		Starry::MeshletCullStats stats = Starry::MeshletCuller::cull(meshlets, glm::mat4(1.0f), proj * view, eye, visibility);
+		Starry::MeshletCuller::emitIndices(meshlets, visibility, culledIndices);
+
+		total.meshlets += stats.meshlets;
+		total.visibleMeshlets += stats.visibleMeshlets;
+		total.frustumCulled += stats.frustumCulled;
+		total.backfaceCulled += stats.backfaceCulled;
+		total.triangles += stats.triangles;
+		total.visibleTriangles += stats.visibleTriangles;
+	}
+	double cullSeconds = std::chrono::duration<double>(Clock::now() - cullStart).count();
+
+	std::printf("Meshlets: %zu clusters, %.1f tris avg, build %.3f ms\n", meshlets.meshlets.size(),
+		meshlets.meshlets.empty() ? 0.0 : static_cast<double>(meshlets.triangleCount()) / meshlets.meshlets.size(), meshletBuild.bestSeconds * 1000.0);
+	std::printf("  %d frame orbit: %.1f%% triangles culled, %.1f%% clusters off screen, %.1f%% back facing, %.3f ms per frame\n", frames,
+		total.culledTriangleRatio() * 100.0, total.meshlets ? 100.0 * total.frustumCulled / total.meshlets : 0.0,
+		total.meshlets ? 100.0 * total.backfaceCulled / total.meshlets : 0.0, cullSeconds * 1000.0 / frames);
+	report("meshlets", "build", meshletBuild.bestSeconds * 1000.0, "ms");
+	report("meshlets", "cull", cullSeconds * 1000.0 / frames, "ms/frame");
+
+	benchSceneCulling(frames);
+	benchTransforms(iterations);
+	benchHierarchy(iterations);
+	benchObjectData(iterations);
+	benchInstancing(iterations, mesh);
+	benchTextureCooking(iterations);
+	benchJobScaling(iterations);
+
+	std::printf("Scene update: generated scenes, %d ticks each\n", frames);
+	for (size_t objectCount : { 1000, 10000, 100000 }) {
+		benchSceneUpdate(frames, objectCount);
+	}
+	benchFrameTimes(iterations);
+	benchObjectStorage(iterations);
+	benchSceneFile(iterations);
+	benchFrameLimiter();
+
+	benchSoftwareRaster(iterations, std::filesystem::path(filePath).filename().string(), mesh);
+	// The editor's model, not every checkout has it
+	std::string radioPath = BENCH_MODEL_PATH "radio.obj";
+	Starry::ObjMeshData radio;
+	if (std::filesystem::exists(radioPath) && importer.importFile(radioPath, radio)) {
+		benchSoftwareRaster(iterations, "radio.obj", radio);
+	}
+	else {
+		std::printf("Software raster: %s not found, skipped\n", radioPath.c_str());
+	}
+
+	if (!jsonPath.empty()) {
+		if (!writeJson(jsonPath, filePath, iterations, frames)) {
+			std::fprintf(stderr, "Could not write %s\n", jsonPath.c_str());
+			return EXIT_FAILURE;
+		}
+		std::printf("Results written to %s\n", jsonPath.c_str());
+	}
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+// Headless stand-in for s_manager's StarryManager.h, only what the CPU side of Starry uses. On the include
+// path of the headless build alone, the full build gets the real header from the submodule.
+
+#include <atomic>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <string>
+
+enum Severity { INFO, INFO_URGANT, WARNING, CRITICAL, FATAL, BANNER };
+
+#define ASSET_NAME(x) const std::string getAssetName() override { return x; }
+
+namespace Manager
+{
+	class ResourceAsk {
+		public:
+			std::string getID() { return id; }
+			void setResource(void* resourcePtr) { resource = resourcePtr; }
+
+		private:
+			std::string id;
+			void* resource = nullptr;
+	};
+
+	// No registry behind it, alerts go to stderr and the worst one is kept for getAlertSeverity
+	class StarryAsset {
+		public:
+			StarryAsset() : uuid(nextUUID.fetch_add(1, std::memory_order_relaxed)) {}
+			virtual ~StarryAsset() = default;
+
+			virtual const std::string getAssetName() = 0;
+			virtual void askCallback(std::shared_ptr<ResourceAsk>& ask) {}
+
+			size_t getUUID() const { return uuid; }
+			int getAlertSeverity() const { return severity.load(std::memory_order_relaxed); }
+
+			void Alert(const std::string& message, int alertSeverity)
+			{
+				if (alertSeverity >= WARNING) std::fprintf(stderr, "[%s] %s\n", getAssetName().c_str(), message.c_str());
+				int worst = severity.load(std::memory_order_relaxed);
+				while (alertSeverity > worst && alertSeverity != BANNER && !severity.compare_exchange_weak(worst, alertSeverity)) {}
+			}
+
+		private:
+			inline static std::atomic<size_t> nextUUID{ 1 };
+			size_t uuid;
+			std::atomic<int> severity{ INFO };
+	};
+
+	// Never created headless, get() stays empty and callers already handle a missing manager
+	class AssetManager {
+		public:
+			static std::weak_ptr<AssetManager> get() { return {}; }
+			bool isFatal() { return false; }
+	};
+}
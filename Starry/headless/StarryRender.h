@@ -0,0 +1,95 @@
+#pragma once
+
+// Headless stand-in for s_renderer's StarryRender.h. Resources only carry what the Null and Software
+// backends read back, there is no device, window or context behind them.
+
+#include "StarryManager.h"
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <functional>
+#include <string>
+#include <vector>
+
+#define DEFAULT_SHADER_PATHS { "", "" }
+
+namespace Render
+{
+	struct Vertex {
+		glm::vec3 position{ 0.0f };
+		glm::vec3 color{ 0.0f };
+		glm::vec3 normal{ 0.0f };
+		glm::vec2 texCoord{ 0.0f };
+
+		bool operator==(const Vertex& other) const
+		{
+			return position == other.position && color == other.color && normal == other.normal && texCoord == other.texCoord;
+		}
+	};
+
+	struct UniformData {
+		glm::mat4 model;
+		glm::mat4 view;
+		glm::mat4 proj;
+
+		UniformData(float modelDiagonal, float viewDiagonal, float projDiagonal) : model(modelDiagonal), view(viewDiagonal), proj(projDiagonal) {}
+	};
+
+	class Buffer : public Manager::StarryAsset {
+		public:
+			void loadData(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices) {}
+			ASSET_NAME("Buffer")
+	};
+
+	class Uniform : public Manager::StarryAsset {
+		public:
+			void setData(UniformData& data) {}
+			ASSET_NAME("Uniform")
+	};
+
+	class TextureImage : public Manager::StarryAsset {
+		public:
+			void storeFilePath(const std::string& filePath) {}
+			ASSET_NAME("Texture Image")
+	};
+
+	class DescriptorSet : public Manager::StarryAsset {
+		public:
+			void addDescriptors(std::vector<size_t> descriptors) {}
+			ASSET_NAME("Descriptor Set")
+	};
+
+	class Canvas : public Manager::StarryAsset {
+		public:
+			virtual void Display() = 0;
+			void PollEvents() {}
+	};
+
+	// Never opened headless, RenderBackendType::NONE and SOFTWARE take a null window
+	class Window : public Manager::StarryAsset {
+		public:
+			explicit Window(const std::string& name) {}
+			ASSET_NAME("Window")
+	};
+
+	struct RenderConfig {
+		enum class MSAAOptions { MSAA_DISABLED, MSAA_2X, MSAA_4X, MSAA_8X };
+
+		RenderConfig(std::string vertexShaderPath, std::string fragmentShaderPath, MSAAOptions msaa, std::array<float, 3> clearColor) {}
+	};
+}
+
+template <>
+struct std::hash<Render::Vertex> {
+	size_t operator()(const Render::Vertex& vertex) const
+	{
+		size_t hash = 0;
+		auto combine = [&](float value) { hash ^= std::hash<float>()(value) + 0x9e3779b9 + (hash << 6) + (hash >> 2); };
+		for (int i = 0; i < 3; i++) combine(vertex.position[i]);
+		for (int i = 0; i < 3; i++) combine(vertex.color[i]);
+		for (int i = 0; i < 3; i++) combine(vertex.normal[i]);
+		for (int i = 0; i < 2; i++) combine(vertex.texCoord[i]);
+		return hash;
+	}
+};
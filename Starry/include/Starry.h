@@ -2,11 +2,21 @@
 
 #include "starry/Scene.h"
 #include "starry/Renderer.h"
+#include "starry/RenderBackend.h"
+#include "starry/NullBackend.h"
+#include "starry/SoftwareBackend.h"
 #include "starry/SceneObject.h"
 #include "starry/MeshObject.h"
+#include "starry/MeshRegistry.h"
+#include "starry/AssetLoader.h"
+#include "starry/AsyncLog.h"
+#include "starry/TextureCooker.h"
+#include "starry/ImageDecoder.h"
 #include "starry/CameraObject.h"
+#include "starry/SceneLoader.h"
 
 #include "starry/Timer.h"
+#include "starry/Profiler.h"
 #include "starry/Interface.h"
 
 #include "starry/ManagedObject.h"
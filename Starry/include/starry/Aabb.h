@@ -0,0 +1,48 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cmath>
+
+namespace Starry
+{
+	struct Aabb {
+		glm::vec3 min{ 0.0f };
+		glm::vec3 max{ 0.0f };
+
+		glm::vec3 center() const { return (min + max) * 0.5f; }
+		glm::vec3 extent() const { return max - min; }
+
+		float surfaceArea() const
+		{
+			glm::vec3 size = max - min;
+			return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+		}
+
+		bool contains(const Aabb& other) const
+		{
+			return min.x <= other.min.x && min.y <= other.min.y && min.z <= other.min.z &&
+				max.x >= other.max.x && max.y >= other.max.y && max.z >= other.max.z;
+		}
+
+		static Aabb merge(const Aabb& a, const Aabb& b) { return { glm::min(a.min, b.min), glm::max(a.max, b.max) }; }
+
+		Aabb expanded(float margin) const { return { min - glm::vec3(margin), max + glm::vec3(margin) }; }
+
+		// Bounds of the transformed box (Arvo 1990), exact for the box corners and cheaper than transforming all 8
+		Aabb transformed(const glm::mat4& matrix) const
+		{
+			glm::vec3 center = glm::vec3(matrix * glm::vec4(this->center(), 1.0f));
+			glm::vec3 half = extent() * 0.5f;
+			glm::vec3 radius(0.0f);
+			for (int axis = 0; axis < 3; axis++) {
+				radius += glm::vec3(
+					std::abs(matrix[axis][0]),
+					std::abs(matrix[axis][1]),
+					std::abs(matrix[axis][2])
+				) * half[axis];
+			}
+			return { center - radius, center + radius };
+		}
+	};
+}
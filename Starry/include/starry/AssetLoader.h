@@ -0,0 +1,50 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Starry
+{
+	// Background threads for asset reads and imports. Kept apart from the JobSystem on purpose, a thread
+	// waiting on a frame's jobs helps run queued ones and must never pick up a whole file import.
+	// Loads still fan their parsing and welding out onto the job system.
+	class AssetLoader {
+		public:
+			static AssetLoader& get();
+
+			explicit AssetLoader(size_t threadCount);
+			~AssetLoader();
+
+			AssetLoader(const AssetLoader&) = delete;
+			AssetLoader& operator=(const AssetLoader&) = delete;
+
+			// Runs load on one of the loader threads. Loads start in submission order, but with more than one
+			// thread they may finish in any order.
+			void submit(std::function<void()> load);
+
+			// Loads queued or running
+			size_t pendingCount() const { return pending.load(std::memory_order_relaxed); }
+			// Blocks until every submitted load has run, for tools that want everything in place
+			void waitIdle();
+
+			// Reads overlap parsing with two threads, more mostly adds disk contention
+			constexpr static size_t DEFAULT_THREADS = 2;
+
+		private:
+			void workerLoop();
+
+			std::vector<std::thread> threads;
+			std::deque<std::function<void()>> queue;
+			std::mutex mutex;
+			std::condition_variable wake;
+			std::condition_variable idle;
+			bool running = true;
+			std::atomic<size_t> pending{ 0 };
+	};
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace Starry
+{
+	enum class LogLevel
+	{
+		INFO,
+		WARNING,
+		CRITICAL
+	};
+
+	// Log lines from threads that must not wait on a console or a disk. post() copies the text into a bounded
+	// ring without taking a lock and returns, a background thread writes the lines out in order, stamped with
+	// the time they were posted. When the writer falls CAPACITY lines behind, new lines are dropped and counted
+	// rather than blocking. Fatal errors still go through Alert, the asset manager has to see those.
+	class AsyncLog {
+		public:
+			static AsyncLog& get();
+
+			AsyncLog();
+			~AsyncLog();
+
+			AsyncLog(const AsyncLog&) = delete;
+			AsyncLog& operator=(const AsyncLog&) = delete;
+
+			// Any thread, never blocks. Text past MESSAGE_BYTES is cut. False when the line was dropped.
+			bool post(LogLevel level, std::string_view text);
+
+			// Lines are copied to the file as well as the console, an empty path stops that
+			bool setLogFile(const std::string& filePath);
+			// Blocks until every line posted before the call is written
+			void flush();
+
+			uint64_t getDroppedCount() const { return dropped.load(std::memory_order_relaxed); }
+
+			constexpr static size_t CAPACITY = 1024; // Power of two
+			constexpr static size_t MESSAGE_BYTES = 232;
+			// Longest the writer sleeps before looking at the ring again, in case a wake up was missed
+			constexpr static std::chrono::milliseconds DRAIN_INTERVAL = std::chrono::milliseconds(50);
+
+		private:
+			// sequence is the ring position the slot is free for, and one past it once a line is written
+			struct alignas(64) Slot {
+				std::atomic<uint64_t> sequence{ 0 };
+				uint64_t postedNanos = 0;
+				LogLevel level = LogLevel::INFO;
+				uint32_t length = 0;
+				char text[MESSAGE_BYTES];
+			};
+
+			void writerLoop();
+			// Writes out everything published so far, writer thread only
+			bool drain();
+			bool hasPending() const;
+			void write(const Slot& slot);
+
+			std::unique_ptr<Slot[]> slots;
+			alignas(64) std::atomic<uint64_t> head{ 0 };    // Next position to post to
+			alignas(64) std::atomic<uint64_t> written{ 0 }; // Lines written out, the writer's tail
+			std::atomic<uint64_t> dropped{ 0 };
+			uint64_t reportedDropped = 0;
+
+			std::chrono::steady_clock::time_point startTime;
+			std::atomic<bool> running{ true };
+			std::mutex wakeMutex;
+			std::condition_variable wakeWriter;
+			std::condition_variable flushed;
+
+			std::mutex fileMutex; // Between setLogFile and the writer, posting never takes it
+			std::FILE* file = nullptr;
+
+			std::thread writer;
+	};
+}
@@ -14,11 +14,20 @@ namespace Starry
 			void Init() override;
 			void Register(Renderer* renderer) override;
 			void Update(Renderer* renderer) override;
+			bool saveRecord(SceneObjectRecord& record, SceneFileWriter& writer) const override;
+			void loadRecord(const SceneObjectRecord& record, const SceneFile& file) override;
 
 			void setClippingPlanes(float nearInput, float farInput) { nearPlane = nearInput; farPlane = farInput; calculateProjectionMatrix(); }
 			void setFOV(float fovInput) { FOV = fovInput; calculateProjectionMatrix(); }
 			void setExtent(std::array<unsigned int, 2> dimensionsInput) { dimensions = dimensionsInput; calculateProjectionMatrix(); }
 
+			float getFOV() const { return FOV; }
+			float getNearPlane() const { return nearPlane; }
+			float getFarPlane() const { return farPlane; }
+			const std::array<unsigned int, 2>& getExtent() const { return dimensions; }
+
+			ViewParameters getViewParameters() const;
+
 		private:
 			void calculateProjectionMatrix();
 
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace Starry
+{
+	// 16 byte vertex. Nothing uploads it yet, Render::Buffer only takes Render::Vertex, starry_bench measures
+	// what it would save.
+	//   position: R16G16B16A16_UNORM, relative to the mesh bounds (w is padding)
+	//   normal:   R16G16_SNORM, octahedral encoded
+	//   texCoord: R16G16_SFLOAT
+	struct CompactVertex {
+		uint16_t position[4];
+		int16_t normal[2];
+		uint16_t texCoord[2];
+	};
+	static_assert(sizeof(CompactVertex) == 16, "CompactVertex must stay tightly packed");
+
+	// Everything a decoder needs to turn a CompactVertex back into the full vertex
+	struct CompactVertexDecode {
+		float positionOffset[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+		float positionScale[4] = { 1.0f, 1.0f, 1.0f, 0.0f };
+		float color[4] = { 1.0f, 1.0f, 1.0f, 1.0f }; // Used when the color stream is dropped
+	};
+
+	struct CompactMesh {
+		std::vector<CompactVertex> vertices;
+		// RGBA8, empty when every vertex had the same color
+		std::vector<uint32_t> colors;
+
+		// Exactly one of these is filled, 16 bit whenever every index fits
+		std::vector<uint16_t> indices16;
+		std::vector<uint32_t> indices32;
+
+		CompactVertexDecode decode{};
+
+		bool hasColorStream() const { return !colors.empty(); }
+		bool hasShortIndices() const { return !indices16.empty() || indices32.empty(); }
+		size_t indexCount() const { return indices16.empty() ? indices32.size() : indices16.size(); }
+
+		size_t vertexBytes() const { return vertices.size() * sizeof(CompactVertex) + colors.size() * sizeof(uint32_t); }
+		size_t indexBytes() const { return indices16.size() * sizeof(uint16_t) + indices32.size() * sizeof(uint32_t); }
+	};
+
+	class VertexCompression {
+		public:
+			// Largest vertex count that still gets 16 bit indices. 0xFFFF is left out so it never reads as a restart index.
+			const static size_t MAX_SHORT_INDEX_VERTICES = 0xFFFF;
+
+			// Quantizes float streams into a CompactMesh. Strides are in bytes, colors may be null.
+			static void encode(CompactMesh& output, size_t vertexCount,
+				const float* positions, size_t positionStride,
+				const float* normals, size_t normalStride,
+				const float* texCoords, size_t texCoordStride,
+				const float* colors, size_t colorStride,
+				const std::vector<uint32_t>& indices);
+
+			template <typename Vertex>
+			static void encode(CompactMesh& output, const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices)
+			{
+				const Vertex* first = vertices.data();
+				encode(output, vertices.size(),
+					vertices.empty() ? nullptr : &first->position[0], sizeof(Vertex),
+					vertices.empty() ? nullptr : &first->normal[0], sizeof(Vertex),
+					vertices.empty() ? nullptr : &first->texCoord[0], sizeof(Vertex),
+					vertices.empty() ? nullptr : &first->color[0], sizeof(Vertex),
+					indices);
+			}
+
+			// CPU side decode
+			static void decodePosition(const CompactMesh& mesh, const CompactVertex& vertex, float position[3]);
+			static void decodeNormal(const CompactVertex& vertex, float normal[3]);
+			static void decodeTexCoord(const CompactVertex& vertex, float texCoord[2]);
+
+			static void encodeOctahedral(const float normal[3], int16_t encoded[2]);
+			static void decodeOctahedral(const int16_t encoded[2], float normal[3]);
+
+			static uint16_t floatToHalf(float value);
+			static float halfToFloat(uint16_t value);
+	};
+}
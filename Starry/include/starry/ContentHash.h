@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+namespace Starry
+{
+	// Fast non-cryptographic 64 bit hash used to key cached assets by source content
+	uint64_t hashBytes(const void* data, size_t size, uint64_t seed = 0);
+
+	// Hashes a file through a memory mapping. Returns false if the file could not be opened.
+	bool hashFile(const std::string& filePath, uint64_t& hash);
+
+	std::string hashToString(uint64_t hash);
+}
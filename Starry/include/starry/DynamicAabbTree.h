@@ -0,0 +1,121 @@
+#pragma once
+
+#include "Aabb.h"
+#include "Frustum.h"
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace Starry
+{
+	// Incrementally maintained bounding volume hierarchy (after Box2D's b2DynamicTree). Leaves store a
+	// fattened box, so an object that moves a little keeps its leaf and only the ones that leave their
+	// fat box are reinserted. Insertion picks the sibling by surface area cost and AVL style rotations
+	// keep the tree balanced.
+	class DynamicAabbTree {
+		public:
+			constexpr static int32_t NULL_NODE = -1;
+
+			DynamicAabbTree() = default;
+			~DynamicAabbTree() = default;
+
+			int32_t createProxy(const Aabb& bounds, void* userData);
+			void destroyProxy(int32_t proxy);
+
+			// Returns true when the proxy had to be reinserted. displacement is how far the object moved since
+			// the last call, the new fat box is stretched along it so steadily moving objects reinsert less often.
+			bool moveProxy(int32_t proxy, const Aabb& bounds, const glm::vec3& displacement = glm::vec3(0.0f));
+
+			void* getUserData(int32_t proxy) const { return nodes[proxy].userData; }
+			const Aabb& getFatBounds(int32_t proxy) const { return nodes[proxy].bounds; }
+
+			size_t proxyCount() const { return proxies; }
+			int32_t getHeight() const { return root == NULL_NODE ? 0 : nodes[root].height; }
+
+			void clear();
+
+			// Calls visit(userData) for every leaf whose fat box touches the frustum
+			template <typename Visit>
+			void queryFrustum(const Frustum& frustum, Visit&& visit) const
+			{
+				if (root == NULL_NODE) return;
+
+				stack.clear();
+				stack.push_back(root);
+				while (!stack.empty()) {
+					int32_t index = stack.back();
+					stack.pop_back();
+					const Node& node = nodes[index];
+
+					Frustum::Containment containment = frustum.classifyAabb(node.bounds.min, node.bounds.max);
+					if (containment == Frustum::Containment::OUTSIDE) continue;
+
+					if (node.isLeaf()) {
+						visit(node.userData);
+					}
+					else if (containment == Frustum::Containment::INSIDE) {
+						visitSubtree(index, visit);
+					}
+					else {
+						stack.push_back(node.child1);
+						stack.push_back(node.child2);
+					}
+				}
+			}
+
+			// Loose boxes grow by this fraction of their largest side on each axis
+			constexpr static float FAT_MARGIN_RATIO = 0.1f;
+			// Frames of motion the fat box is stretched ahead by
+			constexpr static float DISPLACEMENT_MULTIPLIER = 4.0f;
+
+		private:
+			struct Node {
+				Aabb bounds{};
+				void* userData = nullptr;
+				int32_t parent = NULL_NODE; // Doubles as the next free node while on the free list
+				int32_t child1 = NULL_NODE;
+				int32_t child2 = NULL_NODE;
+				int32_t height = -1; // Leaves are 0, free nodes -1
+
+				bool isLeaf() const { return child1 == NULL_NODE; }
+			};
+
+			template <typename Visit>
+			void visitSubtree(int32_t index, Visit& visit) const
+			{
+				// Shares the query stack, everything pushed here is popped before returning
+				size_t base = stack.size();
+				stack.push_back(index);
+				while (stack.size() > base) {
+					const Node& node = nodes[stack.back()];
+					stack.pop_back();
+					if (node.isLeaf()) {
+						visit(node.userData);
+						continue;
+					}
+					stack.push_back(node.child1);
+					stack.push_back(node.child2);
+				}
+			}
+
+			int32_t allocateNode();
+			void freeNode(int32_t index);
+
+			void insertLeaf(int32_t leaf);
+			void removeLeaf(int32_t leaf);
+			void refitAncestors(int32_t index);
+			int32_t balance(int32_t a);
+			int32_t rotateUp(int32_t a, int32_t child, int32_t other);
+
+			static Aabb fatten(const Aabb& bounds);
+
+			std::vector<Node> nodes;
+			int32_t root = NULL_NODE;
+			int32_t freeList = NULL_NODE;
+			size_t proxies = 0;
+
+			// Reused between queries, so a tree must not be queried from two threads at once
+			mutable std::vector<int32_t> stack;
+	};
+}
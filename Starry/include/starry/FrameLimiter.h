@@ -0,0 +1,43 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace Starry
+{
+	// Holds a loop to a target rate without busy waiting through the whole frame. wait() sleeps until shortly
+	// before the next deadline and spins the rest, the spin margin adapts to how late the OS scheduler
+	// actually wakes the thread: it grows right away after an oversleep and shrinks slowly while sleeps land
+	// on time. Deadlines advance by whole periods so the rate does not drift, after a stall of more than a
+	// period the schedule restarts from now instead of running a burst of frames.
+	class FrameLimiter {
+		public:
+			using Clock = std::chrono::steady_clock;
+
+			// Zero or less turns the limit off. Safe to call while another thread waits.
+			void setTargetRate(double framesPerSecond);
+			double getTargetRate() const;
+
+			// Returns at the next frame deadline, right away without a limit
+			void wait();
+			// Next wait schedules from now, for after the loop was idle
+			void reset() { nextFrame = Clock::time_point{}; }
+
+			// How far past the deadline the last wait returned
+			std::chrono::nanoseconds getLastLateness() const { return lastLateness; }
+			std::chrono::nanoseconds getSpinMargin() const { return spinMargin; }
+
+			constexpr static std::chrono::nanoseconds INITIAL_SPIN_MARGIN = std::chrono::microseconds(1000);
+			constexpr static std::chrono::nanoseconds MIN_SPIN_MARGIN = std::chrono::microseconds(100);
+			constexpr static std::chrono::nanoseconds MAX_SPIN_MARGIN = std::chrono::microseconds(4000);
+
+		private:
+			std::atomic<int64_t> periodNanos{ 0 };
+
+			// Owned by the waiting thread
+			Clock::time_point nextFrame{};
+			std::chrono::nanoseconds spinMargin = INITIAL_SPIN_MARGIN;
+			std::chrono::nanoseconds lastLateness{ 0 };
+	};
+}
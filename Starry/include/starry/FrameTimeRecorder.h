@@ -0,0 +1,59 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace Starry
+{
+	// Frame times over the recent window plus the lifetime histogram, all taken from the same frame
+	struct FrameTimeStats {
+		constexpr static size_t HISTOGRAM_BUCKETS = 48;
+
+		size_t frames = 0;          // In the window
+		uint64_t totalFrames = 0;   // Since the last reset
+
+		float fps = 0.0f;           // Over the window
+		float averageMs = 0.0f;
+		float p50Ms = 0.0f;
+		float p95Ms = 0.0f;
+		float p99Ms = 0.0f;
+		float maxMs = 0.0f;
+
+		size_t hitches = 0;         // Window frames longer than HITCH_FACTOR times the window median
+		uint64_t totalHitches = 0;  // Frames longer than HITCH_FACTOR times the running average at the time
+
+		// Four buckets per doubling from 0.25 ms, bucket 0 is everything shorter, the last everything longer
+		std::array<uint32_t, HISTOGRAM_BUCKETS> histogram{};
+		static float bucketUpperMs(size_t bucket);
+	};
+
+	// Ring of recent frame times and a log bucketed histogram. One thread records, any thread can take a
+	// snapshot. Kept apart from Timer so tools without the asset manager can use it.
+	class FrameTimeRecorder {
+		public:
+			void record(uint64_t nanos);
+			void reset();
+
+			// Consistent copy of the statistics, the recording thread never waits on it
+			FrameTimeStats snapshot() const;
+
+			// Frames kept for the windowed numbers, about four seconds at 120 fps
+			constexpr static size_t FRAME_WINDOW = 512;
+			constexpr static float HITCH_FACTOR = 2.0f;
+
+		private:
+			void beginWrite();
+			void endWrite();
+
+			// Sequence lock over the fields below: odd while the recording thread is writing a frame, readers
+			// retry when it moved under them. Everything is atomic so torn reads are only ever discarded.
+			std::atomic<uint64_t> sequence{ 0 };
+			std::array<std::atomic<uint64_t>, FRAME_WINDOW> frameTimes{};
+			std::array<std::atomic<uint32_t>, FrameTimeStats::HISTOGRAM_BUCKETS> histogram{};
+			std::atomic<uint64_t> recordedFrames{ 0 };
+			std::atomic<uint64_t> hitchCount{ 0 };
+			double averageNanos = 0.0; // Recording thread only
+	};
+}
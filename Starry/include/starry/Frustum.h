@@ -0,0 +1,36 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <array>
+
+namespace Starry
+{
+	// Six inward facing planes (xyz normal, w distance) pulled from a view projection matrix.
+	// Works with either depth range, the near plane is taken as z >= -w.
+	class Frustum {
+		public:
+			enum class Containment
+			{
+				OUTSIDE,
+				INTERSECTS,
+				INSIDE
+			};
+
+			Frustum() = default;
+			Frustum(const glm::mat4& viewProjection) { setMatrix(viewProjection); }
+
+			void setMatrix(const glm::mat4& viewProjection);
+
+			bool intersectsSphere(const glm::vec3& center, float radius) const;
+			bool intersectsAabb(const glm::vec3& boundsMin, const glm::vec3& boundsMax) const;
+
+			// Also reports boxes that are completely inside, so tree queries can skip testing their children
+			Containment classifyAabb(const glm::vec3& boundsMin, const glm::vec3& boundsMax) const;
+
+			const std::array<glm::vec4, 6>& getPlanes() const { return planes; }
+
+		private:
+			std::array<glm::vec4, 6> planes{};
+	};
+}
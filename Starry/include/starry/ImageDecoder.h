@@ -0,0 +1,29 @@
+#pragma once
+
+#include "TextureCooker.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Starry
+{
+	// Image files decoded without the renderer's image libraries, so backends without a device still see
+	// their textures. PNG in every bit depth and color type that is not interlaced, and binary PPM, what
+	// SoftwareRasterizer::writeImage produces. Anything else (JPEG, interlaced PNG) is rejected.
+	class ImageDecoder {
+		public:
+			// Picks the format from the signature, fits TextureCooker::Decoder
+			static bool decode(const char* data, size_t size, TextureImageData& image);
+
+			static bool decodePng(const uint8_t* data, size_t size, TextureImageData& image);
+			static bool decodePpm(const uint8_t* data, size_t size, TextureImageData& image);
+
+			// zlib stream (RFC 1950, 1951) appended to output, expectedSize only reserves. The checksum is
+			// not verified.
+			static bool inflate(const uint8_t* data, size_t size, std::vector<uint8_t>& output, size_t expectedSize = 0);
+
+			// Larger images are rejected before anything is allocated
+			constexpr static uint64_t MAX_PIXELS = 1ull << 28;
+	};
+}
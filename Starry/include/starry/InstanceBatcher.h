@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace Starry
+{
+	// Run of consecutive object buffer entries drawn as one instanced draw
+	struct InstanceBatch {
+		uint64_t key = 0;
+		uint32_t firstInstance = 0;
+		uint32_t instanceCount = 0;
+	};
+
+	// Groups items that can share a draw, same geometry and same material, so their object data ends up
+	// next to each other and each group becomes one draw with firstInstance / instanceCount. Key 0 means
+	// the item cannot be shared and always gets a batch of its own.
+	class InstanceBatcher {
+		public:
+			// Linear in count, items keep their relative order within a batch and batches appear in the
+			// order their first item does
+			void build(const uint64_t* keys, size_t count);
+
+			// order[position] is the item drawn at that position of the object buffer
+			const std::vector<uint32_t>& getOrder() const { return order; }
+			const std::vector<InstanceBatch>& getBatches() const { return batches; }
+
+		private:
+			std::unordered_map<uint64_t, uint32_t> batchOfKey;
+			std::vector<uint32_t> itemBatch;
+			std::vector<uint32_t> cursors;
+			std::vector<uint32_t> order;
+			std::vector<InstanceBatch> batches;
+	};
+}
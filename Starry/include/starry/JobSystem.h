@@ -0,0 +1,116 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Starry
+{
+	using Job = std::function<void()>;
+
+	// Counts unfinished jobs, for wait()
+	class JobCounter {
+		public:
+			JobCounter() = default;
+			JobCounter(const JobCounter&) = delete;
+			JobCounter& operator=(const JobCounter&) = delete;
+
+			bool done() const { return pending.load(std::memory_order_acquire) == 0; }
+
+		private:
+			friend class JobSystem;
+
+			std::atomic<size_t> pending{ 0 };
+	};
+
+	// Fixed pool of worker threads, each with its own deque. Owners take their newest job, idle workers
+	// steal the oldest job of another queue. Threads outside the pool share one extra queue.
+	//
+	// wait() runs queued jobs of the counter it waits on until that is done, so the waiting thread is one
+	// of the workers for its own loop and nested parallel loops cannot starve the pool. It never picks up
+	// anyone else's jobs: a render thread waiting on its present batches must not end up parsing a mesh
+	// for the asset loader or running a simulation update.
+	class JobSystem {
+		public:
+			// Shared pool, one worker less than the hardware threads since the waiting thread helps
+			static JobSystem& get();
+
+			explicit JobSystem(size_t workerCount);
+			~JobSystem();
+
+			JobSystem(const JobSystem&) = delete;
+			JobSystem& operator=(const JobSystem&) = delete;
+
+			// counter, when given, is raised now and lowered once the job has run
+			void run(Job job, JobCounter* counter = nullptr);
+
+			void wait(JobCounter& counter);
+
+			// Runs work(begin, end) over batches of [0, size) of at least minBatch items and waits for all of them
+			template <typename Work>
+			void parallelFor(size_t size, size_t minBatch, Work&& work);
+
+			// Workers plus the thread that waits
+			size_t threadCount() const { return workers.size() + 1; }
+
+			// Enough batches for stealing to even out uneven objects, few enough to keep queue traffic low
+			constexpr static size_t BATCHES_PER_THREAD = 4;
+
+		private:
+			struct Task {
+				Job job;
+				JobCounter* counter = nullptr;
+			};
+
+			struct WorkQueue {
+				std::mutex mutex;
+				std::deque<Task> tasks;
+			};
+
+			void workerLoop(size_t queue);
+			void push(Task task);
+			// Any job, or with only set just the jobs counted by it
+			bool runOne(const JobCounter* only = nullptr);
+			static bool take(std::deque<Task>& tasks, const JobCounter* only, bool newest, Task& task);
+			void finish(JobCounter* counter);
+			size_t currentQueue() const;
+
+			std::vector<std::thread> workers;
+			std::vector<std::unique_ptr<WorkQueue>> queues; // [0] is shared by threads outside the pool
+
+			std::atomic<size_t> queuedCount{ 0 };
+			std::atomic<size_t> sleepingCount{ 0 };
+			std::atomic<bool> running{ true };
+			std::mutex sleepMutex;
+			std::condition_variable wake;
+	};
+
+	template <typename Work>
+	void JobSystem::parallelFor(size_t size, size_t minBatch, Work&& work)
+	{
+		if (size == 0) return;
+		minBatch = std::max<size_t>(minBatch, 1);
+
+		size_t batches = std::min(threadCount() * BATCHES_PER_THREAD, (size + minBatch - 1) / minBatch);
+		if (batches <= 1) {
+			work(size_t(0), size);
+			return;
+		}
+
+		auto batch = [&](size_t i) { work((size * i) / batches, (size * (i + 1)) / batches); };
+
+		JobCounter counter;
+		for (size_t i = 1; i < batches; i++) {
+			run([&batch, i]() { batch(i); }, &counter);
+		}
+		batch(0);
+		wait(counter);
+	}
+}
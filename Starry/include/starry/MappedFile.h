@@ -0,0 +1,40 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+
+namespace Starry
+{
+	// Read-only memory mapping of a whole file. Empty files map successfully with a null view.
+	class MappedFile {
+		public:
+			MappedFile() = default;
+			MappedFile(const std::string& filePath) { open(filePath); }
+			~MappedFile();
+
+			MappedFile(const MappedFile&) = delete;
+			MappedFile& operator=(const MappedFile&) = delete;
+			MappedFile(MappedFile&& other) noexcept;
+			MappedFile& operator=(MappedFile&& other) noexcept;
+
+			bool open(const std::string& filePath);
+			void close();
+
+			bool isOpen() const { return opened; }
+
+			const char* data() const { return view; }
+			size_t size() const { return length; }
+
+		private:
+			bool opened = false;
+			const char* view = nullptr;
+			size_t length = 0;
+
+#ifdef _WIN32
+			void* fileHandle = nullptr;
+			void* mappingHandle = nullptr;
+#else
+			int fileDescriptor = -1;
+#endif
+	};
+}
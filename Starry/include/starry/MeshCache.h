@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <span>
+#include <string>
+
+#include "MappedFile.h"
+#include "MeshOptimizer.h"
+
+namespace Starry
+{
+	// On-disk layout of a cooked mesh (.smesh). Everything is little endian and written exactly as it
+	// sits in memory, so a mapped file is read without any parsing. It is not zero copy: Render::Buffer
+	// only takes vectors, so MeshObject copies the payload out of the mapping once.
+	//
+	//   MeshCacheHeader
+	//   vertex array (vertexCount * vertexStride bytes) at vertexOffset
+	//   uint32_t index array (indexCount) at indexOffset
+	struct MeshCacheHeader {
+		char magic[4] = { 'S', 'M', 'S', 'H' };
+		uint32_t version = 0;
+		uint32_t vertexStride = 0;
+		uint32_t flags = 0;
+
+		uint64_t vertexCount = 0;
+		uint64_t indexCount = 0;
+		uint64_t vertexOffset = 0;
+		uint64_t indexOffset = 0;
+
+		float boundsMin[3] = { 0.0f, 0.0f, 0.0f };
+		float boundsMax[3] = { 0.0f, 0.0f, 0.0f };
+
+		uint64_t sourceHash = 0;
+		uint64_t sourceSize = 0;
+
+		// MeshOptimizer::hashOptions of what the mesh was optimized with, 0 when it was not
+		uint64_t optionsHash = 0;
+		// The optimization report of the import that wrote the file, handed back on a hit
+		float acmrBefore = 0.0f;
+		float atvrBefore = 0.0f;
+		float acmrAfter = 0.0f;
+		float atvrAfter = 0.0f;
+		uint64_t clusters = 0;
+		uint32_t overdrawApplied = 0;
+		uint32_t reserved = 0;
+	};
+
+	struct MeshCacheData {
+		const void* vertices = nullptr;
+		uint32_t vertexStride = 0;
+		size_t vertexCount = 0;
+
+		const uint32_t* indices = nullptr;
+		size_t indexCount = 0;
+
+		uint32_t flags = 0;
+
+		float boundsMin[3] = { 0.0f, 0.0f, 0.0f };
+		float boundsMax[3] = { 0.0f, 0.0f, 0.0f };
+
+		uint64_t sourceHash = 0;
+		uint64_t optionsHash = 0;
+		MeshOptimizeReport optimizeReport{};
+	};
+
+	class MeshCache {
+		public:
+			// Bump whenever MeshCacheHeader or the payload layout changes
+			const static uint32_t VERSION = 2;
+			const static size_t PAYLOAD_ALIGNMENT = 16;
+
+			// Header flags, a cache is only reused when they match what the loader would produce
+			const static uint32_t FLAG_OPTIMIZED = 1 << 0;
+
+			// Writes through a temporary file and renames it into place, so a reader never maps a partial file
+			static bool write(const std::string& filePath, const MeshCacheData& data, uint64_t sourceSize);
+
+			// Default location for a source file's cache. An empty cache directory means next to the source.
+			static std::string cachePathFor(const std::string& sourcePath, const std::string& cacheDirectory, uint64_t sourceHash);
+
+			MeshCache() = default;
+			~MeshCache() = default;
+
+			// Maps the file and validates it against the expected source, vertex layout and optimize options.
+			// Only the welded and optimized mesh is cached, LODs and meshlets are built from it
+			// on every load. The returned data points into the mapping and stays valid until close() or destruction.
+			bool open(const std::string& filePath, uint64_t expectedSourceHash, uint64_t expectedSourceSize, uint32_t expectedStride,
+				uint32_t expectedFlags = 0, uint64_t expectedOptionsHash = 0);
+			void close() { file.close(); data = {}; }
+
+			const MeshCacheData& getData() const { return data; }
+
+			template <typename Vertex>
+			std::span<const Vertex> vertices() const
+			{
+				return { static_cast<const Vertex*>(data.vertices), data.vertexCount };
+			}
+
+			std::span<const uint32_t> indices() const { return { data.indices, data.indexCount }; }
+
+		private:
+			MappedFile file;
+			MeshCacheData data{};
+	};
+}
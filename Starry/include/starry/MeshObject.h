@@ -1,11 +1,27 @@
 #pragma once
 
 #include "SceneObject.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+#include "Meshlet.h"
+#include "MeshRegistry.h"
+
+#include <future>
+#include <mutex>
 
 namespace Starry
 {
+	class MappedFile;
+
 	class MeshObject : public SceneObject {
 	public:
+		enum class Optimization
+		{
+			GLOBAL,
+			ENABLED,
+			DISABLED
+		};
+
 		MeshObject(std::string nameInput = "Default");
 		~MeshObject();
 
@@ -13,6 +29,16 @@ namespace Starry
 		void Register(Renderer* renderer) override;
 		void Update(Renderer* renderer) override;
 		void Destroy() override;
+		void uploadUniform(Render::UniformData& data) override;
+		void updateDetail(const ViewParameters& view, const glm::mat4& model, const glm::mat4& modelViewProjection) override;
+		void flushDetail() override;
+		bool getLocalBounds(Aabb& bounds) const override;
+		void hide() override;
+		uint64_t getBatchKey() const override;
+		bool getDrawResources(Render::Buffer*& bufferOutput, Render::DescriptorSet*& descriptorSetOutput) const override;
+		bool hasPendingLoad() const override { return pendingMesh != nullptr; }
+		bool commitLoad() override;
+		void commitLoadedBounds() override;
 
 		bool isEmptyMesh() const { return isEmpty; }
 
@@ -21,14 +47,149 @@ namespace Starry
 
 		void loadTextureFromFile(const std::string filePath);
 		void loadMeshFromFile(const std::string filePath);
+		// Reads, imports and builds the mesh on the AssetLoader threads. Until then the object draws a
+		// placeholder cube, the mesh replaces it at the next frame boundary once built. The future turns
+		// true when the mesh is built, false when loading failed and the placeholder stays.
+		// Start loads before the object goes into a dispatched scene, the same settings rules as
+		// loadMeshFromFile apply.
+		// A known expectedContentHash, as kept by scene snapshots, lets objects share a mesh already built
+		// from that content without opening the file again.
+		std::shared_future<bool> loadMeshAsync(const std::string filePath, uint64_t expectedContentHash = 0);
+
+		// Sources last loaded, empty for meshes built from vertex data. The hash is 0 until the mesh is read.
+		const std::string& getMeshPath() const { return meshPath; }
+		const std::string& getTexturePath() const { return texturePath; }
+		uint64_t getMeshContentHash() const { return meshContentHash.load(std::memory_order_relaxed); }
+
+		bool saveRecord(SceneObjectRecord& record, SceneFileWriter& writer) const override;
+		void loadRecord(const SceneObjectRecord& record, const SceneFile& file) override;
+
+		const glm::vec3& getBoundsMin() const { return localBounds.min; }
+		const glm::vec3& getBoundsMax() const { return localBounds.max; }
+
+		// Loaded geometry, shared through MeshRegistry with every object that loaded the same content
+		// with the same build settings. Null until something is loaded.
+		const std::shared_ptr<MeshGeometry>& getGeometry() const { return geometry; }
+
+		// Imported meshes are cooked to a .smesh file. Later loads map it and skip parsing and welding, then
+		// copy the payload once into the geometry. An empty directory writes the cache next to the source file.
+		static void setMeshCaching(bool enabled) { meshCaching = enabled; }
+		static void setMeshCacheDirectory(const std::string& directory) { meshCacheDirectory = directory; }
+
+		// Vertex cache, overdraw and vertex fetch reordering before upload. GLOBAL follows setGlobalMeshOptimization.
+		void setMeshOptimization(Optimization mode, const MeshOptimizeOptions& options = {}) { optimization = mode; optimizeOptions = options; }
+		static void setGlobalMeshOptimization(bool enabled, const MeshOptimizeOptions& options = {}) { globalOptimization = enabled; globalOptimizeOptions = options; }
+
+		const MeshOptimizeReport& getOptimizeReport() const { return meshGeometry().optimizeReport; }
+
+		// Fractions of the full triangle count to build extra detail levels for, e.g. { 0.5f, 0.25f, 0.1f }.
+		// Set before loading, an empty list disables LODs.
+		void setLodLevels(const std::vector<float>& triangleRatios) { lodRatios = triangleRatios; }
+		const std::vector<MeshLod>& getLods() const { return meshGeometry().lods; }
+		size_t getActiveLod() const { return activeLod; }
+
+		// Coarser levels are picked while their projected error stays under this many pixels
+		static void setLodPixelError(float pixels) { lodPixelError = pixels; }
+
+		// Splits every detail level into meshlets at load time and uploads only the clusters that survive
+		// frustum and normal cone culling. Set before loading.
+		void setMeshletCulling(bool enabled) { meshletCulling = enabled; }
+		const std::vector<MeshletMesh>& getMeshlets() const { return meshGeometry().meshletLevels; }
+		const MeshletCullStats& getMeshletCullStats() const { return meshletStats; }
 
 	private:
+		// Result of a background load, shared between the object and the loader thread
+		struct PendingMesh {
+			std::mutex mutex; // Held for the whole load, so cancelling waits out a load that already started
+			bool cancelled = false;
+			std::atomic<bool> finished{ false };
+			std::shared_ptr<MeshGeometry> geometry; // Null when loading failed
+			std::promise<bool> loaded;
+		};
+
+		// Everything building geometry reads. Taken by value when a load starts, so loader threads never
+		// read setters the owning thread may be calling.
+		struct BuildSettings {
+			bool optimize = false;
+			MeshOptimizeOptions optimizeOptions{};
+			std::vector<float> lodRatios;
+			bool meshletCulling = false;
+			bool meshCaching = true;
+			std::string meshCacheDirectory;
+		};
+
+		const MeshGeometry& meshGeometry() const { return geometry != nullptr ? *geometry : emptyGeometry; }
+		static std::shared_ptr<MeshGeometry> placeholderGeometry();
+
+		BuildSettings buildSettings() const;
+		// Cancels the load in flight, waiting it out if it already started
+		void cancelPendingMesh();
+
+		// Registry key of content built with these settings
+		static uint64_t geometryKey(const BuildSettings& settings, uint64_t contentHash);
+		std::shared_ptr<MeshGeometry> buildFromFile(const std::string& filePath, uint64_t expectedContentHash, const BuildSettings& settings);
+		bool importGeometry(const std::string& filePath, const MappedFile& source, uint64_t sourceHash, const BuildSettings& settings, MeshGeometry& mesh);
+		void finishGeometry(MeshGeometry& mesh, const BuildSettings& settings);
+		// attachGeometry is bindGeometry for the render side plus the bounds for the simulation side
+		void attachGeometry(std::shared_ptr<MeshGeometry> mesh, bool privateBuffer = false);
+		void bindGeometry(std::shared_ptr<MeshGeometry> mesh, bool privateBuffer);
+		static void computeBounds(MeshGeometry& mesh);
+
+		bool shouldOptimize() const;
+		void optimizeVertexData(MeshGeometry& mesh, const BuildSettings& settings);
+		void generateLods(MeshGeometry& mesh, const BuildSettings& settings);
+		void selectLod(const ViewParameters& view, const glm::mat4& model);
+		void switchLod(size_t level);
+		void buildMeshlets(MeshGeometry& mesh, const BuildSettings& settings);
+		void cullMeshlets(const ViewParameters& view, const glm::mat4& model, const glm::mat4& modelViewProjection);
+		// Load reports come from loader threads, so they go through AsyncLog instead of Alert
+		void logInfo(const std::string& text);
+
 		bool isEmpty = true;
+		bool registered = false;
+
+		std::string meshPath;
+		std::string texturePath;
+		std::atomic<uint64_t> meshContentHash{ 0 }; // Written by loader threads
+
+		// Render side
+		std::shared_ptr<MeshGeometry> geometry;
+		std::shared_ptr<PendingMesh> pendingMesh;
+		inline static const MeshGeometry emptyGeometry{};
+
+		// Simulation side, handed over through commitLoadedBounds after a background load
+		bool hasBounds = false;
+		Aabb localBounds{};
+		Aabb loadedBounds{};
+		bool boundsLoaded = false;
+
+		inline static bool meshCaching = true;
+		inline static std::string meshCacheDirectory = "";
+
+		Optimization optimization = Optimization::GLOBAL;
+		MeshOptimizeOptions optimizeOptions{};
+
+		std::vector<float> lodRatios;
+		size_t activeLod = 0;
+
+		inline static float lodPixelError = 1.0f;
+
+		bool meshletCulling = false;
+		std::vector<uint8_t> meshletVisibility;
+		std::vector<uint8_t> nextVisibility;
+		std::vector<uint32_t> culledIndices;
+		size_t culledLevel = SIZE_MAX;
+		std::vector<uint32_t>* pendingIndices = nullptr; // Uploaded by flushDetail
+		MeshletCullStats meshletStats{};
 
-		std::vector<Render::Vertex> vertices;
-		std::vector<uint32_t> indices;
+		inline static bool globalOptimization = false;
+		inline static MeshOptimizeOptions globalOptimizeOptions{};
 
+		// Shared with the geometry when the full mesh is drawn as is, private when this object streams its
+		// own indices or has to be refilled after registering
 		std::shared_ptr<Render::Buffer> buffer;
+		bool ownsBuffer = true;
+		uint64_t texturePathHash = 0;
 
 		std::shared_ptr<Render::Uniform> uniform;
 		std::shared_ptr<Render::TextureImage> textureImage;
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace Starry
+{
+	struct VertexCacheStats {
+		float acmr = 0.0f; // Average cache miss ratio, transformed vertices per triangle. 0.5 is the ideal for large grids, 3 the worst.
+		float atvr = 0.0f; // Average transform to vertex ratio. 1 means every vertex is transformed exactly once.
+	};
+
+	struct MeshOptimizeOptions {
+		bool vertexCache = true;
+		bool overdraw = true;
+		bool vertexFetch = true;
+
+		// FIFO size used for both the Tipsify pass and the reported statistics
+		uint32_t cacheSize = 16;
+		// Cluster reordering is kept only if ACMR stays under this factor of the cache optimized ACMR
+		float overdrawThreshold = 1.05f;
+	};
+
+	struct MeshOptimizeReport {
+		VertexCacheStats before{};
+		VertexCacheStats after{};
+		size_t clusters = 0;
+		bool overdrawApplied = false;
+	};
+
+	// Index buffer reordering stages that run before upload. All of them work on triangle lists.
+	class MeshOptimizer {
+		public:
+			// Every option that changes the output, for keying cached results
+			static uint64_t hashOptions(const MeshOptimizeOptions& options);
+
+			// Simulates a FIFO post-transform cache of cacheSize entries
+			static VertexCacheStats analyzeVertexCache(const std::vector<uint32_t>& indices, size_t vertexCount, uint32_t cacheSize = 16);
+
+			// Tipsify (Sander, Nehab, Barczak 2007). Writes the start triangle of every cluster, meaning every
+			// point where the walk hit a dead end, to clusterStarts when it is not null.
+			static void optimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexCount, uint32_t cacheSize = 16,
+				std::vector<uint32_t>* clusterStarts = nullptr);
+
+			// Orders clusters so outward facing ones come first, which approximates front to back from any view.
+			// positions points at the first position, positionStride is the byte distance between vertices.
+			static void optimizeOverdraw(std::vector<uint32_t>& indices, const std::vector<uint32_t>& clusterStarts,
+				const float* positions, size_t positionStride, size_t vertexCount);
+
+			// Builds a remap that numbers vertices by first use in the index buffer and rewrites the indices with it.
+			// Unreferenced vertices map to INVALID_INDEX. Returns the number of vertices that remain.
+			static size_t optimizeVertexFetch(std::vector<uint32_t>& indices, size_t vertexCount, std::vector<uint32_t>& remap);
+
+			template <typename Vertex>
+			static void applyRemap(std::vector<Vertex>& vertices, const std::vector<uint32_t>& remap, size_t remainingCount)
+			{
+				std::vector<Vertex> remapped(remainingCount);
+				for (size_t i = 0; i < vertices.size(); i++) {
+					if (remap[i] != INVALID_INDEX) remapped[remap[i]] = vertices[i];
+				}
+				vertices = std::move(remapped);
+			}
+
+			// Runs the enabled stages in order. Overdraw ordering needs the Tipsify clusters, so it runs the cache
+			// pass even when that stage is off. positionOffset is offsetof(Vertex, position), three floats.
+			template <typename Vertex>
+			static MeshOptimizeReport optimize(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices,
+				const MeshOptimizeOptions& options, size_t positionOffset)
+			{
+				MeshOptimizeReport report{};
+				report.before = analyzeVertexCache(indices, vertices.size(), options.cacheSize);
+
+				if (!vertices.empty() && indices.size() >= 3) {
+					std::vector<uint32_t> clusterStarts;
+					if (options.vertexCache || options.overdraw) {
+						optimizeVertexCache(indices, vertices.size(), options.cacheSize, &clusterStarts);
+						report.clusters = clusterStarts.size();
+					}
+
+					if (options.overdraw) {
+						std::vector<uint32_t> cacheOrder = indices;
+						float cacheAcmr = analyzeVertexCache(indices, vertices.size(), options.cacheSize).acmr;
+
+						const float* positions = reinterpret_cast<const float*>(reinterpret_cast<const char*>(vertices.data()) + positionOffset);
+						optimizeOverdraw(indices, clusterStarts, positions, sizeof(Vertex), vertices.size());
+
+						if (analyzeVertexCache(indices, vertices.size(), options.cacheSize).acmr > cacheAcmr * options.overdrawThreshold) {
+							indices = std::move(cacheOrder);
+						}
+						else {
+							report.overdrawApplied = true;
+						}
+					}
+
+					if (options.vertexFetch) {
+						std::vector<uint32_t> remap;
+						size_t remaining = optimizeVertexFetch(indices, vertices.size(), remap);
+						applyRemap(vertices, remap, remaining);
+					}
+				}
+
+				report.after = analyzeVertexCache(indices, vertices.size(), options.cacheSize);
+				return report;
+			}
+
+			constexpr static uint32_t INVALID_INDEX = ~0u;
+	};
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <StarryRender.h>
+
+#include "Meshlet.h"
+#include "MeshOptimizer.h"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace Starry
+{
+	struct MeshLod {
+		std::vector<uint32_t> indices;
+		float error = 0.0f; // Object space deviation from the full mesh
+	};
+
+	// Everything built from one mesh source with one set of build settings. Shared by every object that
+	// loads the same content the same way and never changed once built.
+	struct MeshGeometry {
+		uint64_t key = 0;
+
+		std::vector<Render::Vertex> vertices;
+		std::vector<uint32_t> indices;
+		glm::vec3 boundsMin{ 0.0f };
+		glm::vec3 boundsMax{ 0.0f };
+
+		MeshOptimizeReport optimizeReport{};
+		std::vector<MeshLod> lods; // lods[0] is the full mesh
+		std::vector<MeshletMesh> meshletLevels; // One per entry in lods, or just the full mesh
+
+		// Full mesh on the GPU, for objects that draw it as is. Null when every user streams its own indices.
+		std::shared_ptr<Render::Buffer> buffer;
+
+		size_t memoryBytes() const;
+	};
+
+	struct MeshRegistryStats {
+		size_t meshes = 0;     // Unique geometries alive
+		size_t references = 0; // Objects holding them
+		size_t requests = 0;
+		size_t builds = 0;     // Requests that had to import or build, the rest were shared
+
+		size_t bytes = 0;         // CPU memory of the unique geometries
+		size_t unsharedBytes = 0; // What it would be with a copy per reference
+	};
+
+	// Content addressed store of mesh geometry. Keys come from hashing the source content together with
+	// the build settings, so loading the same file twice parses it once.
+	class MeshRegistry {
+		public:
+			static MeshRegistry& get();
+
+			// Geometry stored under key, built by build() on the first request. Concurrent requests for a key
+			// that is still building wait for that build instead of starting another. Null when build fails.
+			std::shared_ptr<MeshGeometry> acquire(uint64_t key, const std::function<bool(MeshGeometry&)>& build);
+
+			MeshRegistryStats getStats() const;
+
+		private:
+			struct Entry {
+				std::weak_ptr<MeshGeometry> geometry;
+				std::shared_ptr<std::mutex> building = std::make_shared<std::mutex>();
+			};
+
+			mutable std::mutex mutex;
+			std::unordered_map<uint64_t, Entry> entries;
+			size_t requests = 0;
+			size_t builds = 0;
+	};
+}
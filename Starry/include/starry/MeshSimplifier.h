@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace Starry
+{
+	struct SimplifyInput {
+		const std::vector<uint32_t>* indices = nullptr;
+		size_t vertexCount = 0;
+
+		const float* positions = nullptr; // xyz, positionStride bytes apart
+		size_t positionStride = 0;
+
+		// Optional per vertex attributes (normals, uvs, ...). When a collapse moves a corner onto a position that
+		// has several vertices, the one with the closest attributes is picked so seams stay intact.
+		const float* attributes = nullptr;
+		size_t attributeStride = 0;
+		size_t attributeCount = 0;
+	};
+
+	struct SimplifyResult {
+		std::vector<uint32_t> indices;
+		float error = 0.0f; // Largest geometric deviation of any collapse, in object space units
+	};
+
+	// Quadric error metric edge collapse (Garland, Heckbert 1997). Vertices only ever move onto existing
+	// vertices, so every level shares the source vertex buffer and only the index buffer changes.
+	class MeshSimplifier {
+		public:
+			// Collapses until the triangle count reaches targetIndexCount / 3 or the next collapse would exceed maxError
+			static SimplifyResult simplify(const SimplifyInput& input, size_t targetIndexCount, float maxError);
+	};
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace Starry
+{
+	struct Meshlet {
+		uint32_t vertexOffset = 0;   // Into MeshletMesh::vertices
+		uint32_t triangleOffset = 0; // Into MeshletMesh::triangles, 3 entries per triangle
+		uint32_t vertexCount = 0;
+		uint32_t triangleCount = 0;
+
+		// Bounding sphere in object space
+		glm::vec3 center{ 0.0f };
+		float radius = 0.0f;
+
+		// Every triangle faces away from a camera at position p when
+		// dot(center - p, coneAxis) >= coneCutoff * length(center - p) + radius.
+		// A zero axis with a cutoff of 1 never passes, which is used when the normals spread too far.
+		glm::vec3 coneAxis{ 0.0f };
+		float coneCutoff = 1.0f;
+	};
+
+	struct MeshletMesh {
+		std::vector<Meshlet> meshlets;
+		std::vector<uint32_t> vertices; // Indices into the source vertex buffer
+		std::vector<uint8_t> triangles; // Local indices into the meshlet's slice of vertices
+
+		size_t triangleCount() const { return triangles.size() / 3; }
+	};
+
+	struct MeshletCullStats {
+		size_t meshlets = 0;
+		size_t visibleMeshlets = 0;
+		size_t frustumCulled = 0;
+		size_t backfaceCulled = 0;
+
+		size_t triangles = 0;
+		size_t visibleTriangles = 0;
+
+		float culledTriangleRatio() const { return triangles == 0 ? 0.0f : 1.0f - static_cast<float>(visibleTriangles) / triangles; }
+	};
+
+	// Splits a triangle list into clusters of bounded size, each with a bounding sphere and normal cone.
+	// Triangles are taken in index buffer order, so run the vertex cache optimizer first for tight clusters.
+	class MeshletBuilder {
+		public:
+			static MeshletMesh build(const std::vector<uint32_t>& indices, const float* positions, size_t positionStride,
+				size_t vertexCount, size_t maxVertices = MAX_VERTICES, size_t maxTriangles = MAX_TRIANGLES);
+
+			// Common mesh shader limits, also fits the uint8 local indices
+			constexpr static size_t MAX_VERTICES = 64;
+			constexpr static size_t MAX_TRIANGLES = 124;
+	};
+
+	// CPU cluster culling against the view frustum and the normal cones. The cone test assumes the model
+	// matrix has no non uniform scale.
+	class MeshletCuller {
+		public:
+			// visibility gets one entry per meshlet, 1 when it survives
+			static MeshletCullStats cull(const MeshletMesh& mesh, const glm::mat4& model, const glm::mat4& modelViewProjection,
+				const glm::vec3& cameraPosition, std::vector<uint8_t>& visibility);
+
+			// Writes the source index list of every visible meshlet, in meshlet order
+			static void emitIndices(const MeshletMesh& mesh, const std::vector<uint8_t>& visibility, std::vector<uint32_t>& indices);
+	};
+}
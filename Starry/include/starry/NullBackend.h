@@ -0,0 +1,98 @@
+#pragma once
+
+#include "RenderBackend.h"
+
+#include <mutex>
+#include <unordered_map>
+
+namespace Starry
+{
+	enum class RenderCommandType : uint8_t
+	{
+		LOAD_BUFFER,
+		WRITE_UNIFORM,
+		LOAD_TEXTURE,
+		WRITE_OBJECTS,
+		DRAW
+	};
+
+	struct RenderCommand {
+		RenderCommandType type = RenderCommandType::DRAW;
+		bool redundant = false; // The resource already held exactly this data
+		uint32_t count = 0;     // Indices for loads and draws, bytes for uniforms and object data
+		uint64_t resource = 0;  // Asset UUID of the buffer, uniform or texture
+		uint64_t hash = 0;      // Of the data written
+		uint32_t instances = 1; // Of a draw
+	};
+
+	struct NullFrameStats {
+		uint64_t frames = 0;
+		size_t draws = 0;
+		size_t drawnIndices = 0; // Over every instance
+		size_t drawnInstances = 0;
+		size_t bufferLoads = 0;
+		size_t redundantBufferLoads = 0;
+		size_t uniformWrites = 0;
+		size_t redundantUniformWrites = 0;
+		size_t textureLoads = 0;
+		size_t objectWrites = 0;
+		size_t redundantObjectWrites = 0;
+		size_t uploadBytes = 0;
+	};
+
+	// Stands in for the Vulkan context on machines without a GPU or display. Nothing is uploaded or drawn;
+	// every load, uniform write and draw is recorded as a small command instead, and a write that repeats
+	// what the resource already holds is marked redundant. Loaded buffers are drawn with their uniform until
+	// object data is submitted, from then on only the submitted draws are. Draw never waits on a swapchain, so the render
+	// loop runs uncapped and frame times are pure CPU cost. The UI canvas is accepted but never drawn.
+	class NullBackend : public RenderBackend {
+		public:
+			explicit NullBackend(std::array<unsigned int, 2> extent);
+			~NullBackend() = default;
+
+			RenderBackendType getType() const override { return RenderBackendType::NONE; }
+
+			void Load(std::shared_ptr<Render::Canvas>& canvas) override {}
+			void Load(std::shared_ptr<Render::Buffer>& buffer) override;
+			void Load(std::shared_ptr<Render::DescriptorSet>& descriptorSet) override {}
+			void Ready() override {}
+			void Draw() override;
+			void WaitIdle() override {}
+			std::array<unsigned int, 2> getExtent() override { return extent; }
+			bool getErrorState() override { return false; }
+			bool isFatal() override { return false; }
+
+			void loadBufferData(Render::Buffer& buffer, std::vector<Render::Vertex>& vertices, std::vector<uint32_t>& indices) override;
+			void writeUniform(Render::Uniform& uniform, Render::UniformData& data) override;
+			void storeTexture(Render::TextureImage& texture, const std::string& filePath) override;
+			bool drawsObjectBuffer() const override { return true; }
+			void submitObjects(const ObjectData* objects, size_t count, const std::vector<ObjectDraw>& draws) override;
+
+			// Commands of the last finished frame. Writes from other threads land in whichever frame is open.
+			std::vector<RenderCommand> getLastFrame() const;
+			NullFrameStats getLastFrameStats() const;
+			// Summed over every frame so far, frames is the number drawn
+			NullFrameStats getTotals() const;
+
+		private:
+			void record(const RenderCommand& command, size_t bytes);
+
+			std::array<unsigned int, 2> extent;
+
+			mutable std::mutex mutex;
+			std::vector<RenderCommand> frameCommands;
+			std::vector<RenderCommand> lastCommands;
+			NullFrameStats frameStats{};
+			NullFrameStats lastStats{};
+			NullFrameStats totals{};
+
+			// Like the real context, every loaded buffer is drawn every frame
+			std::vector<std::shared_ptr<Render::Buffer>> drawBuffers;
+			std::unordered_map<const void*, uint64_t> contents;  // Last hash written to each resource
+			std::unordered_map<const void*, uint32_t> indexCounts;
+
+			bool objectsSubmitted = false;
+			uint64_t objectHash = 0;
+			std::vector<ObjectDraw> objectDraws;
+	};
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace Starry
+{
+	// One triangle corner, 0-based into the ObjMeshData attribute arrays. -1 when the face omits the attribute.
+	struct ObjCorner {
+		int32_t position = -1;
+		int32_t texCoord = -1;
+		int32_t normal = -1;
+	};
+
+	struct ObjMeshData {
+		std::vector<float> positions; // xyz
+		std::vector<float> texCoords; // uv, as written in the file
+		std::vector<float> normals;   // xyz
+		std::vector<ObjCorner> corners; // Triangulated, 3 per triangle, in file order
+
+		size_t triangleCount() const { return corners.size() / 3; }
+	};
+
+	// Native OBJ reader for v/vt/vn/f records. The file is memory mapped, split on line
+	// boundaries and each chunk is parsed on its own thread before being stitched together.
+	// Polygons are triangulated the same way tinyobj does (shortest diagonal for quads, fan otherwise).
+	class ObjImporter {
+		public:
+			struct Stats {
+				size_t bytes = 0;
+				size_t chunks = 0;
+				double mapSeconds = 0.0;
+				double parseSeconds = 0.0;
+				double mergeSeconds = 0.0;
+
+				double totalSeconds() const { return mapSeconds + parseSeconds + mergeSeconds; }
+				double megabytesPerSecond() const {
+					double seconds = totalSeconds();
+					if (seconds <= 0.0) return 0.0;
+					return (static_cast<double>(bytes) / (1024.0 * 1024.0)) / seconds;
+				}
+			};
+
+			// 0 picks std::thread::hardware_concurrency()
+			ObjImporter(size_t threadCount = 0);
+			~ObjImporter() = default;
+
+			bool importFile(const std::string& filePath, ObjMeshData& output);
+			bool importMemory(const char* data, size_t size, ObjMeshData& output);
+
+			const std::string& getError() const { return error; }
+			const Stats& getStats() const { return stats; }
+
+			// Chunks smaller than this are not worth a thread
+			const static size_t MIN_CHUNK_BYTES = 256 * 1024;
+
+		private:
+			struct Chunk;
+
+			void parseChunk(Chunk& chunk);
+			bool mergeChunks(std::vector<Chunk>& chunks, ObjMeshData& output);
+
+			size_t threads = 1;
+			std::string error;
+			Stats stats{};
+	};
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <vector>
+
+namespace Starry
+{
+	// One object's entry in the per-frame object buffer, std430 layout of ObjectData in simple_shader.vert
+	// built with STARRY_OBJECT_BUFFER. That variant reads the matrices instead of multiplying them and
+	// inverting the model. The null and software backends draw from the object buffer, Render::RenderContext
+	// does not load the variant yet and takes one uniform per object.
+	struct ObjectData {
+		glm::mat4 modelViewProjection;
+		glm::vec4 normalMatrix[3]; // Columns of transpose(inverse(mat3(model))), w unused
+	};
+	static_assert(sizeof(ObjectData) == 112, "ObjectData must match the std430 layout");
+
+	// Ring of per-frame regions, each holding every drawn object's ObjectData back to back. Packing a frame
+	// moves to the next region, so the ones still read by frames in flight are left alone. Instance i of
+	// the frame reads entry i of the current region, through its dynamic offset.
+	class ObjectDataBuffer {
+		public:
+			explicit ObjectDataBuffer(size_t framesInFlight = FRAMES_IN_FLIGHT);
+
+			// Packs viewProjection * models[i] and the normal matrix of every object into the next region,
+			// spread across the job system
+			const ObjectData* pack(const glm::mat4& viewProjection, const glm::mat4* models, size_t count);
+
+			// Single threaded packing of one batch, what pack runs per job
+			static void packRange(const glm::mat4& viewProjection, const glm::mat4* models, ObjectData* output, size_t count);
+
+			const ObjectData* frameData() const { return storage.data() + frame * capacity; }
+			size_t objectCount() const { return count; }
+			// Byte offset of the current region, the dynamic offset to bind it with
+			size_t frameOffsetBytes() const { return frame * capacity * sizeof(ObjectData); }
+
+			// Whole ring, what gets mapped or uploaded
+			const void* data() const { return storage.data(); }
+			size_t sizeBytes() const { return storage.size() * sizeof(ObjectData); }
+
+			constexpr static size_t FRAMES_IN_FLIGHT = 3;
+			// Below this many objects per job the fan-out costs more than it saves
+			constexpr static size_t PARALLEL_OBJECTS = 2048;
+
+		private:
+			std::vector<ObjectData> storage;
+			size_t frames = 0;
+			size_t capacity = 0; // Objects per region
+			size_t frame = 0;
+			size_t count = 0;
+	};
+}
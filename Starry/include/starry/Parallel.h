@@ -0,0 +1,44 @@
+#pragma once
+
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+
+namespace Starry
+{
+	inline size_t defaultThreadCount()
+	{
+		return std::max<size_t>(1, std::thread::hardware_concurrency());
+	}
+
+	// Runs work(i) for i in [0, count) as jobs on the shared pool. Index 0 runs on the calling thread,
+	// which keeps running jobs until every index is done.
+	template <typename Work>
+	void runParallel(size_t count, Work&& work)
+	{
+		if (count == 0) return;
+		if (count == 1) {
+			work(0);
+			return;
+		}
+		JobSystem& jobs = JobSystem::get();
+		JobCounter counter;
+		for (size_t i = 1; i < count; i++) {
+			jobs.run([&work, i]() { work(i); }, &counter);
+		}
+		work(0);
+		jobs.wait(counter);
+	}
+
+	// Splits [0, size) into at most `threads` contiguous ranges and runs work(begin, end) on each
+	template <typename Work>
+	void parallelRanges(size_t size, size_t threads, Work&& work)
+	{
+		size_t count = std::clamp<size_t>(threads, 1, std::max<size_t>(1, size));
+		runParallel(count, [&](size_t i) {
+			work((size * i) / count, (size * (i + 1)) / count);
+		});
+	}
+}
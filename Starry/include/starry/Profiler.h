@@ -0,0 +1,123 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Scope timing, compiled out unless STARRY_PROFILING is defined (the STARRY_ENABLE_PROFILING CMake option).
+// Names must be string literals or otherwise outlive the profiler, only the pointer is recorded.
+#ifdef STARRY_PROFILING
+	#define STARRY_PROFILE_CONCAT_INNER(a, b) a##b
+	#define STARRY_PROFILE_CONCAT(a, b) STARRY_PROFILE_CONCAT_INNER(a, b)
+	#define STARRY_PROFILE_SCOPE(name) ::Starry::ProfileScope STARRY_PROFILE_CONCAT(profileScope, __COUNTER__)(name)
+	#define STARRY_PROFILE_FUNCTION() STARRY_PROFILE_SCOPE(__func__)
+	#define STARRY_PROFILE_THREAD(name) ::Starry::Profiler::setThreadName(name)
+#else
+	#define STARRY_PROFILE_SCOPE(name)
+	#define STARRY_PROFILE_FUNCTION()
+	#define STARRY_PROFILE_THREAD(name)
+#endif
+
+namespace Starry
+{
+	// One finished scope, times in nanoseconds since the profiler started
+	struct ProfileRecord {
+		const char* name = nullptr;
+		uint32_t thread = 0;
+		uint32_t depth = 0; // Scopes open around it on the same thread
+		uint64_t start = 0;
+		uint64_t end = 0;
+	};
+
+	struct ProfileThread {
+		uint32_t id = 0;
+		std::string name;
+		uint64_t recorded = 0; // Scopes ever finished, older ones are overwritten past RING_SIZE
+	};
+
+	// Every thread that times a scope gets its own ring of finished scopes. Only that thread writes it and
+	// readers copy out without stopping it, so a scope costs two clock reads and a handful of stores.
+	class Profiler {
+		public:
+			// Runtime switch on top of the compile time one, scopes skip the clock reads while off
+			static void setEnabled(bool enabled) { active.store(enabled, std::memory_order_relaxed); }
+			static bool isEnabled() { return active.load(std::memory_order_relaxed); }
+
+			static void setThreadName(const char* name);
+
+			static uint64_t now();
+
+			// Copies every scope still in the rings, grouped by thread and in the order they finished
+			static std::vector<ProfileRecord> collect();
+			static std::vector<ProfileThread> threads();
+
+			// The newest finished scope named root and everything its thread timed inside it, root first.
+			// False when no such scope is in the rings.
+			static bool collectLatest(const char* root, std::vector<ProfileRecord>& records);
+
+			// Chrome trace event JSON, opens in Perfetto and chrome://tracing
+			static bool writeChromeTrace(const std::string& filePath);
+
+			// Per thread, 16 k scopes is a few seconds of frames with the shipped instrumentation
+			constexpr static size_t RING_SIZE = 1 << 14;
+
+			// Scope internals, use the macros
+			static uint32_t enter();
+			static void leave(const char* name, uint64_t start, uint32_t depth);
+
+		private:
+			struct Slot {
+				std::atomic<const char*> name{ nullptr };
+				std::atomic<uint64_t> start{ 0 };
+				std::atomic<uint64_t> end{ 0 };
+				std::atomic<uint32_t> depth{ 0 };
+			};
+
+			struct ThreadRing {
+				uint32_t id = 0;
+				std::string name; // Guarded by registryMutex
+				uint32_t depth = 0; // Owner only
+				std::atomic<uint64_t> head{ 0 };
+				std::array<Slot, RING_SIZE> slots;
+			};
+
+			static ThreadRing& localRing();
+			static void copyRing(const ThreadRing& ring, std::vector<ProfileRecord>& records);
+
+			inline static std::atomic<bool> active{ true };
+
+			// Rings outlive their threads so a trace still shows loader and job threads that finished
+			inline static std::mutex registryMutex;
+			inline static std::vector<std::unique_ptr<ThreadRing>> rings;
+	};
+
+	class ProfileScope {
+		public:
+			explicit ProfileScope(const char* scopeName) : name(scopeName)
+			{
+				if (Profiler::isEnabled()) {
+					depth = Profiler::enter();
+					start = Profiler::now();
+				}
+			}
+			~ProfileScope()
+			{
+				if (start != 0) {
+					Profiler::leave(name, start, depth);
+				}
+			}
+
+			ProfileScope(const ProfileScope&) = delete;
+			ProfileScope& operator=(const ProfileScope&) = delete;
+
+		private:
+			const char* name;
+			uint64_t start = 0;
+			uint32_t depth = 0;
+	};
+}
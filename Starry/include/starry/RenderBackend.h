@@ -0,0 +1,97 @@
+#pragma once
+
+#include <StarryManager.h>
+#include <StarryRender.h>
+
+#include "ObjectDataBuffer.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Starry
+{
+	enum class RenderBackendType
+	{
+		VULKAN,
+		NONE,    // No device or window, records what would have been submitted
+		SOFTWARE // No device or window, draws on the CPU into an image kept in memory
+	};
+
+	// Render::RenderConfig plus what Starry needs to pick and size a backend
+	struct RenderConfig : public Render::RenderConfig {
+		using Render::RenderConfig::RenderConfig;
+
+		RenderBackendType backend = RenderBackendType::VULKAN;
+		// What getExtent reports when there is no window to size against
+		std::array<unsigned int, 2> headlessExtent = { 1280, 720 };
+
+		// Read by the software backend only, the Vulkan context takes its own from the constructor arguments
+		MSAAOptions softwareMsaa = MSAAOptions::MSAA_DISABLED;
+		std::array<float, 3> softwareClearColor = { 0.0f, 0.0f, 0.0f };
+	};
+
+	// Instances [firstInstance, firstInstance + instanceCount) of the submitted object data, drawn with a buffer
+	// and the texture its descriptor set binds. Both were handed to Load and stay alive with the backend.
+	struct ObjectDraw {
+		Render::Buffer* buffer = nullptr;
+		Render::DescriptorSet* descriptorSet = nullptr;
+		uint32_t firstInstance = 0;
+		uint32_t instanceCount = 0;
+	};
+
+	// The part of Render::RenderContext the engine drives, plus the resource writes that would otherwise go
+	// straight to the device, so a backend without one can stand in for the whole frame
+	class RenderBackend {
+		public:
+			virtual ~RenderBackend() = default;
+
+			static std::unique_ptr<RenderBackend> create(std::shared_ptr<Render::Window>& window, const RenderConfig& config);
+
+			virtual RenderBackendType getType() const = 0;
+
+			virtual void Load(std::shared_ptr<Render::Canvas>& canvas) = 0;
+			virtual void Load(std::shared_ptr<Render::Buffer>& buffer) = 0;
+			virtual void Load(std::shared_ptr<Render::DescriptorSet>& descriptorSet) = 0;
+			virtual void Ready() = 0;
+			virtual void Draw() = 0;
+			virtual void WaitIdle() = 0;
+			virtual std::array<unsigned int, 2> getExtent() = 0;
+			virtual bool getErrorState() = 0;
+			// A fatal alert raised while setting up or drawing
+			virtual bool isFatal() = 0;
+
+			virtual void loadBufferData(Render::Buffer& buffer, std::vector<Render::Vertex>& vertices, std::vector<uint32_t>& indices) = 0;
+			virtual void writeUniform(Render::Uniform& uniform, Render::UniformData& data) = 0;
+			virtual void storeTexture(Render::TextureImage& texture, const std::string& filePath) = 0;
+			// The uniform and texture UUIDs a descriptor set binds, in binding order
+			virtual void bindDescriptors(Render::DescriptorSet& descriptorSet, const std::vector<size_t>& descriptors)
+			{
+				descriptorSet.addDescriptors(descriptors);
+			}
+
+			// Backends that take their matrices from the object buffer. Once something was submitted they draw only
+			// the submitted draws, and the uniforms descriptor sets bind are no longer read.
+			virtual bool drawsObjectBuffer() const { return false; }
+			// Object data and draws for every following Draw, until the next submit. Copied, the arrays can be
+			// reused right away.
+			virtual void submitObjects(const ObjectData* objects, size_t count, const std::vector<ObjectDraw>& draws) {}
+
+			// Resource writes from code without a renderer at hand, loader threads and objects that are not
+			// registered yet. They go to the live renderer's backend, straight to the resource when there is none.
+			static void bufferData(Render::Buffer& buffer, std::vector<Render::Vertex>& vertices, std::vector<uint32_t>& indices);
+			static void uniformData(Render::Uniform& uniform, Render::UniformData& data);
+			static void textureFile(Render::TextureImage& texture, const std::string& filePath);
+			static void descriptorData(Render::DescriptorSet& descriptorSet, const std::vector<size_t>& descriptors);
+
+			// Set by the Renderer that owns the backend, before any object loads
+			static void setActive(RenderBackend* backend) { active.store(backend, std::memory_order_release); }
+			static RenderBackend* getActive() { return active.load(std::memory_order_acquire); }
+
+		private:
+			inline static std::atomic<RenderBackend*> active{ nullptr };
+	};
+}
@@ -4,17 +4,29 @@
 #include <StarryRender.h>
 
 #include "Timer.h"
+#include "FrameLimiter.h"
 #include "Interface.h"
+#include "RenderBackend.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
 
 namespace Starry
 {
 	class Scene;
 
-	using RenderConfig = Render::RenderConfig;
 	using Window = Render::Window;
 
+	enum class RenderMode
+	{
+		CONTINUOUS, // Draws back to back, held to the frame rate limit if one is set
+		ON_DEMAND   // Sleeps until requestRedraw, a scene change or the idle redraw interval
+	};
+
 	class Renderer : public Manager::StarryAsset {
 		public:
+			// The window may be null with RenderBackendType::NONE
 			Renderer(std::shared_ptr<Window>& windowRef, RenderConfig config);
 			~Renderer();
 
@@ -23,14 +35,34 @@ namespace Starry
 
 			void setShaderPaths(const std::array<std::string, 2>& paths);
 
+			// Above zero, scene updates run on their own thread at this many ticks per second and the render
+			// thread only presents the newest result. Zero updates once per drawn frame. Set before disbatching.
+			void setFixedUpdateRate(double ticksPerSecond, bool interpolate = true) { fixedUpdateRate = ticksPerSecond; interpolateUpdates = interpolate; }
+			// Seconds simulated by the current scene update, the fixed tick or the last frame time
+			float getSimulationDeltaSeconds() const { return simulationDelta; }
+
+			// Frames per second the render thread is held to, zero runs uncapped. Can change while rendering.
+			void setFrameRateLimit(double framesPerSecond) { limiter.setTargetRate(framesPerSecond); }
+			double getFrameRateLimit() const { return limiter.getTargetRate(); }
+			// ON_DEMAND still draws every idleRedrawInterval so UI that changes without telling anyone (hover,
+			// resizes, metric overlays) catches up. Set before disbatching.
+			void setRenderMode(RenderMode mode, std::chrono::milliseconds idleRedrawInterval = DEFAULT_IDLE_REDRAW) { renderMode = mode; idleRedraw = idleRedrawInterval; }
+			RenderMode getRenderMode() const { return renderMode; }
+			// Wakes an idle ON_DEMAND render thread for one more frame. Any thread, cheap to call repeatedly.
+			void requestRedraw();
+
 			void disbatchRenderer();
 			void joinRenderer();
+			// Blocks until the render thread stops or timeout passes, false once it has stopped
+			bool waitWhileRunning(std::chrono::milliseconds timeout);
 			
 			void UIPollEvents() { interface->PollEvents(); }
 
 			std::atomic<bool>& isRenderRunning() { return renderRunning; }
+			// Set once a fatal error stops rendering, or by the render loop's periodic look at the asset manager
+			bool isFatal() const { return fatal.load(std::memory_order_relaxed); }
 
-			Render::RenderContext& context() { return renderer; }
+			RenderBackend& context() { return *renderer; }
 			Timer timer = {};
 
 			void askCallback(std::shared_ptr<Manager::ResourceAsk>& ask) override;
@@ -38,12 +70,39 @@ namespace Starry
 			ASSET_NAME("Renderer")
 		private:
 			void renderLoop();
+			void simulationLoop();
+			// True when the thread had to sleep before a redraw was asked for
+			bool waitForRedraw();
+			void stopRendering();
+			// Copies the asset manager's fatal state into fatal, at most every HEALTH_CHECK_INTERVAL
+			void refreshHealth();
+
+			// Ticks run back to back after a stall before the simulation gives up on catching up
+			constexpr static int MAX_CATCH_UP_TICKS = 5;
+			constexpr static std::chrono::milliseconds DEFAULT_IDLE_REDRAW = std::chrono::milliseconds(250);
+			constexpr static std::chrono::milliseconds HEALTH_CHECK_INTERVAL = std::chrono::milliseconds(100);
 
 			std::array<std::string, 2> shaderPaths = DEFAULT_SHADER_PATHS;
-			Render::RenderContext renderer{};
+			std::unique_ptr<RenderBackend> renderer = nullptr;
 
 			std::thread renderThread;
+			std::thread simulationThread;
 			std::atomic<bool> renderRunning{ false };
+			std::atomic<bool> fatal{ false };
+			std::chrono::steady_clock::time_point nextHealthCheck{}; // Render thread only
+
+			FrameLimiter limiter;
+			RenderMode renderMode = RenderMode::CONTINUOUS;
+			std::chrono::milliseconds idleRedraw = DEFAULT_IDLE_REDRAW;
+			std::atomic<bool> redrawRequested{ true };
+			// Guards the waits below against a wake up landing between the check and the sleep
+			std::mutex wakeMutex;
+			std::condition_variable redrawSignal;
+			std::condition_variable stopSignal;
+
+			double fixedUpdateRate = 0.0;
+			bool interpolateUpdates = true;
+			float simulationDelta = 0.0f;
 
 			std::shared_ptr<Scene> activeScene = nullptr;
 			std::shared_ptr<Interface> interface = nullptr;
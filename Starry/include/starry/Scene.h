@@ -2,17 +2,46 @@
 
 #include <StarryManager.h>
 
+#include <atomic>
+#include <chrono>
+#include <future>
 #include <vector>
 #include <memory>
+#include <mutex>
 #include <thread>
+#include <unordered_map>
 
 #include "SceneObject.h"
 #include "Renderer.h"
+#include "DynamicAabbTree.h"
+#include "InstanceBatcher.h"
+#include "ObjectDataBuffer.h"
+#include "SceneFile.h"
+#include "SlotMap.h"
+#include "TransformStore.h"
+#include "TripleBuffer.h"
 
 #define DEFAULT_SCENE_NAME "New Scene"
 
 namespace Starry
 {
+	// Everything presentation needs from one simulation step. Written by simulate, never touched again
+	// once published.
+	struct FrameSnapshot {
+		// Visible objects with their world matrix this tick and the tick before
+		std::vector<SceneObject*> objects;
+		std::vector<glm::mat4> models;
+		std::vector<glm::mat4> previousModels;
+
+		glm::mat4 view{ 1.0f };
+		glm::mat4 proj{ 1.0f };
+		ViewParameters viewParameters{};
+
+		uint64_t tick = 0;
+		std::chrono::steady_clock::time_point time{};
+		float tickSeconds = 0.0f;
+	};
+
 	class Scene : public Manager::StarryAsset {
 	public:
 		Scene(const std::string name);
@@ -24,18 +53,137 @@ namespace Starry
 
 		void attatchRenderer(std::shared_ptr<Renderer>& renderContext);
 
-		void pushObject(std::shared_ptr<SceneObject>& obj);
+		// Objects join and leave the simulation at the start of its next tick, so both are safe from any thread
+		// while rendering. The handle works right away, it is INVALID_HANDLE when the object is already in a scene.
+		SceneHandle pushObject(std::shared_ptr<SceneObject>& obj);
 		void pushObjects(std::vector<std::shared_ptr<SceneObject>>& objs);
+		// The object is hidden and let go of once no frame being presented refers to it. Children stay where
+		// they are, unparented. False for a stale handle.
+		bool removeObject(SceneHandle handle);
+
+		// Null once the object is removed
+		std::shared_ptr<SceneObject> getObject(SceneHandle handle) const;
+		// For editor lookups. Names need not be unique, any object carrying the name may come back.
+		std::shared_ptr<SceneObject> findObject(const std::string& name) const;
+
+		// Snapshot of every object with a record (see SceneObject::saveRecord) to filePath, for SceneLoader.
+		// While a renderer runs the scene, records are gathered at the start of the next simulation tick,
+		// otherwise right away. The asset loader writes the file, the future turns false if it could not.
+		std::future<bool> save(const std::string& filePath);
 
 		void loadObjects(Renderer* renderer);
+		// simulate then present, for renderers that update once per drawn frame
 		void updateObjects(Renderer* renderer);
 
+		// Runs one step of every object and publishes the visible ones as a snapshot. Can run on its own
+		// thread, concurrently with present.
+		void simulate(Renderer* renderer);
+		// Uploads the newest snapshot. With interpolate, world matrices blend from the tick before toward
+		// the newest one by how far into the next tick we are, which trails the simulation by a tick.
+		void present(Renderer* renderer, bool interpolate);
+
+		// Safe to read from anywhere
+		size_t getTotalObjectCount() const { return totalObjectCount.load(std::memory_order_relaxed); }
+		size_t getVisibleObjectCount() const { return visibleObjectCount.load(std::memory_order_relaxed); }
+
+		// Instanced draws the presented objects collapse into, written once per presented snapshot. Backends drawing
+		// from the object buffer issue one draw per batch, Render::RenderContext still draws every object on its own.
+		size_t getInstanceBatchCount() const { return instanceBatchCount.load(std::memory_order_relaxed); }
+
+		// Packed matrices of every presented object in batch order, render thread only. Only filled for backends
+		// that draw from the object buffer, the others get a uniform per object.
+		const ObjectDataBuffer& getObjectData() const { return objectData; }
+		const std::vector<InstanceBatch>& getInstanceBatches() const { return batcher.getBatches(); }
+
+		constexpr static SceneHandle INVALID_HANDLE = SlotMap<std::shared_ptr<SceneObject>>::INVALID_HANDLE;
+
 		ASSET_NAME("Scene: " + sceneName)
 	private:
+		friend class SceneObject;
+
+		// Caller holds objectMutex
+		SceneHandle insertObject(std::shared_ptr<SceneObject>& obj);
+		// Simulation side of pushObject and removeObject, at the start of a tick
+		void applyChanges();
+		struct PendingSave {
+			std::string filePath;
+			std::promise<bool> written;
+		};
+		// Simulation side of save, queued ones run right after applyChanges
+		void applySaves();
+		void gatherRecords(SceneFileWriter& writer);
+		static void writeRecords(std::shared_ptr<SceneFileWriter> writer, std::vector<PendingSave> saves);
+		void addObject(SceneObject* obj);
+		void detachObject(SceneObject* obj);
+		void linkParent(SceneObject* obj);
+		// Render side, objects pushed after loadObjects and removed objects no longer presented
+		void registerPending(Renderer* renderer);
+		void releaseRetired(uint64_t presentedTick);
+		void refitBounds();
+
+		void trackLoad(SceneObject* obj);
+		// Wakes an on demand renderer, objects call it when their transform changes
+		void requestRedraw() { if (redrawTarget != nullptr) redrawTarget->requestRedraw(); }
+		// Render side of finished loads, then the simulation side
+		void commitLoads();
+		void commitLoadedBounds();
+
+		// Objects per job when updating, enough to outweigh queueing a job
+		constexpr static size_t UPDATE_BATCH = 64;
+
 		std::string sceneName = DEFAULT_SCENE_NAME;
+		Renderer* redrawTarget = nullptr; // Set by loadObjects, before the render threads start
+
+		// Owns every object in the scene. The lists below point into it and only change in applyChanges.
+		mutable std::mutex objectMutex;
+		SlotMap<std::shared_ptr<SceneObject>> sceneObjects;
+		std::unordered_multimap<std::string, SceneHandle> nameIndex;
+		std::vector<std::shared_ptr<SceneObject>> pendingAdds;
+		std::vector<std::shared_ptr<SceneObject>> pendingRemovals;
+		std::vector<std::shared_ptr<SceneObject>> pendingRegistration;
+		bool objectsRegistered = false;
+
+		std::mutex saveMutex;
+		std::vector<PendingSave> pendingSaves;
+
+		// Removed objects wait here until presentation has moved past the tick that dropped them
+		std::mutex retireMutex;
+		std::vector<std::pair<uint64_t, std::shared_ptr<SceneObject>>> retiredObjects;
+
+		// Transform hierarchy of every mesh
+		TransformStore transformStore;
+		std::vector<SceneObject*> transformOwners; // By handle
+		std::unordered_map<SceneObject*, std::vector<SceneObject*>> waitingChildren; // Parent not pushed yet
+
+		// Objects with bounds live in the tree and are culled, the rest (cameras) update first so the others see their view
+		DynamicAabbTree boundsTree;
+		std::vector<SceneObject*> boundedObjects;
+		std::vector<SceneObject*> unboundedObjects;
+		std::vector<SceneObject*> refitQueue;
+		std::vector<SceneObject*> visibleObjects;
+		uint64_t tickIndex = 0;
+
+		TripleBuffer<FrameSnapshot> snapshots;
+
+		// Objects waiting on a background load, polled before presenting, then queued for the simulation
+		std::mutex loadMutex;
+		std::vector<SceneObject*> loadingObjects;
+		std::vector<SceneObject*> loadedObjects;
+		std::vector<SceneObject*> committingObjects;
+
+		// Presentation side
+		std::vector<SceneObject*> presentedObjects;
+		std::vector<glm::mat4> presentModels; // Batch order
+		std::vector<glm::mat4> presentModelViewProjections; // Batch order, unless packed
+		std::vector<ObjectDraw> objectDraws;
+		std::vector<uint64_t> batchKeys;
+		InstanceBatcher batcher;
+		ObjectDataBuffer objectData;
+		uint64_t presentFrame = 0;
 
-		std::map<std::string, std::shared_ptr<SceneObject>> sceneObjects;
-		// TODO: something wrong with stack allocated StarryAssets
+		std::atomic<size_t> totalObjectCount{ 0 };
+		std::atomic<size_t> visibleObjectCount{ 0 };
+		std::atomic<size_t> instanceBatchCount{ 0 };
 	};
 }
 // TODO: seperate out renderer
\ No newline at end of file
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "MappedFile.h"
+
+namespace Starry
+{
+	// On-disk layout of a scene snapshot (.sscene). Little endian and written as it sits in memory, so a
+	// mapped file is read in place and objects are built straight from the records.
+	//
+	//   SceneFileHeader
+	//   SceneObjectRecord array (objectCount) at objectOffset, parents before their children
+	//   SceneAssetRecord array (assetCount) at assetOffset
+	//   string bytes (stringBytes) at stringOffset, names and paths without terminators
+	struct SceneFileHeader {
+		char magic[4] = { 'S', 'S', 'C', 'N' };
+		uint32_t version = 0;
+		uint32_t objectCount = 0;
+		uint32_t assetCount = 0;
+
+		uint64_t objectOffset = 0;
+		uint64_t assetOffset = 0;
+		uint64_t stringOffset = 0;
+		uint64_t stringBytes = 0;
+
+		uint64_t payloadHash = 0; // Everything after the header
+	};
+
+	enum class SceneAssetKind : uint32_t
+	{
+		MESH,
+		TEXTURE
+	};
+
+	struct SceneAssetRecord {
+		uint64_t contentHash = 0; // Of the source file, 0 when it could not be read at save time
+		SceneAssetKind kind = SceneAssetKind::MESH;
+		uint32_t pathOffset = 0;
+		uint32_t pathLength = 0;
+		uint32_t reserved = 0;
+	};
+
+	struct SceneObjectRecord {
+		constexpr static uint32_t NO_INDEX = ~0u;
+
+		// Mesh flags. Bit 0 was compact vertices, older files may still set it and it is ignored.
+		constexpr static uint32_t MESHLET_CULLING = 1 << 1;
+
+		uint32_t type = 0;  // SceneObject::Type
+		uint32_t flags = 0; // Meaning depends on type
+		uint32_t nameOffset = 0;
+		uint32_t nameLength = 0;
+		uint32_t parent = NO_INDEX;  // Earlier record
+		uint32_t mesh = NO_INDEX;    // Asset records
+		uint32_t texture = NO_INDEX;
+		uint32_t reserved = 0;
+
+		float translation[3] = { 0.0f, 0.0f, 0.0f };
+		float rotation[4] = { 1.0f, 0.0f, 0.0f, 0.0f }; // w, x, y, z
+		float scale[3] = { 1.0f, 1.0f, 1.0f };
+
+		// Cameras
+		float fov = 0.0f;
+		float nearPlane = 0.0f;
+		float farPlane = 0.0f;
+		float reserved2 = 0.0f;
+	};
+
+	// Collects records in memory, cheap enough to fill on the simulation thread, and writes them out later
+	class SceneFileWriter {
+		public:
+			void reserve(size_t objectCount);
+
+			// Objects with the same kind and path share one asset record
+			uint32_t addAsset(SceneAssetKind kind, const std::string& path, uint64_t contentHash = 0);
+			void addObject(SceneObjectRecord record, std::string_view name);
+
+			std::vector<SceneAssetRecord>& getAssets() { return assets; }
+			std::string_view assetPath(const SceneAssetRecord& asset) const { return std::string_view(strings).substr(asset.pathOffset, asset.pathLength); }
+			size_t getObjectCount() const { return objects.size(); }
+
+			// Fills in the content hash of assets saved without one, by reading their files
+			void hashMissingAssets();
+
+			// Writes through a temporary file and renames it into place, so a reader never maps a partial file
+			bool write(const std::string& filePath) const;
+
+		private:
+			uint32_t addString(std::string_view text);
+
+			std::vector<SceneObjectRecord> objects;
+			std::vector<SceneAssetRecord> assets;
+			std::unordered_map<std::string, uint32_t> assetIndices; // Kind and path
+			std::string strings;
+	};
+
+	// A mapped snapshot. Records point into the mapping and stay valid until close() or destruction.
+	class SceneFile {
+		public:
+			// Bump whenever the header or a record layout changes
+			const static uint32_t VERSION = 1;
+			const static size_t PAYLOAD_ALIGNMENT = 16;
+
+			SceneFile() = default;
+			~SceneFile() = default;
+
+			// Maps the file and checks the header, the payload hash and every index and string reference
+			bool open(const std::string& filePath);
+			void close();
+
+			bool isOpen() const { return file.isOpen(); }
+
+			std::span<const SceneObjectRecord> getObjects() const { return objects; }
+			std::span<const SceneAssetRecord> getAssets() const { return assets; }
+
+			std::string_view getName(const SceneObjectRecord& object) const { return strings.substr(object.nameOffset, object.nameLength); }
+			std::string_view getPath(const SceneAssetRecord& asset) const { return strings.substr(asset.pathOffset, asset.pathLength); }
+			// Null for NO_INDEX
+			const SceneAssetRecord* getAsset(uint32_t index) const { return index < assets.size() ? &assets[index] : nullptr; }
+
+		private:
+			MappedFile file;
+			std::span<const SceneObjectRecord> objects;
+			std::span<const SceneAssetRecord> assets;
+			std::string_view strings;
+	};
+}
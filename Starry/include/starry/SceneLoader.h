@@ -0,0 +1,40 @@
+#pragma once
+
+#include "Scene.h"
+#include "SceneFile.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Starry
+{
+	// Rebuilds a scene from a snapshot written by Scene::save. Records are read in place from the mapped file
+	// and objects are built a slice at a time, so a large scene can stream in across frames while the first
+	// objects already draw. Meshes load on the AssetLoader threads, objects sharing a content hash share one load.
+	class SceneLoader {
+		public:
+			bool open(const std::string& filePath);
+			void close();
+
+			// Builds up to maxObjects more objects and pushes them into scene in one batch. Returns how many
+			// records were read, 0 once everything is loaded.
+			size_t loadNext(Scene& scene, size_t maxObjects);
+
+			bool isDone() const { return next >= file.getObjects().size(); }
+			size_t getLoadedCount() const { return next; }
+			size_t getObjectCount() const { return file.getObjects().size(); }
+
+			// The whole file at once, false when it could not be opened
+			static bool load(Scene& scene, const std::string& filePath);
+
+		private:
+			// Null for types snapshots do not know how to build
+			std::shared_ptr<SceneObject> create(const SceneObjectRecord& record);
+
+			SceneFile file;
+			size_t next = 0;
+			std::vector<std::shared_ptr<SceneObject>> built; // By record, for linking children to parents
+			std::vector<std::shared_ptr<SceneObject>> batch;
+	};
+}
@@ -4,9 +4,25 @@
 #include <StarryManager.h>
 
 #include "Renderer.h"
+#include "Aabb.h"
+#include "SceneFile.h"
+#include "TransformStore.h"
 
 namespace Starry
 {
+	class Scene;
+
+	// Scene::pushObject's handle, stays unique to the object after it is removed
+	using SceneHandle = uint64_t;
+
+	// What the active camera sees this frame, for detail selection
+	struct ViewParameters {
+		glm::vec3 cameraPosition{ 0.0f };
+		float projectionScale = 1.0f; // Pixels covered by one unit at distance one, viewport height / (2 tan(fov / 2))
+		float nearPlane = 0.1f;
+		glm::mat4 viewProjection{ 1.0f };
+	};
+
 	class SceneObject : public Manager::StarryAsset
 	{
 		public:
@@ -25,25 +41,114 @@ namespace Starry
 			virtual void Update(Renderer* renderer) {}
 			virtual void Destroy() {}
 
+			// Update belongs to the simulation and may run on its own thread. uploadUniform, hide and
+			// updateDetail belong to presentation on the render thread and only see the matrices handed to
+			// them. Both sides spread objects across the job system, one object per thread at a time.
+			// Renderer work beyond the object's own uniform waits for flushDetail. Backends drawing from the
+			// object buffer take the matrices from there, uploadUniform and hide are not called for them.
+			virtual void uploadUniform(Render::UniformData& data) {}
+			virtual void updateDetail(const ViewParameters& view, const glm::mat4& model, const glm::mat4& modelViewProjection) {}
+			virtual void flushDetail() {}
+
+			// Object space bounds, false for objects without extent such as cameras. Those are never culled.
+			virtual bool getLocalBounds(Aabb& bounds) const { return false; }
+			Aabb getWorldBounds() const;
+
+			// Called when the object drops out of the view. Update keeps running, uploads and updateDetail stop
+			// until it comes back.
+			virtual void hide() {}
+
+			// Objects returning the same non zero key draw the same geometry with the same material and are
+			// packed next to each other in the object buffer, one instanced draw per key. 0 draws alone.
+			virtual uint64_t getBatchKey() const { return 0; }
+			// What a backend drawing from the object buffer draws this object with, false when there is nothing to draw
+			virtual bool getDrawResources(Render::Buffer*& buffer, Render::DescriptorSet*& descriptorSet) const { return false; }
+
+			// Background loads hand their result over at frame boundaries. commitLoad runs on the render
+			// thread before presenting and returns false while the load is still running. Once it returns
+			// true the scene passes the object to the simulation, which calls commitLoadedBounds.
+			virtual bool hasPendingLoad() const { return false; }
+			virtual bool commitLoad() { return true; }
+			virtual void commitLoadedBounds() {}
+
+			// Scene snapshots. The scene writes the name, type, parent and local transform, saveRecord adds
+			// what the type needs to be rebuilt and returns false to leave the object out. loadRecord runs on
+			// a freshly constructed object before it is pushed.
+			virtual bool saveRecord(SceneObjectRecord& record, SceneFileWriter& writer) const { return false; }
+			virtual void loadRecord(const SceneObjectRecord& record, const SceneFile& file) {}
+
 			std::string& getName() { return name; }
 
+			// Applied in object space, on top of the current local transform
 			void rotate(float angleRadians, const glm::vec3& axis);
 			void translate(const glm::vec3& translation);
 			void scale(const glm::vec3& scaleFactors);
 
+			const LocalTransform& getLocalTransform() const;
+			void setLocalTransform(const LocalTransform& local);
+			void setPosition(const glm::vec3& position);
+			void setRotation(const glm::quat& rotation);
+			void setScale(const glm::vec3& scaleFactors);
+
+			// The local transform becomes relative to parent, nullptr detaches. Both objects have to end up
+			// in the same scene, the link is made once they are.
+			void setParent(SceneObject* parent);
+			SceneObject* getParent() const { return parentObject; }
+
 			void setProjection(const glm::mat4& proj);
 			void setView(const glm::mat4& view);
 
-			Render::UniformData& getBufferData() { return mvpBufferData; }
+			// Model matrix from the scene's transform store once the object is pushed into a scene
+			Render::UniformData& getBufferData();
+
+			// World matrix, including every parent. Inside Update it is the one from the end of the last tick,
+			// parents may be moving on other threads.
+			glm::mat4 getModelMatrix() const;
+
+			Type getType() const {return type;}
 
-			Type getType() {return type;}
+			// Entry in the scene's object buffer for the frame being presented, the firstInstance of its draw
+			uint32_t getObjectIndex() const { return objectIndex; }
+			// Zero while the object is in no scene
+			SceneHandle getSceneHandle() const { return sceneHandle; }
 
 			virtual ASSET_NAME(std::string("Scene object: ") + const_cast<std::string&>(name))
 		protected:
 			std::string name;
 
 			Render::UniformData mvpBufferData = { 1.0f, 1.0f, 1.0f };
+
+			// Queues the object for a refit in the scene's bounds tree
+			void markBoundsDirty();
+			// Has the scene poll commitLoad, objects not in a scene yet are picked up when pushed
+			void markLoadPending();
 		private:
+			friend class Scene;
+			friend class SceneLoader;
+
+			Scene* scene = nullptr;
+			SceneHandle sceneHandle = 0;
+			uint32_t listIndex = 0; // In the scene's bounded or unbounded objects
+			bool boundsDirty = false;
+
 			Type type;
+
+			// Used until the object joins a scene, the store holds it from then on
+			LocalTransform localTransform{};
+			SceneObject* parentObject = nullptr;
+
+			TransformStore* transforms = nullptr;
+			TransformStore::Handle transformHandle = TransformStore::INVALID_HANDLE;
+
+			int32_t treeProxy = -1;
+			glm::vec3 treeCenter{ 0.0f }; // World bounds center at the last refit
+
+			// Simulation side, what the last snapshot carried
+			glm::mat4 publishedModel{ 1.0f };
+			uint64_t publishedTick = 0;
+
+			// Presentation side
+			uint64_t presentedFrame = 0;
+			uint32_t objectIndex = 0;
 	};
 }
\ No newline at end of file
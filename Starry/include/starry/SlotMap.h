@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace Starry
+{
+	// Values packed densely behind stable 64 bit handles. The low half of a handle is a slot index, the high
+	// half the generation the slot had when the value went in. Removing a value moves the last one into the
+	// hole and bumps the slot's generation, so handles to removed values stop resolving instead of finding
+	// whatever reused the slot. Insert, remove and lookup are constant time, iteration walks a plain array.
+	template <typename T>
+	class SlotMap {
+		public:
+			using Handle = uint64_t;
+			// Generations start at one, so no live handle is ever zero
+			constexpr static Handle INVALID_HANDLE = 0;
+
+			Handle insert(T value)
+			{
+				uint32_t index;
+				if (freeSlots.empty()) {
+					index = static_cast<uint32_t>(slots.size());
+					slots.push_back({ FREE, 1 });
+				}
+				else {
+					index = freeSlots.back();
+					freeSlots.pop_back();
+				}
+				slots[index].dense = static_cast<uint32_t>(values.size());
+				values.push_back(std::move(value));
+				denseToSlot.push_back(index);
+				return makeHandle(index, slots[index].generation);
+			}
+
+			// False for a handle that is stale or was never issued
+			bool remove(Handle handle)
+			{
+				if (!contains(handle)) return false;
+				uint32_t index = slotIndex(handle);
+				uint32_t dense = slots[index].dense;
+				uint32_t last = static_cast<uint32_t>(values.size() - 1);
+
+				if (dense != last) {
+					values[dense] = std::move(values[last]);
+					denseToSlot[dense] = denseToSlot[last];
+					slots[denseToSlot[dense]].dense = dense;
+				}
+				values.pop_back();
+				denseToSlot.pop_back();
+
+				slots[index].dense = FREE;
+				// Generation zero is skipped so a wrapped slot never turns a zero handle valid
+				if (++slots[index].generation == 0) slots[index].generation = 1;
+				freeSlots.push_back(index);
+				return true;
+			}
+
+			bool contains(Handle handle) const
+			{
+				uint32_t index = slotIndex(handle);
+				return index < slots.size() && slots[index].generation == generation(handle) && slots[index].dense != FREE;
+			}
+
+			// Null for a stale handle. Valid until the next insert or remove.
+			T* get(Handle handle) { return contains(handle) ? &values[slots[slotIndex(handle)].dense] : nullptr; }
+			const T* get(Handle handle) const { return contains(handle) ? &values[slots[slotIndex(handle)].dense] : nullptr; }
+
+			void reserve(size_t count)
+			{
+				values.reserve(count);
+				denseToSlot.reserve(count);
+				slots.reserve(count);
+			}
+
+			void clear()
+			{
+				for (uint32_t index : denseToSlot) {
+					slots[index].dense = FREE;
+					if (++slots[index].generation == 0) slots[index].generation = 1;
+					freeSlots.push_back(index);
+				}
+				values.clear();
+				denseToSlot.clear();
+			}
+
+			size_t size() const { return values.size(); }
+			bool empty() const { return values.empty(); }
+
+			// Dense order, which changes whenever something is removed
+			T* begin() { return values.data(); }
+			T* end() { return values.data() + values.size(); }
+			const T* begin() const { return values.data(); }
+			const T* end() const { return values.data() + values.size(); }
+			T& at(size_t dense) { return values[dense]; }
+			const T& at(size_t dense) const { return values[dense]; }
+			Handle handleAt(size_t dense) const { return makeHandle(denseToSlot[dense], slots[denseToSlot[dense]].generation); }
+
+		private:
+			struct Slot {
+				uint32_t dense;      // FREE while no value lives here
+				uint32_t generation;
+			};
+			constexpr static uint32_t FREE = ~0u;
+
+			static Handle makeHandle(uint32_t index, uint32_t generation) { return (static_cast<Handle>(generation) << 32) | index; }
+			static uint32_t slotIndex(Handle handle) { return static_cast<uint32_t>(handle); }
+			static uint32_t generation(Handle handle) { return static_cast<uint32_t>(handle >> 32); }
+
+			std::vector<T> values;
+			std::vector<uint32_t> denseToSlot;
+			std::vector<Slot> slots;
+			std::vector<uint32_t> freeSlots;
+	};
+}
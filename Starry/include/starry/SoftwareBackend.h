@@ -0,0 +1,82 @@
+#pragma once
+
+#include "RenderBackend.h"
+#include "SoftwareRasterizer.h"
+
+#include <mutex>
+#include <unordered_map>
+
+namespace Starry
+{
+	// Draws the scene with SoftwareRasterizer instead of a device, for golden image tests and machines without
+	// a GPU or display. Every loaded buffer is drawn each frame with the uniform and texture its descriptor set
+	// binds, like the Vulkan context does, until object data is submitted. From then on only the submitted draws
+	// are, with their matrices from the object data. The resolved frame stays in memory for getFrame and writeFrame.
+	// Draw never waits on a swapchain, so the render loop runs as fast as the CPU rasterizes. The UI canvas is
+	// accepted but never drawn.
+	class SoftwareBackend : public RenderBackend {
+		public:
+			explicit SoftwareBackend(const RenderConfig& config);
+			~SoftwareBackend() = default;
+
+			RenderBackendType getType() const override { return RenderBackendType::SOFTWARE; }
+
+			void Load(std::shared_ptr<Render::Canvas>& canvas) override {}
+			void Load(std::shared_ptr<Render::Buffer>& buffer) override;
+			void Load(std::shared_ptr<Render::DescriptorSet>& descriptorSet) override;
+			void Ready() override {}
+			void Draw() override;
+			void WaitIdle() override {}
+			std::array<unsigned int, 2> getExtent() override { return extent; }
+			bool getErrorState() override { return false; }
+			bool isFatal() override { return false; }
+
+			void loadBufferData(Render::Buffer& buffer, std::vector<Render::Vertex>& vertices, std::vector<uint32_t>& indices) override;
+			void writeUniform(Render::Uniform& uniform, Render::UniformData& data) override;
+			// Decoded through TextureCooker's decoder, ImageDecoder unless the application set one. Files it cannot
+			// read sample as white.
+			void storeTexture(Render::TextureImage& texture, const std::string& filePath) override;
+			void bindDescriptors(Render::DescriptorSet& descriptorSet, const std::vector<size_t>& descriptors) override;
+			bool drawsObjectBuffer() const override { return true; }
+			void submitObjects(const ObjectData* objects, size_t count, const std::vector<ObjectDraw>& draws) override;
+
+			// The last finished frame, RGBA8 and getExtent() sized
+			std::vector<uint8_t> getFrame() const;
+			bool writeFrame(const std::string& filePath) const;
+			RasterStats getLastFrameStats() const;
+			uint64_t getFrameCount() const;
+
+		private:
+			struct MeshData {
+				std::vector<RasterVertex> vertices;
+				std::vector<uint32_t> indices;
+			};
+
+			// A buffer and the descriptor set loaded after it, the pairs Render::RenderContext draws
+			struct DrawItem {
+				std::shared_ptr<Render::Buffer> buffer;
+				std::shared_ptr<Render::DescriptorSet> descriptorSet;
+			};
+
+			// simple_shader binds the uniform first and the texture second
+			const TextureImageData* boundTexture(const std::vector<size_t>& bindings) const;
+			void drawLoadedBuffers();
+			void drawObjects();
+
+			std::array<unsigned int, 2> extent;
+
+			mutable std::mutex mutex;
+			SoftwareRasterizer rasterizer;
+			uint64_t frames = 0;
+
+			std::vector<DrawItem> drawItems;
+			std::unordered_map<const Render::Buffer*, MeshData> meshes;
+			std::unordered_map<size_t, Render::UniformData> uniforms;  // By uniform UUID
+			std::unordered_map<size_t, TextureImageData> textures;     // By texture UUID
+			std::unordered_map<const Render::DescriptorSet*, std::vector<size_t>> descriptorSets;
+
+			bool objectsSubmitted = false;
+			std::vector<ObjectData> objectData;
+			std::vector<ObjectDraw> objectDraws;
+	};
+}
@@ -0,0 +1,171 @@
+#pragma once
+
+#include "TextureCooker.h"
+
+#include <glm/glm.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Starry
+{
+	// What simple_shader.vert reads that reaches the fragment shader's output
+	struct RasterVertex {
+		glm::vec3 position{ 0.0f };
+		glm::vec2 texCoord{ 0.0f };
+	};
+
+	// Pointers are read when render() runs and must stay valid until it returns
+	struct RasterDraw {
+		const RasterVertex* vertices = nullptr;
+		size_t vertexCount = 0;
+		const uint32_t* indices = nullptr;
+		size_t indexCount = 0;
+		glm::mat4 modelViewProjection{ 1.0f };
+		const TextureImageData* texture = nullptr; // Samples as opaque white when null
+	};
+
+	// Front faces are counter clockwise in framebuffer space, as Vulkan defines them
+	enum class RasterCullMode
+	{
+		NONE,
+		BACK,
+		FRONT
+	};
+
+	struct RasterStats {
+		size_t draws = 0;
+		size_t triangles = 0;    // Submitted
+		size_t clipped = 0;      // Crossed a clip plane and were split
+		size_t culled = 0;       // Off screen, facing away or without area
+		size_t binned = 0;       // Triangle and tile pairs
+		size_t shadedPixels = 0; // Fragment shader runs, once per pixel with any sample covered
+		double setupSeconds = 0.0;
+		double rasterSeconds = 0.0;
+	};
+
+	struct ImageDifference {
+		int maxDifference = 0;        // Largest channel difference, 0 to 255
+		double meanDifference = 0.0;  // Over every channel
+		size_t differingPixels = 0;   // With any channel off by more than the tolerance
+	};
+
+	// Tile based CPU stand in for the Vulkan pipeline that draws simple_shader: triangles are clipped and set up
+	// in parallel batches, binned into TILE_SIZE tiles, and each tile is cleared, rasterized with depth testing
+	// and resolved on its own job, in submission order. Coverage follows Vulkan's rules: top left fill, the
+	// standard sample positions for 1, 2, 4 and 8 samples, depth LESS, one shading per pixel at its center.
+	// Coverage is tested 8 pixels at a time with AVX2 when the CPU has it, the scalar path is the reference
+	// and produces the same image bit for bit.
+	class SoftwareRasterizer {
+		public:
+			// samples is 1, 2, 4 or 8
+			void setTarget(uint32_t width, uint32_t height, uint32_t samples);
+			void setClearColor(const glm::vec4& color);
+			void setCullMode(RasterCullMode mode) { cullMode = mode; }
+			// False forces the scalar coverage path, for checking the wide one against it
+			void setSimd(bool enabled) { simd = enabled; }
+
+			// Starts a new frame's draw list
+			void begin();
+			void draw(const RasterDraw& draw);
+			// Clears, draws everything since begin() and resolves into the image
+			void render();
+
+			uint32_t getWidth() const { return width; }
+			uint32_t getHeight() const { return height; }
+			uint32_t getSamples() const { return samples; }
+			// RGBA8, rows tightly packed, top row first
+			const std::vector<uint8_t>& getImage() const { return image; }
+			RasterStats getStats() const { return stats; }
+
+			// Binary PPM, alpha dropped
+			static bool writeImage(const std::string& filePath, const uint8_t* pixels, uint32_t width, uint32_t height);
+			static ImageDifference compare(const uint8_t* a, const uint8_t* b, uint32_t width, uint32_t height, int tolerance);
+
+			static const char* activeKernel();
+
+			constexpr static uint32_t TILE_SIZE = 64;
+			// Triangles per setup job at the least
+			constexpr static size_t SETUP_BATCH = 256;
+			// Clip space guard band, in multiples of w. Keeps screen coordinates small enough for float edge functions.
+			constexpr static float GUARD_BAND = 8.0f;
+			constexpr static uint32_t SPAN = 8;
+
+			// Screen space triangle, ready to rasterize. Public for the coverage kernels only.
+			struct Triangle {
+				// Edge i is opposite vertex i: e = edgeA * (x - originX) + edgeB * (y - originY), positive inside
+				float edgeA[3];
+				float edgeB[3];
+				float originX[3];
+				float originY[3];
+				bool topLeft[3];  // Samples exactly on the edge are covered
+				float inverseArea;
+				float depth[3];
+				float inverseW[3];
+				float texCoordW[3][2]; // texCoord / w
+				int32_t minX, minY, maxX, maxY; // Pixel bounds, inclusive and on screen
+				uint32_t draw;
+			};
+
+			// Covered samples of the SPAN pixels starting at (x, y) that pass the depth test, one bit per sample.
+			// Depth is written for every sample that passes.
+			struct SpanTarget {
+				float* depth;        // (x, y) of sample 0, sample planes are samplePlane floats apart
+				size_t samplePlane;
+				const float* sampleX;
+				const float* sampleY;
+				uint32_t samples;
+			};
+			static void coverSpanScalar(const Triangle& triangle, int32_t x, int32_t y, const SpanTarget& target, uint8_t* masks);
+
+		private:
+			static void coverSpanAvx2(const Triangle& triangle, int32_t x, int32_t y, const SpanTarget& target, uint8_t* masks);
+
+			struct ClipVertex {
+				glm::vec4 position;
+				glm::vec2 texCoord;
+			};
+
+			// One setup job's share of the triangles and the tiles each landed in
+			struct Batch {
+				std::vector<Triangle> triangles;
+				std::vector<std::vector<uint32_t>> bins; // Per tile, indices into triangles
+				size_t triangleBegin = 0;
+				size_t triangleEnd = 0;
+				size_t clipped = 0;
+				size_t culled = 0;
+				size_t binned = 0;
+			};
+
+			void transformVertices();
+			void setupBatch(Batch& batch);
+			void setupTriangle(Batch& batch, const ClipVertex* corners, uint32_t draw);
+			void rasterizeTile(uint32_t tile, std::atomic<size_t>& shaded);
+			uint32_t shade(const Triangle& triangle, int32_t x, int32_t y) const;
+
+			uint32_t width = 0;
+			uint32_t height = 0;
+			uint32_t samples = 1;
+			uint32_t stride = 0; // Pixels per row of the sample planes, a multiple of SPAN
+			uint32_t tilesX = 0;
+			uint32_t tilesY = 0;
+			uint32_t clearColor = 0xFF000000;
+			RasterCullMode cullMode = RasterCullMode::NONE;
+			bool simd = true;
+
+			std::vector<RasterDraw> draws;
+			std::vector<size_t> drawTriangles; // Prefix sums, first triangle of each draw
+			std::vector<size_t> drawVertices;  // Prefix sums into clipVertices
+			std::vector<glm::vec4> clipVertices;
+			std::vector<Batch> batches;
+
+			std::vector<float> depthSamples;
+			std::vector<uint32_t> colorSamples;
+			std::vector<uint8_t> image;
+
+			RasterStats stats{};
+	};
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <span>
+#include <string>
+
+#include "MappedFile.h"
+#include "TextureCooker.h"
+
+namespace Starry
+{
+	// On-disk layout of a cooked texture (.stex), little endian and written as it sits in memory:
+	//
+	//   TextureCacheHeader
+	//   TextureCacheMip[mipCount] right after the header
+	//   mip payloads back to back at dataOffset, each mip's offset relative to it
+	struct TextureCacheHeader {
+		char magic[4] = { 'S', 'T', 'E', 'X' };
+		uint32_t version = 0;
+		uint32_t format = 0;      // TextureFormat
+		uint32_t compression = 0; // TextureCompression it was cooked with, AUTO stays AUTO
+		uint32_t flags = 0;
+		uint32_t mipCount = 0;
+		uint32_t width = 0;
+		uint32_t height = 0;
+
+		uint64_t dataOffset = 0;
+		uint64_t dataSize = 0;
+
+		uint64_t sourceHash = 0;
+		uint64_t sourceSize = 0;
+	};
+
+	struct TextureCacheMip {
+		uint32_t width = 0;
+		uint32_t height = 0;
+		uint64_t offset = 0;
+		uint64_t size = 0;
+	};
+
+	class TextureCache {
+		public:
+			// Bump whenever the header, mip table or payload layout changes
+			const static uint32_t VERSION = 1;
+			const static size_t PAYLOAD_ALIGNMENT = 16;
+
+			const static uint32_t FLAG_MIPS = 1 << 0;
+
+			static uint32_t flagsFor(const TextureCookOptions& options) { return options.mips ? FLAG_MIPS : 0; }
+
+			// Writes through a temporary file and renames it into place, so a reader never maps a partial file
+			static bool write(const std::string& filePath, const CookedTexture& texture, const TextureCookOptions& options,
+				uint64_t sourceHash, uint64_t sourceSize);
+
+			// Default location for a source file's cache. An empty cache directory means next to the source.
+			static std::string cachePathFor(const std::string& sourcePath, const std::string& cacheDirectory, uint64_t sourceHash);
+
+			TextureCache() = default;
+			~TextureCache() = default;
+
+			// Maps the file and checks it was cooked from this source with these options. Mips and payload
+			// point into the mapping and stay valid until close() or destruction.
+			bool open(const std::string& filePath, uint64_t expectedSourceHash, uint64_t expectedSourceSize, const TextureCookOptions& options);
+			void close() { file.close(); header = {}; }
+
+			const TextureCacheHeader& getHeader() const { return header; }
+			TextureFormat getFormat() const { return static_cast<TextureFormat>(header.format); }
+			std::span<const TextureCacheMip> mips() const;
+			std::span<const uint8_t> mipData(size_t level) const;
+			// Every mip back to back, what gets uploaded in one go
+			std::span<const uint8_t> payload() const;
+
+		private:
+			MappedFile file;
+			TextureCacheHeader header{};
+	};
+}
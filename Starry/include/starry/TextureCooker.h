@@ -0,0 +1,109 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace Starry
+{
+	enum class TextureFormat : uint32_t
+	{
+		RGBA8 = 0,
+		BC1 = 1, // 4 bits per texel, opaque
+		BC3 = 2  // 8 bits per texel, BC1 color plus interpolated alpha
+	};
+
+	enum class TextureCompression : uint32_t
+	{
+		NONE,
+		BC1,
+		BC3,
+		AUTO // BC1 for opaque images, BC3 when any texel is translucent
+	};
+
+	struct TextureCookOptions {
+		TextureCompression compression = TextureCompression::AUTO;
+		bool mips = true;
+	};
+
+	// Decoded image, 8 bit RGBA with rows tightly packed
+	struct TextureImageData {
+		uint32_t width = 0;
+		uint32_t height = 0;
+		std::vector<uint8_t> pixels;
+	};
+
+	struct TextureMip {
+		uint32_t width = 0;
+		uint32_t height = 0;
+		uint64_t offset = 0; // Into CookedTexture::data
+		uint64_t size = 0;
+	};
+
+	// Full mip chain in its upload format, largest level first
+	struct CookedTexture {
+		TextureFormat format = TextureFormat::RGBA8;
+		uint32_t width = 0;
+		uint32_t height = 0;
+		std::vector<TextureMip> mips;
+		std::vector<uint8_t> data;
+	};
+
+	struct TextureCookStats {
+		size_t textures = 0;
+		size_t cacheHits = 0;
+		size_t sourceBytes = 0; // RGBA8 with the same mip chain
+		size_t cookedBytes = 0;
+	};
+
+	// Offline style texture processing done at load time: 2x2 box filtered mips and block compression,
+	// both split across the job system. Image files go through a decoder the application sets, the image
+	// libraries live with the renderer. SoftwareBackend sets ImageDecoder when nothing else is.
+	//
+	// Only SoftwareBackend uploads from cooked data so far. Render::TextureImage takes a file path and decodes
+	// it itself, so Vulkan textures see none of the savings until it accepts a prepared mip chain. BC7 and a
+	// Kaiser mip filter are not implemented, BC1/BC3 and the box filter are what runs at load time here.
+	class TextureCooker {
+		public:
+			using Decoder = std::function<bool(const char* data, size_t size, TextureImageData& image)>;
+
+			// Set once at startup, before any texture loads
+			static void setDecoder(Decoder function) { decoder = std::move(function); }
+			static bool hasDecoder() { return static_cast<bool>(decoder); }
+
+			static bool cook(const TextureImageData& image, const TextureCookOptions& options, CookedTexture& cooked);
+
+			// Cooks filePath through the .stex cache next to it, or in cacheDirectory when not empty. A
+			// valid cache is read back without decoding, cacheHit reports which way it went.
+			static bool cookFile(const std::string& filePath, const std::string& cacheDirectory, const TextureCookOptions& options,
+				CookedTexture& cooked, bool* cacheHit = nullptr);
+
+			// Next mip level, max(1, width / 2) by max(1, height / 2). SSE2 on x64, scalar elsewhere.
+			static void downsample(const uint8_t* source, uint32_t width, uint32_t height, uint8_t* destination);
+
+			// Whole images of 4x4 blocks, edge blocks repeat the last row and column
+			static void encodeBC1(const uint8_t* pixels, uint32_t width, uint32_t height, uint8_t* blocks);
+			static void encodeBC3(const uint8_t* pixels, uint32_t width, uint32_t height, uint8_t* blocks);
+
+			// Totals over every cookFile call so far
+			static TextureCookStats getStats();
+
+			static size_t levelSize(TextureFormat format, uint32_t width, uint32_t height);
+			static bool isOpaque(const TextureImageData& image);
+
+			// Block rows per job when encoding, output rows per job when filtering
+			constexpr static size_t PARALLEL_BLOCK_ROWS = 8;
+			constexpr static size_t PARALLEL_ROWS = 64;
+
+		private:
+			inline static Decoder decoder;
+
+			inline static std::atomic<size_t> cookedTextures{ 0 };
+			inline static std::atomic<size_t> cacheHits{ 0 };
+			inline static std::atomic<size_t> sourceBytes{ 0 };
+			inline static std::atomic<size_t> cookedBytes{ 0 };
+	};
+}
@@ -1,9 +1,12 @@
 #pragma once
 
+#include <atomic>
 #include <chrono>
 
 #include <StarryManager.h>
 
+#include "FrameTimeRecorder.h"
+
 namespace Starry
 {
 	class Timer : Manager::StarryAsset {
@@ -11,7 +14,8 @@ namespace Starry
 			uint64_t frameSamples = 0;
 			uint64_t totalTime = 0;
 			uint64_t timeSinceFlush = 0;
-			bool isHot = false;
+			// Read by getFPS from the UI thread, the counters above stay on the timing thread
+			std::atomic<bool> isHot{ false };
 			const static int NANOS_IN_SECOND = 1'000'000'000;
 
 			uint64_t framesPerSecond() {
@@ -31,15 +35,20 @@ namespace Starry
 			}
 
 			float getDeltaTimeSeconds() const {
-				return static_cast<float>(deltaTime) / static_cast<float>(FrameMetric::NANOS_IN_SECOND);
+				return static_cast<float>(deltaTime.load(std::memory_order_relaxed)) / static_cast<float>(FrameMetric::NANOS_IN_SECOND);
 			}
 
 			float getDeltaTimeMilliSeconds() const {
-				return static_cast<float>(deltaTime) / static_cast<float>(FrameMetric::NANOS_IN_SECOND/1000.0);
+				return static_cast<float>(deltaTime.load(std::memory_order_relaxed)) / static_cast<float>(FrameMetric::NANOS_IN_SECOND/1000.0);
 			}
 
+			// Average over the recent window, -1 before the first frame
 			int getFPS();
 
+			// Consistent copy of the frame statistics. Safe to call from any thread while the owning thread
+			// keeps timing, the writer never waits on readers.
+			FrameTimeStats getFrameStats() const { return frames.snapshot(); }
+
 			ASSET_NAME("Timer")
 		private:
 			void logFPS();
@@ -51,9 +60,11 @@ namespace Starry
 
 			bool toLog = false;
 			uint64_t currentTime = 0;
-			uint64_t deltaTime = 0;
+			std::atomic<uint64_t> deltaTime{ 0 };
 			FrameMetric frameMetric{};
 			std::chrono::time_point<std::chrono::high_resolution_clock> startTime;
+
+			FrameTimeRecorder frames;
 	};
 
-}
\ No newline at end of file
+}
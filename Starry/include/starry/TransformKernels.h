@@ -0,0 +1,27 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+
+namespace Starry
+{
+	// Batched 4x4 matrix products over contiguous arrays. The widest kernel the CPU supports is picked
+	// once at startup: AVX2 (when built with STARRY_ENABLE_AVX2), SSE2 on x64, NEON on arm64, scalar otherwise.
+	class TransformKernels {
+		public:
+			// output[i] = left * right[i], output may alias right
+			static void multiply(const glm::mat4& left, const glm::mat4* right, glm::mat4* output, size_t count);
+
+			// Reference path, also used for the tail of every batch
+			static void multiplyScalar(const glm::mat4& left, const glm::mat4* right, glm::mat4* output, size_t count);
+
+			static const char* activeKernel();
+
+			// True when AVX2 kernels were built and the CPU runs them, other AVX2 kernels share this check
+			static bool hasAvx2();
+
+		private:
+			static void multiplyAvx2(const glm::mat4& left, const glm::mat4* right, glm::mat4* output, size_t count);
+	};
+}
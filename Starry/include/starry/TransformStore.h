@@ -0,0 +1,126 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace Starry
+{
+	// Translation, rotation and scale relative to the parent
+	struct LocalTransform {
+		glm::vec3 translation{ 0.0f };
+		glm::quat rotation{ 1.0f, 0.0f, 0.0f, 0.0f };
+		glm::vec3 scale{ 1.0f };
+
+		glm::mat4 matrix() const;
+	};
+
+	// Structure of arrays storage for object transforms. Handles stay valid while the world matrix
+	// arrays stay densely packed, removal moves the last entry into the hole.
+	//
+	// Local transforms form a hierarchy. Changing one only flags it, world matrices are recomputed by
+	// updateWorldMatrices for the flagged subtrees and nothing else.
+	//
+	// Between beginConcurrentWrites and endConcurrentWrites, setLocal may be called from several threads
+	// at once for different handles and computeWorld only reads matrices no thread is writing. Everything
+	// else, including changes to the hierarchy, needs the store to itself.
+	class TransformStore {
+		public:
+			using Handle = uint32_t;
+			constexpr static Handle INVALID_HANDLE = ~0u;
+
+			TransformStore() = default;
+			~TransformStore() = default;
+
+			Handle create(const LocalTransform& local = {});
+			// Children are detached and keep their local transform
+			void destroy(Handle handle);
+
+			const LocalTransform& getLocal(Handle handle) const { return locals[handle]; }
+			void setLocal(Handle handle, const LocalTransform& local);
+
+			// INVALID_HANDLE detaches. Returns false when parent is the handle itself or one of its descendants.
+			bool setParent(Handle handle, Handle parent);
+			Handle getParent(Handle handle) const { return parents[handle]; }
+			template <typename Visit>
+			void forEachChild(Handle handle, Visit&& visit) const
+			{
+				for (Handle child = firstChildren[handle]; child != INVALID_HANDLE; child = nextSiblings[child]) visit(child);
+			}
+
+			// World matrix as of the last updateWorldMatrices, may be stale while the handle or an ancestor is flagged
+			const glm::mat4& world(Handle handle) const { return models[handleToDense[handle]]; }
+			// Current world matrix, composed on the spot when something above it changed. While writes are
+			// concurrent it is world(), changes made since the last updateWorldMatrices show up after it.
+			glm::mat4 computeWorld(Handle handle) const;
+
+			// Not thread safe themselves, call them around the parallel section
+			void beginConcurrentWrites() { concurrentWrites = true; }
+			void endConcurrentWrites() { concurrentWrites = false; }
+
+			// Recomputes the world matrix of every flagged subtree, parents before children, spreading the
+			// subtrees over the job system. changed(handle) is then called for each one on this thread.
+			// Returns how many were recomputed.
+			template <typename Changed>
+			size_t updateWorldMatrices(Changed&& changed);
+			size_t updateWorldMatrices() { return updateWorldMatrices([](Handle) {}); }
+
+			size_t size() const { return models.size(); }
+
+			// Below these the job fan-out costs more than it saves
+			constexpr static size_t PARALLEL_ROOTS = 256;
+			constexpr static size_t PARALLEL_MATRICES = 4096;
+			const glm::mat4* modelData() const { return models.data(); }
+
+		private:
+			struct UpdateBatch {
+				std::vector<Handle> stack;
+				std::vector<Handle> changed;
+			};
+
+			void markDirty(Handle handle);
+			bool hasDirtyAncestor(Handle handle) const;
+			void unlink(Handle handle);
+			size_t propagateDirty();
+			void updateSubtree(Handle root, UpdateBatch& batch);
+
+			// Dense, follow the packing
+			std::vector<glm::mat4> models;
+			std::vector<Handle> denseToHandle;
+
+			// Indexed by handle
+			std::vector<uint32_t> handleToDense;
+			std::vector<LocalTransform> locals;
+			std::vector<Handle> parents;
+			std::vector<Handle> firstChildren;
+			std::vector<Handle> nextSiblings;
+			std::vector<uint8_t> dirty;
+			// Ancestors' locals and flags may be mid write, computeWorld stays off them
+			bool concurrentWrites = false;
+
+			std::vector<Handle> freeHandles;
+
+			// One slot per handle, a handle is only ever listed once until the next update
+			std::vector<Handle> dirtyHandles;
+			std::atomic<size_t> dirtyCount{ 0 };
+
+			std::vector<Handle> roots;
+			std::vector<UpdateBatch> batches;
+	};
+
+	template <typename Changed>
+	size_t TransformStore::updateWorldMatrices(Changed&& changed)
+	{
+		size_t updated = propagateDirty();
+		for (const UpdateBatch& batch : batches) {
+			for (Handle handle : batch.changed) {
+				changed(handle);
+			}
+		}
+		return updated;
+	}
+}
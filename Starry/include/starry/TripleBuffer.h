@@ -0,0 +1,37 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace Starry
+{
+	// Lock free hand off of the latest value from one writer thread to one reader thread. The writer
+	// fills writeBuffer() and publishes it, the reader picks up whatever was published last. Neither
+	// side ever waits, values the reader never got to are dropped.
+	template <typename T>
+	class TripleBuffer {
+		public:
+			// Writer side
+			T& writeBuffer() { return slots[back]; }
+			void publish() { back = middle.exchange(back | FRESH, std::memory_order_acq_rel) & INDEX; }
+
+			// Reader side. Takes the newest published value, false when nothing was published since the last call.
+			bool acquire()
+			{
+				if (!(middle.load(std::memory_order_relaxed) & FRESH)) return false;
+				front = middle.exchange(front, std::memory_order_acq_rel) & INDEX;
+				return true;
+			}
+			const T& readBuffer() const { return slots[front]; }
+
+		private:
+			constexpr static uint8_t INDEX = 0x3;
+			constexpr static uint8_t FRESH = 0x4;
+
+			std::array<T, 3> slots{};
+			uint8_t back = 0;
+			std::atomic<uint8_t> middle{ 1 };
+			uint8_t front = 2;
+	};
+}
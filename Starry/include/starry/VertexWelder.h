@@ -0,0 +1,248 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "Parallel.h"
+
+namespace Starry
+{
+	// Collapses identical corners into a shared vertex list. Vertices are numbered in order of first
+	// appearance, so the output matches the old std::unordered_map based loop exactly.
+	//
+	// The table is open addressed with linear probing. Each slot packs a 32 bit hash next to the
+	// vertex index, so most mismatches are rejected without touching vertex memory and every
+	// corner costs one probe sequence.
+	template <typename Vertex, typename Hash = std::hash<Vertex>, typename Equal = std::equal_to<Vertex>>
+	class VertexWelder {
+		public:
+			VertexWelder() = default;
+			~VertexWelder() = default;
+
+			// Sizes the table so cornerCount unique corners fit without rehashing
+			void reserve(size_t cornerCount)
+			{
+				vertices.reserve(cornerCount);
+				size_t needed = tableSizeFor(cornerCount);
+				if (needed > slots.size()) rehash(needed);
+			}
+
+			void clear()
+			{
+				vertices.clear();
+				std::fill(slots.begin(), slots.end(), EMPTY_SLOT);
+			}
+
+			// Returns the index of the vertex, inserting it if it has not been seen before
+			uint32_t weld(const Vertex& vertex)
+			{
+				if ((vertices.size() + 1) * 10 > slots.size() * 7) {
+					rehash(tableSizeFor(std::max<size_t>(16, vertices.size() * 2)));
+				}
+
+				uint32_t hash = mixHash(hasher(vertex));
+				size_t mask = slots.size() - 1;
+				size_t slot = hash & mask;
+
+				while (true) {
+					uint64_t entry = slots[slot];
+					if (entry == EMPTY_SLOT) {
+						uint32_t index = static_cast<uint32_t>(vertices.size());
+						slots[slot] = packSlot(hash, index);
+						vertices.push_back(vertex);
+						return index;
+					}
+					if (slotHash(entry) == hash && equal(vertices[slotIndex(entry)], vertex)) {
+						return slotIndex(entry);
+					}
+					slot = (slot + 1) & mask;
+				}
+			}
+
+			std::vector<Vertex>& getVertices() { return vertices; }
+			const std::vector<Vertex>& getVertices() const { return vertices; }
+			size_t uniqueCount() const { return vertices.size(); }
+
+			// Welds a whole corner array at once, splitting the work across threads by hash shard.
+			// Produces the same vertices and indices as calling weld() on each corner in order.
+			static void weldParallel(const Vertex* corners, size_t cornerCount, std::vector<Vertex>& verticesOutput,
+				std::vector<uint32_t>& indicesOutput, size_t threads = 0)
+			{
+				if (threads == 0) threads = defaultThreadCount();
+
+				verticesOutput.clear();
+				indicesOutput.resize(cornerCount);
+				if (cornerCount == 0) return;
+
+				if (threads == 1 || cornerCount < PARALLEL_THRESHOLD) {
+					VertexWelder welder;
+					welder.reserve(cornerCount);
+					for (size_t i = 0; i < cornerCount; i++) {
+						indicesOutput[i] = welder.weld(corners[i]);
+					}
+					verticesOutput = std::move(welder.vertices);
+					return;
+				}
+
+				Hash hasher{};
+				Equal equal{};
+
+				size_t rangeCount = threads;
+				size_t shardCount = 1;
+				while (shardCount < threads * 4) shardCount <<= 1;
+
+				// 1. Hash every corner and bucket it by shard, keeping corner order inside each range
+				std::vector<uint32_t> hashes(cornerCount);
+				std::vector<std::vector<std::vector<uint32_t>>> buckets(rangeCount, std::vector<std::vector<uint32_t>>(shardCount));
+
+				runParallel(rangeCount, [&](size_t range) {
+					size_t begin = (cornerCount * range) / rangeCount;
+					size_t end = (cornerCount * (range + 1)) / rangeCount;
+					auto& rangeBuckets = buckets[range];
+					for (auto& bucket : rangeBuckets) {
+						bucket.reserve(((end - begin) / shardCount) * 2);
+					}
+
+					for (size_t i = begin; i < end; i++) {
+						uint32_t hash = mixHash(hasher(corners[i]));
+						hashes[i] = hash;
+						rangeBuckets[shardOf(hash, shardCount)].push_back(static_cast<uint32_t>(i));
+					}
+				});
+
+				// 2. Each shard finds the first corner equal to each of its corners. Visiting ranges in
+				//    order means that first corner is the earliest in the whole mesh.
+				std::vector<uint32_t> firstCorner(cornerCount);
+
+				runParallel(rangeCount, [&](size_t worker) {
+					std::vector<uint64_t> table;
+					for (size_t shard = worker; shard < shardCount; shard += rangeCount) {
+						size_t shardSize = 0;
+						for (size_t range = 0; range < rangeCount; range++) {
+							shardSize += buckets[range][shard].size();
+						}
+						if (shardSize == 0) continue;
+
+						table.assign(tableSizeFor(shardSize), EMPTY_SLOT);
+						size_t mask = table.size() - 1;
+
+						for (size_t range = 0; range < rangeCount; range++) {
+							for (uint32_t corner : buckets[range][shard]) {
+								uint32_t hash = hashes[corner];
+								// Low bits picked the shard, rotate them out of the slot index
+								size_t slot = ((hash >> 8) | (hash << 24)) & mask;
+
+								while (true) {
+									uint64_t entry = table[slot];
+									if (entry == EMPTY_SLOT) {
+										table[slot] = packSlot(hash, corner);
+										firstCorner[corner] = corner;
+										break;
+									}
+									if (slotHash(entry) == hash && equal(corners[slotIndex(entry)], corners[corner])) {
+										firstCorner[corner] = slotIndex(entry);
+										break;
+									}
+									slot = (slot + 1) & mask;
+								}
+							}
+						}
+					}
+				});
+
+				// 3. Number first occurrences with a prefix sum over ranges, then point repeats at them
+				std::vector<size_t> rangeOffsets(rangeCount + 1, 0);
+
+				runParallel(rangeCount, [&](size_t range) {
+					size_t begin = (cornerCount * range) / rangeCount;
+					size_t end = (cornerCount * (range + 1)) / rangeCount;
+					size_t count = 0;
+					for (size_t i = begin; i < end; i++) {
+						count += firstCorner[i] == i;
+					}
+					rangeOffsets[range + 1] = count;
+				});
+				for (size_t range = 0; range < rangeCount; range++) {
+					rangeOffsets[range + 1] += rangeOffsets[range];
+				}
+				verticesOutput.resize(rangeOffsets[rangeCount]);
+
+				runParallel(rangeCount, [&](size_t range) {
+					size_t begin = (cornerCount * range) / rangeCount;
+					size_t end = (cornerCount * (range + 1)) / rangeCount;
+					uint32_t next = static_cast<uint32_t>(rangeOffsets[range]);
+					for (size_t i = begin; i < end; i++) {
+						if (firstCorner[i] == i) {
+							verticesOutput[next] = corners[i];
+							indicesOutput[i] = next++;
+						}
+					}
+				});
+
+				runParallel(rangeCount, [&](size_t range) {
+					size_t begin = (cornerCount * range) / rangeCount;
+					size_t end = (cornerCount * (range + 1)) / rangeCount;
+					for (size_t i = begin; i < end; i++) {
+						if (firstCorner[i] != i) {
+							indicesOutput[i] = indicesOutput[firstCorner[i]];
+						}
+					}
+				});
+			}
+
+			// Below this many corners the thread fan-out costs more than it saves
+			constexpr static size_t PARALLEL_THRESHOLD = 1 << 18;
+
+		private:
+			constexpr static uint64_t EMPTY_SLOT = ~0ull;
+
+			static uint64_t packSlot(uint32_t hash, uint32_t index) { return (static_cast<uint64_t>(hash) << 32) | index; }
+			static uint32_t slotHash(uint64_t entry) { return static_cast<uint32_t>(entry >> 32); }
+			static uint32_t slotIndex(uint64_t entry) { return static_cast<uint32_t>(entry); }
+
+			static size_t shardOf(uint32_t hash, size_t shardCount) { return hash & (shardCount - 1); }
+
+			// Load factor stays under 0.7
+			static size_t tableSizeFor(size_t count)
+			{
+				size_t size = 16;
+				while (size * 7 < count * 10) size <<= 1;
+				return size;
+			}
+
+			// Finalizer from MurmurHash3, std::hash for vertices tends to cluster badly
+			static uint32_t mixHash(size_t value)
+			{
+				uint64_t h = static_cast<uint64_t>(value);
+				h ^= h >> 33;
+				h *= 0xff51afd7ed558ccdull;
+				h ^= h >> 33;
+				h *= 0xc4ceb9fe1a85ec53ull;
+				h ^= h >> 33;
+				return static_cast<uint32_t>(h);
+			}
+
+			void rehash(size_t size)
+			{
+				std::vector<uint64_t> resized(size, EMPTY_SLOT);
+				size_t mask = size - 1;
+				for (uint64_t entry : slots) {
+					if (entry == EMPTY_SLOT) continue;
+					size_t slot = slotHash(entry) & mask;
+					while (resized[slot] != EMPTY_SLOT) slot = (slot + 1) & mask;
+					resized[slot] = entry;
+				}
+				slots = std::move(resized);
+			}
+
+			std::vector<Vertex> vertices;
+			std::vector<uint64_t> slots;
+
+			Hash hasher{};
+			Equal equal{};
+	};
+}
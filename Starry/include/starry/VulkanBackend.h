@@ -0,0 +1,36 @@
+#pragma once
+
+#include "RenderBackend.h"
+
+namespace Starry
+{
+	// Hands everything to Render::RenderContext
+	class VulkanBackend : public RenderBackend {
+		public:
+			VulkanBackend(std::shared_ptr<Render::Window>& window, const RenderConfig& config);
+			~VulkanBackend() = default;
+
+			RenderBackendType getType() const override { return RenderBackendType::VULKAN; }
+
+			void Load(std::shared_ptr<Render::Canvas>& canvas) override { context.Load(canvas); }
+			void Load(std::shared_ptr<Render::Buffer>& buffer) override { context.Load(buffer); }
+			void Load(std::shared_ptr<Render::DescriptorSet>& descriptorSet) override { context.Load(descriptorSet); }
+			void Ready() override { context.Ready(); }
+			void Draw() override { context.Draw(); }
+			void WaitIdle() override { context.WaitIdle(); }
+			std::array<unsigned int, 2> getExtent() override { return context.getExtent(); }
+			bool getErrorState() override { return context.getErrorState(); }
+			bool isFatal() override { return context.getAlertSeverity() == FATAL; }
+
+			void loadBufferData(Render::Buffer& buffer, std::vector<Render::Vertex>& vertices, std::vector<uint32_t>& indices) override
+			{
+				buffer.loadData(vertices, indices);
+			}
+			void writeUniform(Render::Uniform& uniform, Render::UniformData& data) override { uniform.setData(data); }
+			void storeTexture(Render::TextureImage& texture, const std::string& filePath) override { texture.storeFilePath(filePath); }
+
+		private:
+			Render::RenderConfig config;
+			Render::RenderContext context{};
+	};
+}
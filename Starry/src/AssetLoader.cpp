@@ -0,0 +1,82 @@
+#include "AssetLoader.h"
+
+#include "AsyncLog.h"
+#include "JobSystem.h"
+#include "Profiler.h"
+
+#include <algorithm>
+
+namespace Starry
+{
+	AssetLoader& AssetLoader::get()
+	{
+		// Statics are destroyed in reverse order of construction. Loads run on the job system and log through
+		// AsyncLog, so both have to exist first to outlive the loader threads, which drain the queue on exit.
+		JobSystem::get();
+		AsyncLog::get();
+		static AssetLoader loader(DEFAULT_THREADS);
+		return loader;
+	}
+
+	AssetLoader::AssetLoader(size_t threadCount)
+	{
+		threadCount = std::max<size_t>(threadCount, 1);
+		for (size_t i = 0; i < threadCount; i++) {
+			threads.emplace_back(&AssetLoader::workerLoop, this);
+		}
+	}
+
+	AssetLoader::~AssetLoader()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			running = false;
+		}
+		wake.notify_all();
+		for (auto& thread : threads) {
+			thread.join();
+		}
+	}
+
+	void AssetLoader::submit(std::function<void()> load)
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			queue.push_back(std::move(load));
+			pending.fetch_add(1, std::memory_order_relaxed);
+		}
+		wake.notify_one();
+	}
+
+	void AssetLoader::waitIdle()
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		idle.wait(lock, [&]() { return pending.load(std::memory_order_relaxed) == 0; });
+	}
+
+	void AssetLoader::workerLoop()
+	{
+		STARRY_PROFILE_THREAD("Asset Loader");
+		while (true) {
+			std::function<void()> load;
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				// Queued loads still run on shutdown, whoever submitted them may be waiting on the result
+				wake.wait(lock, [&]() { return !running || !queue.empty(); });
+				if (queue.empty()) return;
+				load = std::move(queue.front());
+				queue.pop_front();
+			}
+
+			{
+				STARRY_PROFILE_SCOPE("Asset Load");
+				load();
+			}
+
+			std::lock_guard<std::mutex> lock(mutex);
+			if (pending.fetch_sub(1, std::memory_order_relaxed) == 1) {
+				idle.notify_all();
+			}
+		}
+	}
+}
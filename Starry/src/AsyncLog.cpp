@@ -0,0 +1,167 @@
+#include "AsyncLog.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+
+namespace Starry
+{
+	namespace
+	{
+		const char* levelName(LogLevel level)
+		{
+			switch (level) {
+				case LogLevel::WARNING: return "WARNING";
+				case LogLevel::CRITICAL: return "CRITICAL";
+				default: return "INFO";
+			}
+		}
+	}
+
+	AsyncLog& AsyncLog::get()
+	{
+		static AsyncLog log;
+		return log;
+	}
+
+	AsyncLog::AsyncLog() : slots(new Slot[CAPACITY]), startTime(std::chrono::steady_clock::now())
+	{
+		static_assert((CAPACITY & (CAPACITY - 1)) == 0, "Ring positions wrap with a mask");
+		for (size_t i = 0; i < CAPACITY; i++) {
+			slots[i].sequence.store(i, std::memory_order_relaxed);
+		}
+		writer = std::thread(&AsyncLog::writerLoop, this);
+	}
+
+	AsyncLog::~AsyncLog()
+	{
+		{
+			std::lock_guard<std::mutex> lock(wakeMutex);
+			running.store(false);
+		}
+		wakeWriter.notify_one();
+		writer.join();
+
+		if (file != nullptr) std::fclose(file);
+	}
+
+	bool AsyncLog::post(LogLevel level, std::string_view text)
+	{
+		uint64_t position = head.load(std::memory_order_relaxed);
+		Slot* slot;
+		while (true) {
+			slot = &slots[position & (CAPACITY - 1)];
+			uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+			int64_t lag = static_cast<int64_t>(sequence - position);
+			if (lag == 0) {
+				if (head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) break;
+			}
+			else if (lag < 0) {
+				// The writer has not freed this slot since the last lap
+				dropped.fetch_add(1, std::memory_order_relaxed);
+				return false;
+			}
+			else {
+				position = head.load(std::memory_order_relaxed);
+			}
+		}
+
+		slot->postedNanos = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now() - startTime).count());
+		slot->level = level;
+		slot->length = static_cast<uint32_t>(std::min(text.size(), MESSAGE_BYTES));
+		std::memcpy(slot->text, text.data(), slot->length);
+		slot->sequence.store(position + 1, std::memory_order_release);
+
+		// No lock, a wake up lost to the race is picked up by the writer's timeout
+		wakeWriter.notify_one();
+		return true;
+	}
+
+	bool AsyncLog::setLogFile(const std::string& filePath)
+	{
+		std::FILE* opened = nullptr;
+		if (!filePath.empty()) {
+			std::error_code error;
+			std::filesystem::path parent = std::filesystem::path(filePath).parent_path();
+			if (!parent.empty()) std::filesystem::create_directories(parent, error);
+			opened = std::fopen(filePath.c_str(), "a");
+			if (opened == nullptr) return false;
+		}
+
+		std::lock_guard<std::mutex> lock(fileMutex);
+		if (file != nullptr) std::fclose(file);
+		file = opened;
+		return true;
+	}
+
+	void AsyncLog::flush()
+	{
+		uint64_t target = head.load(std::memory_order_acquire);
+		std::unique_lock<std::mutex> lock(wakeMutex);
+		wakeWriter.notify_one();
+		flushed.wait(lock, [&]() { return written.load(std::memory_order_acquire) >= target || !running.load(); });
+	}
+
+	void AsyncLog::writerLoop()
+	{
+		while (true) {
+			bool wrote = drain();
+			{
+				std::lock_guard<std::mutex> lock(wakeMutex);
+				flushed.notify_all();
+			}
+			if (wrote) continue;
+
+			std::unique_lock<std::mutex> lock(wakeMutex);
+			if (!running.load()) break;
+			wakeWriter.wait_for(lock, DRAIN_INTERVAL, [this]() { return !running.load() || hasPending(); });
+		}
+		// Lines posted while shutting down
+		drain();
+	}
+
+	bool AsyncLog::hasPending() const
+	{
+		uint64_t tail = written.load(std::memory_order_relaxed);
+		return slots[tail & (CAPACITY - 1)].sequence.load(std::memory_order_acquire) == tail + 1;
+	}
+
+	bool AsyncLog::drain()
+	{
+		uint64_t tail = written.load(std::memory_order_relaxed);
+		uint64_t start = tail;
+		std::lock_guard<std::mutex> lock(fileMutex);
+		while (true) {
+			Slot& slot = slots[tail & (CAPACITY - 1)];
+			if (slot.sequence.load(std::memory_order_acquire) != tail + 1) break;
+
+			write(slot);
+			slot.sequence.store(tail + CAPACITY, std::memory_order_release);
+			tail++;
+			written.store(tail, std::memory_order_release);
+		}
+
+		uint64_t droppedNow = dropped.load(std::memory_order_relaxed);
+		if (droppedNow != reportedDropped) {
+			std::fprintf(stderr, "[AsyncLog] %llu lines dropped, the log fell behind\n", static_cast<unsigned long long>(droppedNow - reportedDropped));
+			reportedDropped = droppedNow;
+		}
+
+		if (tail == start) return false;
+		std::fflush(stdout);
+		if (file != nullptr) std::fflush(file);
+		return true;
+	}
+
+	void AsyncLog::write(const Slot& slot)
+	{
+		double seconds = static_cast<double>(slot.postedNanos) / 1e9;
+		int length = static_cast<int>(slot.length);
+		std::FILE* console = slot.level == LogLevel::INFO ? stdout : stderr;
+		std::fprintf(console, "[%10.3f] %s: %.*s\n", seconds, levelName(slot.level), length, slot.text);
+		if (file != nullptr) {
+			std::fprintf(file, "[%10.3f] %s: %.*s\n", seconds, levelName(slot.level), length, slot.text);
+		}
+	}
+}
@@ -3,6 +3,8 @@
 #include <glm/ext/matrix_clip_space.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
+#include <cmath>
+
 namespace Starry
 {
 	CameraObject::CameraObject(std::string name) : SceneObject(SceneObject::Type::CAMERA, std::string("Camera, ") + name)
@@ -31,6 +33,30 @@ namespace Starry
 		//calculateProjectionMatrix();
 	}
 
+	bool CameraObject::saveRecord(SceneObjectRecord& record, SceneFileWriter& writer) const
+	{
+		record.fov = FOV;
+		record.nearPlane = nearPlane;
+		record.farPlane = farPlane;
+		return true;
+	}
+
+	void CameraObject::loadRecord(const SceneObjectRecord& record, const SceneFile& file)
+	{
+		FOV = record.fov;
+		setClippingPlanes(record.nearPlane, record.farPlane);
+	}
+
+	ViewParameters CameraObject::getViewParameters() const
+	{
+		ViewParameters view{};
+		view.cameraPosition = glm::vec3(glm::inverse(mvpBufferData.view)[3]);
+		view.projectionScale = static_cast<float>(dimensions[1]) / (2.0f * std::tan(glm::radians(FOV) * 0.5f));
+		view.nearPlane = nearPlane;
+		view.viewProjection = mvpBufferData.proj * mvpBufferData.view;
+		return view;
+	}
+
 	void CameraObject::calculateProjectionMatrix()
 	{
 		float aspectRatio = static_cast<float>(dimensions[0]) / static_cast<float>(dimensions[1]);
@@ -0,0 +1,239 @@
+#include "CompactVertex.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace Starry
+{
+	namespace
+	{
+		inline const float* strided(const float* base, size_t stride, size_t index)
+		{
+			return reinterpret_cast<const float*>(reinterpret_cast<const char*>(base) + index * stride);
+		}
+
+		inline int16_t toSnorm16(float value)
+		{
+			value = std::clamp(value, -1.0f, 1.0f);
+			return static_cast<int16_t>(std::lround(value * 32767.0f));
+		}
+
+		inline float fromSnorm16(int16_t value)
+		{
+			return std::max(static_cast<float>(value) / 32767.0f, -1.0f);
+		}
+
+		inline uint32_t packColor(const float* color)
+		{
+			uint32_t packed = 0;
+			for (int i = 0; i < 3; i++) {
+				uint32_t channel = static_cast<uint32_t>(std::lround(std::clamp(color[i], 0.0f, 1.0f) * 255.0f));
+				packed |= channel << (i * 8);
+			}
+			return packed | (0xFFu << 24);
+		}
+	}
+
+	void VertexCompression::encode(CompactMesh& output, size_t vertexCount,
+		const float* positions, size_t positionStride,
+		const float* normals, size_t normalStride,
+		const float* texCoords, size_t texCoordStride,
+		const float* colors, size_t colorStride,
+		const std::vector<uint32_t>& indices)
+	{
+		output = {};
+		output.vertices.resize(vertexCount);
+
+		if (vertexCount > 0) {
+			float boundsMin[3];
+			float boundsMax[3];
+			std::memcpy(boundsMin, positions, sizeof(boundsMin));
+			std::memcpy(boundsMax, positions, sizeof(boundsMax));
+			for (size_t v = 1; v < vertexCount; v++) {
+				const float* position = strided(positions, positionStride, v);
+				for (int i = 0; i < 3; i++) {
+					boundsMin[i] = std::min(boundsMin[i], position[i]);
+					boundsMax[i] = std::max(boundsMax[i], position[i]);
+				}
+			}
+			for (int i = 0; i < 3; i++) {
+				output.decode.positionOffset[i] = boundsMin[i];
+				output.decode.positionScale[i] = boundsMax[i] - boundsMin[i];
+			}
+		}
+
+		for (size_t v = 0; v < vertexCount; v++) {
+			CompactVertex& vertex = output.vertices[v];
+
+			const float* position = strided(positions, positionStride, v);
+			for (int i = 0; i < 3; i++) {
+				float extent = output.decode.positionScale[i];
+				float unit = extent > 0.0f ? (position[i] - output.decode.positionOffset[i]) / extent : 0.0f;
+				vertex.position[i] = static_cast<uint16_t>(std::lround(std::clamp(unit, 0.0f, 1.0f) * 65535.0f));
+			}
+			vertex.position[3] = 0;
+
+			encodeOctahedral(strided(normals, normalStride, v), vertex.normal);
+
+			const float* texCoord = strided(texCoords, texCoordStride, v);
+			vertex.texCoord[0] = floatToHalf(texCoord[0]);
+			vertex.texCoord[1] = floatToHalf(texCoord[1]);
+		}
+
+		// Keep the color stream only if it carries information
+		if (colors != nullptr && vertexCount > 0) {
+			uint32_t first = packColor(colors);
+			bool constant = true;
+			for (size_t v = 1; v < vertexCount && constant; v++) {
+				constant = packColor(strided(colors, colorStride, v)) == first;
+			}
+
+			if (constant) {
+				for (int i = 0; i < 3; i++) {
+					output.decode.color[i] = colors[i];
+				}
+			}
+			else {
+				output.colors.resize(vertexCount);
+				for (size_t v = 0; v < vertexCount; v++) {
+					output.colors[v] = packColor(strided(colors, colorStride, v));
+				}
+			}
+		}
+
+		if (vertexCount <= MAX_SHORT_INDEX_VERTICES) {
+			output.indices16.assign(indices.begin(), indices.end());
+		}
+		else {
+			output.indices32 = indices;
+		}
+	}
+
+	void VertexCompression::decodePosition(const CompactMesh& mesh, const CompactVertex& vertex, float position[3])
+	{
+		for (int i = 0; i < 3; i++) {
+			float unit = static_cast<float>(vertex.position[i]) / 65535.0f;
+			position[i] = mesh.decode.positionOffset[i] + unit * mesh.decode.positionScale[i];
+		}
+	}
+
+	void VertexCompression::decodeNormal(const CompactVertex& vertex, float normal[3])
+	{
+		decodeOctahedral(vertex.normal, normal);
+	}
+
+	void VertexCompression::decodeTexCoord(const CompactVertex& vertex, float texCoord[2])
+	{
+		texCoord[0] = halfToFloat(vertex.texCoord[0]);
+		texCoord[1] = halfToFloat(vertex.texCoord[1]);
+	}
+
+	void VertexCompression::encodeOctahedral(const float normal[3], int16_t encoded[2])
+	{
+		float sum = std::fabs(normal[0]) + std::fabs(normal[1]) + std::fabs(normal[2]);
+		if (sum <= 0.0f) {
+			encoded[0] = 0;
+			encoded[1] = 0;
+			return;
+		}
+
+		float x = normal[0] / sum;
+		float y = normal[1] / sum;
+		if (normal[2] < 0.0f) {
+			float foldedX = (1.0f - std::fabs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+			float foldedY = (1.0f - std::fabs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+			x = foldedX;
+			y = foldedY;
+		}
+		encoded[0] = toSnorm16(x);
+		encoded[1] = toSnorm16(y);
+	}
+
+	void VertexCompression::decodeOctahedral(const int16_t encoded[2], float normal[3])
+	{
+		float x = fromSnorm16(encoded[0]);
+		float y = fromSnorm16(encoded[1]);
+		float z = 1.0f - std::fabs(x) - std::fabs(y);
+
+		float t = std::max(-z, 0.0f);
+		x += x >= 0.0f ? -t : t;
+		y += y >= 0.0f ? -t : t;
+
+		float length = std::sqrt(x * x + y * y + z * z);
+		if (length <= 0.0f) length = 1.0f;
+		normal[0] = x / length;
+		normal[1] = y / length;
+		normal[2] = z / length;
+	}
+
+	// IEEE 754 binary16, round to nearest even, overflow goes to infinity
+	uint16_t VertexCompression::floatToHalf(float value)
+	{
+		uint32_t bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+
+		uint32_t sign = (bits >> 16) & 0x8000u;
+		uint32_t exponent = (bits >> 23) & 0xFFu;
+		uint32_t mantissa = bits & 0x7FFFFFu;
+
+		if (exponent == 0xFFu) {
+			return static_cast<uint16_t>(sign | 0x7C00u | (mantissa ? 0x200u : 0u));
+		}
+
+		int32_t halfExponent = static_cast<int32_t>(exponent) - 127 + 15;
+		if (halfExponent >= 31) {
+			return static_cast<uint16_t>(sign | 0x7C00u);
+		}
+		if (halfExponent <= 0) {
+			if (halfExponent < -10) return static_cast<uint16_t>(sign);
+
+			mantissa |= 0x800000u;
+			uint32_t shift = static_cast<uint32_t>(14 - halfExponent);
+			uint32_t halfMantissa = mantissa >> shift;
+			uint32_t remainder = mantissa & ((1u << shift) - 1);
+			uint32_t halfway = 1u << (shift - 1);
+			if (remainder > halfway || (remainder == halfway && (halfMantissa & 1u))) halfMantissa++;
+			return static_cast<uint16_t>(sign | halfMantissa);
+		}
+
+		uint32_t half = sign | (static_cast<uint32_t>(halfExponent) << 10) | (mantissa >> 13);
+		uint32_t remainder = mantissa & 0x1FFFu;
+		if (remainder > 0x1000u || (remainder == 0x1000u && (half & 1u))) half++;
+		return static_cast<uint16_t>(half);
+	}
+
+	float VertexCompression::halfToFloat(uint16_t value)
+	{
+		uint32_t sign = static_cast<uint32_t>(value & 0x8000u) << 16;
+		uint32_t exponent = (value >> 10) & 0x1Fu;
+		uint32_t mantissa = value & 0x3FFu;
+
+		uint32_t bits;
+		if (exponent == 0) {
+			if (mantissa == 0) {
+				bits = sign;
+			}
+			else {
+				// Subnormal, renormalize
+				int32_t shift = 0;
+				while ((mantissa & 0x400u) == 0) {
+					mantissa <<= 1;
+					shift++;
+				}
+				mantissa &= 0x3FFu;
+				bits = sign | (static_cast<uint32_t>(127 - 15 + 1 - shift) << 23) | (mantissa << 13);
+			}
+		}
+		else if (exponent == 31) {
+			bits = sign | 0x7F800000u | (mantissa << 13);
+		}
+		else {
+			bits = sign | ((exponent - 15 + 127) << 23) | (mantissa << 13);
+		}
+
+		float result;
+		std::memcpy(&result, &bits, sizeof(result));
+		return result;
+	}
+}
@@ -0,0 +1,92 @@
+#include "ContentHash.h"
+
+#include "MappedFile.h"
+
+#include <cstring>
+
+namespace Starry
+{
+	namespace
+	{
+		const uint64_t PRIME_1 = 0x9E3779B185EBCA87ull;
+		const uint64_t PRIME_2 = 0xC2B2AE3D27D4EB4Full;
+		const uint64_t PRIME_3 = 0x165667B19E3779F9ull;
+
+		inline uint64_t rotl(uint64_t value, int bits) { return (value << bits) | (value >> (64 - bits)); }
+
+		inline uint64_t read64(const unsigned char* p)
+		{
+			uint64_t value;
+			std::memcpy(&value, p, sizeof(value));
+			return value;
+		}
+
+		inline uint64_t round(uint64_t accumulator, uint64_t lane)
+		{
+			accumulator += lane * PRIME_2;
+			accumulator = rotl(accumulator, 31);
+			return accumulator * PRIME_1;
+		}
+
+		inline uint64_t avalanche(uint64_t h)
+		{
+			h ^= h >> 33;
+			h *= PRIME_2;
+			h ^= h >> 29;
+			h *= PRIME_3;
+			h ^= h >> 32;
+			return h;
+		}
+	}
+
+	uint64_t hashBytes(const void* data, size_t size, uint64_t seed)
+	{
+		const unsigned char* p = static_cast<const unsigned char*>(data);
+		const unsigned char* end = p + size;
+
+		// Four independent lanes keep the multiplies pipelined on large inputs
+		uint64_t lanes[4] = { seed + PRIME_1 + PRIME_2, seed + PRIME_2, seed, seed - PRIME_1 };
+		while (end - p >= 32) {
+			lanes[0] = round(lanes[0], read64(p + 0));
+			lanes[1] = round(lanes[1], read64(p + 8));
+			lanes[2] = round(lanes[2], read64(p + 16));
+			lanes[3] = round(lanes[3], read64(p + 24));
+			p += 32;
+		}
+
+		uint64_t h = rotl(lanes[0], 1) + rotl(lanes[1], 7) + rotl(lanes[2], 12) + rotl(lanes[3], 18);
+		h += static_cast<uint64_t>(size);
+
+		while (end - p >= 8) {
+			h ^= round(0, read64(p));
+			h = rotl(h, 27) * PRIME_1 + PRIME_3;
+			p += 8;
+		}
+		while (p < end) {
+			h ^= static_cast<uint64_t>(*p) * PRIME_3;
+			h = rotl(h, 11) * PRIME_1;
+			p++;
+		}
+		return avalanche(h);
+	}
+
+	bool hashFile(const std::string& filePath, uint64_t& hash)
+	{
+		MappedFile file;
+		if (!file.open(filePath)) return false;
+
+		hash = hashBytes(file.data(), file.size());
+		return true;
+	}
+
+	std::string hashToString(uint64_t hash)
+	{
+		const char* digits = "0123456789abcdef";
+		std::string text(16, '0');
+		for (int i = 15; i >= 0; i--) {
+			text[i] = digits[hash & 0xF];
+			hash >>= 4;
+		}
+		return text;
+	}
+}
@@ -0,0 +1,234 @@
+#include "DynamicAabbTree.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace Starry
+{
+	Aabb DynamicAabbTree::fatten(const Aabb& bounds)
+	{
+		glm::vec3 size = bounds.extent();
+		float margin = std::max({ size.x, size.y, size.z }) * FAT_MARGIN_RATIO;
+		return bounds.expanded(std::max(margin, 1e-4f));
+	}
+
+	void DynamicAabbTree::clear()
+	{
+		nodes.clear();
+		root = NULL_NODE;
+		freeList = NULL_NODE;
+		proxies = 0;
+	}
+
+	int32_t DynamicAabbTree::allocateNode()
+	{
+		if (freeList == NULL_NODE) {
+			nodes.emplace_back();
+			return static_cast<int32_t>(nodes.size() - 1);
+		}
+		int32_t index = freeList;
+		freeList = nodes[index].parent;
+		nodes[index] = Node{};
+		return index;
+	}
+
+	void DynamicAabbTree::freeNode(int32_t index)
+	{
+		nodes[index].parent = freeList;
+		nodes[index].height = -1;
+		nodes[index].userData = nullptr;
+		freeList = index;
+	}
+
+	int32_t DynamicAabbTree::createProxy(const Aabb& bounds, void* userData)
+	{
+		int32_t proxy = allocateNode();
+		nodes[proxy].bounds = fatten(bounds);
+		nodes[proxy].userData = userData;
+		nodes[proxy].height = 0;
+
+		insertLeaf(proxy);
+		proxies++;
+		return proxy;
+	}
+
+	void DynamicAabbTree::destroyProxy(int32_t proxy)
+	{
+		removeLeaf(proxy);
+		freeNode(proxy);
+		proxies--;
+	}
+
+	bool DynamicAabbTree::moveProxy(int32_t proxy, const Aabb& bounds, const glm::vec3& displacement)
+	{
+		if (nodes[proxy].bounds.contains(bounds)) return false;
+
+		Aabb fat = fatten(bounds);
+		glm::vec3 ahead = displacement * DISPLACEMENT_MULTIPLIER;
+		fat.min += glm::min(ahead, glm::vec3(0.0f));
+		fat.max += glm::max(ahead, glm::vec3(0.0f));
+
+		removeLeaf(proxy);
+		nodes[proxy].bounds = fat;
+		insertLeaf(proxy);
+		return true;
+	}
+
+	void DynamicAabbTree::insertLeaf(int32_t leaf)
+	{
+		if (root == NULL_NODE) {
+			root = leaf;
+			nodes[root].parent = NULL_NODE;
+			return;
+		}
+
+		// Walk down to the sibling with the lowest surface area cost
+		Aabb leafBounds = nodes[leaf].bounds;
+		int32_t index = root;
+		while (!nodes[index].isLeaf()) {
+			const Node& node = nodes[index];
+			float area = node.bounds.surfaceArea();
+			float combinedArea = Aabb::merge(node.bounds, leafBounds).surfaceArea();
+
+			// Making a new parent here, or pushing the leaf further down
+			float cost = 2.0f * combinedArea;
+			float inheritanceCost = 2.0f * (combinedArea - area);
+
+			auto descendCost = [&](int32_t child) {
+				const Node& childNode = nodes[child];
+				float merged = Aabb::merge(leafBounds, childNode.bounds).surfaceArea();
+				if (childNode.isLeaf()) return merged + inheritanceCost;
+				return merged - childNode.bounds.surfaceArea() + inheritanceCost;
+			};
+			float cost1 = descendCost(node.child1);
+			float cost2 = descendCost(node.child2);
+
+			if (cost < cost1 && cost < cost2) break;
+			index = cost1 < cost2 ? node.child1 : node.child2;
+		}
+
+		int32_t sibling = index;
+		int32_t oldParent = nodes[sibling].parent;
+		int32_t newParent = allocateNode();
+		nodes[newParent].parent = oldParent;
+		nodes[newParent].bounds = Aabb::merge(leafBounds, nodes[sibling].bounds);
+		nodes[newParent].height = nodes[sibling].height + 1;
+		nodes[newParent].child1 = sibling;
+		nodes[newParent].child2 = leaf;
+		nodes[sibling].parent = newParent;
+		nodes[leaf].parent = newParent;
+
+		if (oldParent == NULL_NODE) {
+			root = newParent;
+		}
+		else if (nodes[oldParent].child1 == sibling) {
+			nodes[oldParent].child1 = newParent;
+		}
+		else {
+			nodes[oldParent].child2 = newParent;
+		}
+
+		refitAncestors(nodes[leaf].parent);
+	}
+
+	void DynamicAabbTree::removeLeaf(int32_t leaf)
+	{
+		if (leaf == root) {
+			root = NULL_NODE;
+			return;
+		}
+
+		int32_t parent = nodes[leaf].parent;
+		int32_t grandParent = nodes[parent].parent;
+		int32_t sibling = nodes[parent].child1 == leaf ? nodes[parent].child2 : nodes[parent].child1;
+
+		if (grandParent == NULL_NODE) {
+			root = sibling;
+			nodes[sibling].parent = NULL_NODE;
+			freeNode(parent);
+			return;
+		}
+
+		// The sibling takes the parent's place
+		if (nodes[grandParent].child1 == parent) {
+			nodes[grandParent].child1 = sibling;
+		}
+		else {
+			nodes[grandParent].child2 = sibling;
+		}
+		nodes[sibling].parent = grandParent;
+		freeNode(parent);
+
+		refitAncestors(grandParent);
+	}
+
+	void DynamicAabbTree::refitAncestors(int32_t index)
+	{
+		while (index != NULL_NODE) {
+			index = balance(index);
+
+			Node& node = nodes[index];
+			node.bounds = Aabb::merge(nodes[node.child1].bounds, nodes[node.child2].bounds);
+			node.height = 1 + std::max(nodes[node.child1].height, nodes[node.child2].height);
+
+			index = node.parent;
+		}
+	}
+
+	// Rotates the taller grandchild up when the subtree at a leans by more than one level.
+	// Returns the node now at a's position.
+	int32_t DynamicAabbTree::balance(int32_t a)
+	{
+		Node& nodeA = nodes[a];
+		if (nodeA.isLeaf() || nodeA.height < 2) return a;
+
+		int32_t b = nodeA.child1;
+		int32_t c = nodeA.child2;
+		int32_t lean = nodes[c].height - nodes[b].height;
+
+		if (lean > 1) return rotateUp(a, c, b);
+		if (lean < -1) return rotateUp(a, b, c);
+		return a;
+	}
+
+	// Moves child up into a's place. a keeps other and the shorter of child's children.
+	int32_t DynamicAabbTree::rotateUp(int32_t a, int32_t child, int32_t other)
+	{
+		int32_t f = nodes[child].child1;
+		int32_t g = nodes[child].child2;
+
+		nodes[child].child1 = a;
+		nodes[child].parent = nodes[a].parent;
+		nodes[a].parent = child;
+
+		int32_t parent = nodes[child].parent;
+		if (parent == NULL_NODE) {
+			root = child;
+		}
+		else if (nodes[parent].child1 == a) {
+			nodes[parent].child1 = child;
+		}
+		else {
+			nodes[parent].child2 = child;
+		}
+
+		if (nodes[f].height < nodes[g].height) std::swap(f, g);
+
+		// f is the taller one and stays under child, g goes down to a
+		nodes[child].child2 = f;
+		if (nodes[a].child1 == child) {
+			nodes[a].child1 = g;
+		}
+		else {
+			nodes[a].child2 = g;
+		}
+		nodes[g].parent = a;
+
+		nodes[a].bounds = Aabb::merge(nodes[other].bounds, nodes[g].bounds);
+		nodes[a].height = 1 + std::max(nodes[other].height, nodes[g].height);
+		nodes[child].bounds = Aabb::merge(nodes[a].bounds, nodes[f].bounds);
+		nodes[child].height = 1 + std::max(nodes[a].height, nodes[f].height);
+
+		return child;
+	}
+}
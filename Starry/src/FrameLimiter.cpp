@@ -0,0 +1,60 @@
+#include "FrameLimiter.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace Starry
+{
+	void FrameLimiter::setTargetRate(double framesPerSecond)
+	{
+		int64_t period = framesPerSecond > 0.0 ? static_cast<int64_t>(1e9 / framesPerSecond) : 0;
+		periodNanos.store(period, std::memory_order_relaxed);
+	}
+
+	double FrameLimiter::getTargetRate() const
+	{
+		int64_t period = periodNanos.load(std::memory_order_relaxed);
+		return period > 0 ? 1e9 / static_cast<double>(period) : 0.0;
+	}
+
+	void FrameLimiter::wait()
+	{
+		std::chrono::nanoseconds period(periodNanos.load(std::memory_order_relaxed));
+		if (period.count() <= 0) {
+			nextFrame = Clock::time_point{};
+			lastLateness = std::chrono::nanoseconds(0);
+			return;
+		}
+
+		Clock::time_point now = Clock::now();
+		if (nextFrame == Clock::time_point{} || now - nextFrame > period) {
+			// First frame or too far behind, start a new schedule
+			nextFrame = now + period;
+			lastLateness = std::chrono::nanoseconds(0);
+			return;
+		}
+
+		Clock::time_point wake = nextFrame - spinMargin;
+		if (now < wake) {
+			std::this_thread::sleep_until(wake);
+
+			// Woke past the point the spin should have covered, widen the margin to the miss plus some slack
+			Clock::time_point woke = Clock::now();
+			if (woke > wake) {
+				std::chrono::nanoseconds oversleep = woke - wake;
+				if (oversleep > spinMargin) {
+					spinMargin = std::min(oversleep + oversleep / 4, MAX_SPIN_MARGIN);
+				}
+				else {
+					spinMargin = std::max(spinMargin - spinMargin / 16, MIN_SPIN_MARGIN);
+				}
+			}
+		}
+		while (Clock::now() < nextFrame) {
+			std::this_thread::yield();
+		}
+
+		lastLateness = Clock::now() - nextFrame;
+		nextFrame += period;
+	}
+}
@@ -0,0 +1,125 @@
+#include "FrameTimeRecorder.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace Starry
+{
+	namespace
+	{
+		constexpr double FIRST_BUCKET_NANOS = 250'000.0; // 0.25 ms
+		constexpr double BUCKETS_PER_DOUBLING = 4.0;
+		// Weight of the newest frame in the running average hitches are measured against
+		constexpr double AVERAGE_WEIGHT = 1.0 / 32.0;
+
+		size_t bucketFor(uint64_t nanos)
+		{
+			if (nanos < FIRST_BUCKET_NANOS) return 0;
+			double bucket = std::log2(static_cast<double>(nanos) / FIRST_BUCKET_NANOS) * BUCKETS_PER_DOUBLING + 1.0;
+			return std::min(static_cast<size_t>(bucket), FrameTimeStats::HISTOGRAM_BUCKETS - 1);
+		}
+
+		float toMilliseconds(uint64_t nanos)
+		{
+			return static_cast<float>(static_cast<double>(nanos) / 1'000'000.0);
+		}
+	}
+
+	float FrameTimeStats::bucketUpperMs(size_t bucket)
+	{
+		return static_cast<float>(FIRST_BUCKET_NANOS * std::exp2(static_cast<double>(bucket) / BUCKETS_PER_DOUBLING) / 1'000'000.0);
+	}
+
+	void FrameTimeRecorder::beginWrite()
+	{
+		sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+	}
+
+	void FrameTimeRecorder::endWrite()
+	{
+		sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+	}
+
+	void FrameTimeRecorder::record(uint64_t nanos)
+	{
+		uint64_t frame = recordedFrames.load(std::memory_order_relaxed);
+		beginWrite();
+
+		frameTimes[frame % FRAME_WINDOW].store(nanos, std::memory_order_relaxed);
+		histogram[bucketFor(nanos)].fetch_add(1, std::memory_order_relaxed);
+		// Judged against the frames before it, so a hitch does not raise its own bar
+		if (frame > 0 && nanos > HITCH_FACTOR * averageNanos) {
+			hitchCount.fetch_add(1, std::memory_order_relaxed);
+		}
+		averageNanos = frame == 0 ? static_cast<double>(nanos) : averageNanos + (static_cast<double>(nanos) - averageNanos) * AVERAGE_WEIGHT;
+		recordedFrames.store(frame + 1, std::memory_order_relaxed);
+
+		endWrite();
+	}
+
+	void FrameTimeRecorder::reset()
+	{
+		beginWrite();
+		for (auto& bucket : histogram) {
+			bucket.store(0, std::memory_order_relaxed);
+		}
+		recordedFrames.store(0, std::memory_order_relaxed);
+		hitchCount.store(0, std::memory_order_relaxed);
+		averageNanos = 0.0;
+		endWrite();
+	}
+
+	FrameTimeStats FrameTimeRecorder::snapshot() const
+	{
+		FrameTimeStats stats{};
+		std::vector<uint64_t> window;
+		window.reserve(FRAME_WINDOW);
+
+		while (true) {
+			uint64_t version = sequence.load(std::memory_order_acquire);
+			if (version & 1) continue;
+
+			stats.totalFrames = recordedFrames.load(std::memory_order_relaxed);
+			stats.totalHitches = hitchCount.load(std::memory_order_relaxed);
+			size_t frames = static_cast<size_t>(std::min<uint64_t>(stats.totalFrames, FRAME_WINDOW));
+			window.clear();
+			for (size_t i = 0; i < frames; i++) {
+				window.push_back(frameTimes[i].load(std::memory_order_relaxed));
+			}
+			for (size_t i = 0; i < stats.histogram.size(); i++) {
+				stats.histogram[i] = histogram[i].load(std::memory_order_relaxed);
+			}
+
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (sequence.load(std::memory_order_relaxed) == version) break;
+		}
+
+		stats.frames = window.size();
+		if (window.empty()) return stats;
+
+		uint64_t total = 0;
+		for (uint64_t nanos : window) {
+			total += nanos;
+		}
+		std::sort(window.begin(), window.end());
+		auto percentile = [&](double fraction) {
+			size_t rank = static_cast<size_t>(std::ceil(fraction * window.size()));
+			return toMilliseconds(window[std::clamp<size_t>(rank, 1, window.size()) - 1]);
+		};
+
+		stats.averageMs = toMilliseconds(total) / window.size();
+		stats.fps = stats.averageMs > 0.0f ? 1000.0f / stats.averageMs : 0.0f;
+		stats.p50Ms = percentile(0.50);
+		stats.p95Ms = percentile(0.95);
+		stats.p99Ms = percentile(0.99);
+		stats.maxMs = toMilliseconds(window.back());
+
+		float hitchMs = stats.p50Ms * HITCH_FACTOR;
+		stats.hitches = window.end() - std::upper_bound(window.begin(), window.end(), hitchMs, [](float limit, uint64_t nanos) {
+			return limit < toMilliseconds(nanos);
+		});
+		return stats;
+	}
+}
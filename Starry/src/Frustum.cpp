@@ -0,0 +1,67 @@
+#include "Frustum.h"
+
+namespace Starry
+{
+	void Frustum::setMatrix(const glm::mat4& viewProjection)
+	{
+		auto row = [&](int i) {
+			return glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+		};
+
+		planes[0] = row(3) + row(0); // Left
+		planes[1] = row(3) - row(0); // Right
+		planes[2] = row(3) + row(1); // Bottom
+		planes[3] = row(3) - row(1); // Top
+		planes[4] = row(3) + row(2); // Near, conservative for [0, 1] depth
+		planes[5] = row(3) - row(2); // Far
+
+		for (auto& plane : planes) {
+			float length = glm::length(glm::vec3(plane));
+			if (length > 0.0f) plane /= length;
+		}
+	}
+
+	bool Frustum::intersectsSphere(const glm::vec3& center, float radius) const
+	{
+		for (const auto& plane : planes) {
+			if (glm::dot(glm::vec3(plane), center) + plane.w < -radius) return false;
+		}
+		return true;
+	}
+
+	bool Frustum::intersectsAabb(const glm::vec3& boundsMin, const glm::vec3& boundsMax) const
+	{
+		for (const auto& plane : planes) {
+			// Corner furthest along the plane normal
+			glm::vec3 positive(
+				plane.x >= 0.0f ? boundsMax.x : boundsMin.x,
+				plane.y >= 0.0f ? boundsMax.y : boundsMin.y,
+				plane.z >= 0.0f ? boundsMax.z : boundsMin.z
+			);
+			if (glm::dot(glm::vec3(plane), positive) + plane.w < 0.0f) return false;
+		}
+		return true;
+	}
+
+	Frustum::Containment Frustum::classifyAabb(const glm::vec3& boundsMin, const glm::vec3& boundsMax) const
+	{
+		Containment result = Containment::INSIDE;
+		for (const auto& plane : planes) {
+			glm::vec3 positive(
+				plane.x >= 0.0f ? boundsMax.x : boundsMin.x,
+				plane.y >= 0.0f ? boundsMax.y : boundsMin.y,
+				plane.z >= 0.0f ? boundsMax.z : boundsMin.z
+			);
+			if (glm::dot(glm::vec3(plane), positive) + plane.w < 0.0f) return Containment::OUTSIDE;
+
+			// Corner furthest against the normal decides whether the box straddles the plane
+			glm::vec3 negative(
+				plane.x >= 0.0f ? boundsMin.x : boundsMax.x,
+				plane.y >= 0.0f ? boundsMin.y : boundsMax.y,
+				plane.z >= 0.0f ? boundsMin.z : boundsMax.z
+			);
+			if (glm::dot(glm::vec3(plane), negative) + plane.w < 0.0f) result = Containment::INTERSECTS;
+		}
+		return result;
+	}
+}
@@ -0,0 +1,515 @@
+#include "ImageDecoder.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <cstring>
+
+namespace Starry
+{
+	namespace
+	{
+		// Least significant bit first, as deflate packs them
+		struct BitReader {
+			const uint8_t* data = nullptr;
+			size_t size = 0;
+			size_t position = 0;
+			uint32_t buffer = 0;
+			int count = 0;
+
+			void fill()
+			{
+				while (count <= 24 && position < size) {
+					buffer |= static_cast<uint32_t>(data[position++]) << count;
+					count += 8;
+				}
+			}
+
+			// Up to 16 bits
+			bool read(int bits, uint32_t& value)
+			{
+				if (count < bits) fill();
+				if (count < bits) return false;
+				value = buffer & ((1u << bits) - 1);
+				buffer >>= bits;
+				count -= bits;
+				return true;
+			}
+		};
+
+		// Canonical Huffman code. Codes up to FAST_BITS long decode with one table lookup, longer ones a bit at a time.
+		struct Huffman {
+			constexpr static int MAX_BITS = 15;
+			constexpr static int FAST_BITS = 9;
+
+			std::array<uint16_t, MAX_BITS + 1> counts{};
+			std::array<uint16_t, 288> symbols{};
+			std::array<uint16_t, 1 << FAST_BITS> fast{}; // symbol << 4 | length, zero for longer codes
+
+			bool build(const uint8_t* lengths, size_t symbolCount)
+			{
+				counts.fill(0);
+				fast.fill(0);
+				for (size_t i = 0; i < symbolCount; i++) {
+					counts[lengths[i]]++;
+				}
+				counts[0] = 0;
+
+				// Over subscribed sets are invalid, incomplete ones are allowed (a lone distance code)
+				int left = 1;
+				for (int length = 1; length <= MAX_BITS; length++) {
+					left = (left << 1) - counts[length];
+					if (left < 0) return false;
+				}
+
+				std::array<uint16_t, MAX_BITS + 2> offsets{};
+				std::array<uint32_t, MAX_BITS + 1> nextCode{};
+				uint32_t code = 0;
+				for (int length = 1; length <= MAX_BITS; length++) {
+					offsets[length + 1] = offsets[length] + counts[length];
+					code = (code + counts[length - 1]) << 1;
+					nextCode[length] = code;
+				}
+
+				for (size_t symbol = 0; symbol < symbolCount; symbol++) {
+					int length = lengths[symbol];
+					if (length == 0) continue;
+					symbols[offsets[length]++] = static_cast<uint16_t>(symbol);
+
+					uint32_t symbolCode = nextCode[length]++;
+					if (length > FAST_BITS) continue;
+					// Deflate sends codes most significant bit first, so the table is indexed by the reversed code
+					uint32_t reversed = 0;
+					for (int bit = 0; bit < length; bit++) {
+						reversed |= ((symbolCode >> bit) & 1u) << (length - 1 - bit);
+					}
+					for (uint32_t entry = reversed; entry < fast.size(); entry += 1u << length) {
+						fast[entry] = static_cast<uint16_t>(symbol << 4 | length);
+					}
+				}
+				return true;
+			}
+
+			bool decode(BitReader& reader, int& symbol) const
+			{
+				reader.fill();
+				uint16_t entry = fast[reader.buffer & (fast.size() - 1)];
+				if (entry != 0 && (entry & 15) <= reader.count) {
+					reader.buffer >>= entry & 15;
+					reader.count -= entry & 15;
+					symbol = entry >> 4;
+					return true;
+				}
+
+				int code = 0, first = 0, index = 0;
+				for (int length = 1; length <= MAX_BITS; length++) {
+					uint32_t bit;
+					if (!reader.read(1, bit)) return false;
+					code |= static_cast<int>(bit);
+					int count = counts[length];
+					if (code - count < first) {
+						symbol = symbols[index + (code - first)];
+						return true;
+					}
+					index += count;
+					first = (first + count) << 1;
+					code <<= 1;
+				}
+				return false;
+			}
+		};
+
+		constexpr uint16_t LENGTH_BASE[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99,
+			115, 131, 163, 195, 227, 258 };
+		constexpr uint8_t LENGTH_EXTRA[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+		constexpr uint16_t DISTANCE_BASE[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769,
+			1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+		constexpr uint8_t DISTANCE_EXTRA[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12,
+			12, 13, 13 };
+		// Order the code length code lengths are sent in
+		constexpr uint8_t CODE_LENGTH_ORDER[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+		bool inflateStored(BitReader& reader, std::vector<uint8_t>& output)
+		{
+			// Starts on a byte boundary
+			reader.buffer >>= reader.count & 7;
+			reader.count -= reader.count & 7;
+			uint32_t length, complement;
+			if (!reader.read(16, length) || !reader.read(16, complement)) return false;
+			if ((length ^ 0xffff) != complement) return false;
+
+			// Whatever is still buffered first, then straight from the stream
+			for (; length > 0 && reader.count > 0; length--) {
+				uint32_t byte;
+				reader.read(8, byte);
+				output.push_back(static_cast<uint8_t>(byte));
+			}
+			if (reader.size - reader.position < length) return false;
+			output.insert(output.end(), reader.data + reader.position, reader.data + reader.position + length);
+			reader.position += length;
+			return true;
+		}
+
+		bool inflateCodes(BitReader& reader, const Huffman& lengthCodes, const Huffman& distanceCodes, std::vector<uint8_t>& output)
+		{
+			for (;;) {
+				int symbol;
+				if (!lengthCodes.decode(reader, symbol)) return false;
+				if (symbol < 256) {
+					output.push_back(static_cast<uint8_t>(symbol));
+					continue;
+				}
+				if (symbol == 256) return true;
+
+				symbol -= 257;
+				if (symbol >= 29) return false;
+				uint32_t extra;
+				if (!reader.read(LENGTH_EXTRA[symbol], extra)) return false;
+				size_t length = LENGTH_BASE[symbol] + extra;
+
+				if (!distanceCodes.decode(reader, symbol) || symbol >= 30) return false;
+				if (!reader.read(DISTANCE_EXTRA[symbol], extra)) return false;
+				size_t distance = DISTANCE_BASE[symbol] + extra;
+				if (distance > output.size()) return false;
+
+				// Byte by byte, the copy may overlap what it is writing
+				size_t from = output.size() - distance;
+				size_t to = output.size();
+				output.resize(to + length);
+				for (size_t i = 0; i < length; i++) {
+					output[to + i] = output[from + i];
+				}
+			}
+		}
+
+		bool inflateDynamic(BitReader& reader, std::vector<uint8_t>& output)
+		{
+			uint32_t literalCount, distanceCount, codeLengthCount;
+			if (!reader.read(5, literalCount) || !reader.read(5, distanceCount) || !reader.read(4, codeLengthCount)) return false;
+			literalCount += 257;
+			distanceCount += 1;
+			codeLengthCount += 4;
+			if (literalCount > 286 || distanceCount > 30) return false;
+
+			uint8_t lengths[320] = {};
+			for (uint32_t i = 0; i < codeLengthCount; i++) {
+				uint32_t length;
+				if (!reader.read(3, length)) return false;
+				lengths[CODE_LENGTH_ORDER[i]] = static_cast<uint8_t>(length);
+			}
+			Huffman codeLengths;
+			if (!codeLengths.build(lengths, 19)) return false;
+
+			std::memset(lengths, 0, sizeof(lengths));
+			uint32_t total = literalCount + distanceCount;
+			for (uint32_t index = 0; index < total;) {
+				int symbol;
+				if (!codeLengths.decode(reader, symbol)) return false;
+				if (symbol < 16) {
+					lengths[index++] = static_cast<uint8_t>(symbol);
+					continue;
+				}
+
+				uint8_t repeated = 0;
+				uint32_t repeat;
+				if (symbol == 16) {
+					if (index == 0 || !reader.read(2, repeat)) return false;
+					repeated = lengths[index - 1];
+					repeat += 3;
+				}
+				else if (symbol == 17) {
+					if (!reader.read(3, repeat)) return false;
+					repeat += 3;
+				}
+				else {
+					if (!reader.read(7, repeat)) return false;
+					repeat += 11;
+				}
+				if (index + repeat > total) return false;
+				std::memset(lengths + index, repeated, repeat);
+				index += repeat;
+			}
+			// Without an end of block code the block never ends
+			if (lengths[256] == 0) return false;
+
+			Huffman lengthCodes, distanceCodes;
+			if (!lengthCodes.build(lengths, literalCount) || !distanceCodes.build(lengths + literalCount, distanceCount)) return false;
+			return inflateCodes(reader, lengthCodes, distanceCodes, output);
+		}
+
+		const Huffman& fixedLengthCodes()
+		{
+			static const Huffman codes = []() {
+				uint8_t lengths[288];
+				std::fill(lengths, lengths + 144, uint8_t(8));
+				std::fill(lengths + 144, lengths + 256, uint8_t(9));
+				std::fill(lengths + 256, lengths + 280, uint8_t(7));
+				std::fill(lengths + 280, lengths + 288, uint8_t(8));
+				Huffman huffman;
+				huffman.build(lengths, 288);
+				return huffman;
+			}();
+			return codes;
+		}
+
+		const Huffman& fixedDistanceCodes()
+		{
+			static const Huffman codes = []() {
+				uint8_t lengths[30];
+				std::fill(lengths, lengths + 30, uint8_t(5));
+				Huffman huffman;
+				huffman.build(lengths, 30);
+				return huffman;
+			}();
+			return codes;
+		}
+
+		uint32_t readBigEndian(const uint8_t* bytes)
+		{
+			return static_cast<uint32_t>(bytes[0]) << 24 | static_cast<uint32_t>(bytes[1]) << 16 | static_cast<uint32_t>(bytes[2]) << 8 | bytes[3];
+		}
+
+		uint8_t paeth(int left, int up, int upLeft)
+		{
+			int estimate = left + up - upLeft;
+			int toLeft = std::abs(estimate - left);
+			int toUp = std::abs(estimate - up);
+			int toUpLeft = std::abs(estimate - upLeft);
+			if (toLeft <= toUp && toLeft <= toUpLeft) return static_cast<uint8_t>(left);
+			return static_cast<uint8_t>(toUp <= toUpLeft ? up : upLeft);
+		}
+
+		// Reverses the per row filters in place, every row keeps its leading filter type byte
+		bool unfilter(std::vector<uint8_t>& rows, size_t rowBytes, uint32_t height, size_t pixelBytes)
+		{
+			const uint8_t* previous = nullptr;
+			for (uint32_t y = 0; y < height; y++) {
+				uint8_t* row = rows.data() + y * (rowBytes + 1);
+				uint8_t filter = row[0];
+				uint8_t* current = row + 1;
+				for (size_t x = 0; x < rowBytes; x++) {
+					int left = x >= pixelBytes ? current[x - pixelBytes] : 0;
+					int up = previous != nullptr ? previous[x] : 0;
+					int upLeft = previous != nullptr && x >= pixelBytes ? previous[x - pixelBytes] : 0;
+					switch (filter) {
+						case 0: break;
+						case 1: current[x] = static_cast<uint8_t>(current[x] + left); break;
+						case 2: current[x] = static_cast<uint8_t>(current[x] + up); break;
+						case 3: current[x] = static_cast<uint8_t>(current[x] + ((left + up) >> 1)); break;
+						case 4: current[x] = static_cast<uint8_t>(current[x] + paeth(left, up, upLeft)); break;
+						default: return false;
+					}
+				}
+				previous = current;
+			}
+			return true;
+		}
+	}
+
+	bool ImageDecoder::decode(const char* data, size_t size, TextureImageData& image)
+	{
+		const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+		constexpr uint8_t PNG_SIGNATURE[8] = { 137, 80, 78, 71, 13, 10, 26, 10 };
+		if (size >= 8 && std::memcmp(bytes, PNG_SIGNATURE, 8) == 0) return decodePng(bytes, size, image);
+		if (size >= 2 && bytes[0] == 'P' && bytes[1] == '6') return decodePpm(bytes, size, image);
+		return false;
+	}
+
+	bool ImageDecoder::inflate(const uint8_t* data, size_t size, std::vector<uint8_t>& output, size_t expectedSize)
+	{
+		// Deflate without a preset dictionary
+		if (size < 2 || (data[0] & 0x0f) != 8 || ((data[0] << 8) | data[1]) % 31 != 0 || (data[1] & 0x20) != 0) return false;
+		output.reserve(output.size() + expectedSize);
+
+		BitReader reader{ data + 2, size - 2 };
+		uint32_t last = 0;
+		while (last == 0) {
+			uint32_t type;
+			if (!reader.read(1, last) || !reader.read(2, type)) return false;
+			bool ok = false;
+			switch (type) {
+				case 0: ok = inflateStored(reader, output); break;
+				case 1: ok = inflateCodes(reader, fixedLengthCodes(), fixedDistanceCodes(), output); break;
+				case 2: ok = inflateDynamic(reader, output); break;
+				default: break;
+			}
+			if (!ok) return false;
+		}
+		return true;
+	}
+
+	bool ImageDecoder::decodePng(const uint8_t* data, size_t size, TextureImageData& image)
+	{
+		uint32_t width = 0, height = 0;
+		uint8_t bitDepth = 0, colorType = 0;
+		bool hasHeader = false;
+		std::vector<uint8_t> compressed;
+		std::array<uint8_t, 256 * 4> palette{};
+		uint32_t paletteSize = 0;
+		std::vector<uint8_t> transparency;
+
+		for (size_t position = 8; position + 12 <= size;) {
+			uint32_t length = readBigEndian(data + position);
+			const uint8_t* type = data + position + 4;
+			const uint8_t* chunk = data + position + 8;
+			if (length > size - position - 12) return false;
+			position += 12 + static_cast<size_t>(length); // Length, type, data and CRC, which is not checked
+
+			if (std::memcmp(type, "IHDR", 4) == 0) {
+				if (length < 13) return false;
+				width = readBigEndian(chunk);
+				height = readBigEndian(chunk + 4);
+				bitDepth = chunk[8];
+				colorType = chunk[9];
+				// Compression, filter method and interlacing, Adam7 is not supported
+				if (chunk[10] != 0 || chunk[11] != 0 || chunk[12] != 0) return false;
+				hasHeader = true;
+			}
+			else if (std::memcmp(type, "PLTE", 4) == 0) {
+				paletteSize = std::min<uint32_t>(length / 3, 256);
+				for (uint32_t i = 0; i < paletteSize; i++) {
+					palette[i * 4 + 0] = chunk[i * 3 + 0];
+					palette[i * 4 + 1] = chunk[i * 3 + 1];
+					palette[i * 4 + 2] = chunk[i * 3 + 2];
+					palette[i * 4 + 3] = 255;
+				}
+			}
+			else if (std::memcmp(type, "tRNS", 4) == 0) {
+				transparency.assign(chunk, chunk + length);
+			}
+			else if (std::memcmp(type, "IDAT", 4) == 0) {
+				compressed.insert(compressed.end(), chunk, chunk + length);
+			}
+			else if (std::memcmp(type, "IEND", 4) == 0) {
+				break;
+			}
+		}
+		if (!hasHeader || width == 0 || height == 0 || static_cast<uint64_t>(width) * height > MAX_PIXELS) return false;
+
+		uint32_t channels = 0;
+		switch (colorType) {
+			case 0: channels = 1; break; // Grey
+			case 2: channels = 3; break; // RGB
+			case 3: channels = 1; break; // Palette index
+			case 4: channels = 2; break; // Grey and alpha
+			case 6: channels = 4; break; // RGBA
+			default: return false;
+		}
+		bool lowDepth = bitDepth == 1 || bitDepth == 2 || bitDepth == 4;
+		if (!(bitDepth == 8 || (bitDepth == 16 && colorType != 3) || (lowDepth && (colorType == 0 || colorType == 3)))) return false;
+		if (colorType == 3 && paletteSize == 0) return false;
+
+		size_t bitsPerPixel = static_cast<size_t>(channels) * bitDepth;
+		size_t rowBytes = (static_cast<size_t>(width) * bitsPerPixel + 7) / 8;
+		size_t pixelBytes = std::max<size_t>(1, bitsPerPixel / 8);
+		size_t filteredSize = (rowBytes + 1) * height;
+
+		std::vector<uint8_t> rows;
+		if (!inflate(compressed.data(), compressed.size(), rows, filteredSize) || rows.size() < filteredSize) return false;
+		if (!unfilter(rows, rowBytes, height, pixelBytes)) return false;
+
+		if (colorType == 3) {
+			for (size_t i = 0; i < transparency.size() && i < paletteSize; i++) {
+				palette[i * 4 + 3] = transparency[i];
+			}
+		}
+		// Grey and RGB images may name one color, as 16 bit samples, that is fully transparent
+		bool hasKey = (colorType == 0 && transparency.size() >= 2) || (colorType == 2 && transparency.size() >= 6);
+		std::array<uint32_t, 3> key{};
+		for (uint32_t c = 0; hasKey && c < channels; c++) {
+			key[c] = static_cast<uint32_t>(transparency[c * 2]) << 8 | transparency[c * 2 + 1];
+		}
+
+		image.width = width;
+		image.height = height;
+		image.pixels.resize(static_cast<size_t>(width) * height * 4);
+		uint32_t sampleMax = (1u << std::min<uint32_t>(bitDepth, 8)) - 1;
+		for (uint32_t y = 0; y < height; y++) {
+			const uint8_t* row = rows.data() + y * (rowBytes + 1) + 1;
+			uint8_t* out = image.pixels.data() + static_cast<size_t>(y) * width * 4;
+			for (uint32_t x = 0; x < width; x++, out += 4) {
+				// Samples at their own depth for the key, scaled to 8 bits for the image. 16 bit keeps the high byte.
+				std::array<uint32_t, 4> raw{};
+				std::array<uint8_t, 4> scaled{};
+				for (uint32_t c = 0; c < channels; c++) {
+					if (bitDepth == 16) {
+						const uint8_t* sample = row + (static_cast<size_t>(x) * channels + c) * 2;
+						raw[c] = static_cast<uint32_t>(sample[0]) << 8 | sample[1];
+						scaled[c] = sample[0];
+					}
+					else if (bitDepth == 8) {
+						raw[c] = row[static_cast<size_t>(x) * channels + c];
+						scaled[c] = static_cast<uint8_t>(raw[c]);
+					}
+					else {
+						size_t bit = static_cast<size_t>(x) * bitDepth;
+						raw[c] = (row[bit / 8] >> (8 - bitDepth - bit % 8)) & sampleMax;
+						scaled[c] = static_cast<uint8_t>(raw[c] * 255 / sampleMax);
+					}
+				}
+
+				switch (colorType) {
+					case 0:
+						out[0] = out[1] = out[2] = scaled[0];
+						out[3] = hasKey && raw[0] == key[0] ? 0 : 255;
+						break;
+					case 2:
+						out[0] = scaled[0];
+						out[1] = scaled[1];
+						out[2] = scaled[2];
+						out[3] = hasKey && raw[0] == key[0] && raw[1] == key[1] && raw[2] == key[2] ? 0 : 255;
+						break;
+					case 3:
+						if (raw[0] >= paletteSize) return false;
+						std::memcpy(out, palette.data() + raw[0] * 4, 4);
+						break;
+					case 4:
+						out[0] = out[1] = out[2] = scaled[0];
+						out[3] = scaled[1];
+						break;
+					default:
+						std::memcpy(out, scaled.data(), 4);
+						break;
+				}
+			}
+		}
+		return true;
+	}
+
+	bool ImageDecoder::decodePpm(const uint8_t* data, size_t size, TextureImageData& image)
+	{
+		// Magic number, width, height and maximum value, separated by whitespace and # comments
+		size_t position = 2;
+		uint64_t fields[3] = {};
+		for (uint64_t& field : fields) {
+			for (;;) {
+				while (position < size && std::strchr(" \t\r\n", data[position]) != nullptr) position++;
+				if (position >= size || data[position] != '#') break;
+				while (position < size && data[position] != '\n') position++;
+			}
+			if (position >= size || data[position] < '0' || data[position] > '9') return false;
+			while (position < size && data[position] >= '0' && data[position] <= '9' && field < MAX_PIXELS) {
+				field = field * 10 + (data[position++] - '0');
+			}
+		}
+		// A single whitespace byte before the samples
+		position++;
+
+		uint64_t width = fields[0], height = fields[1], maxValue = fields[2];
+		if (width == 0 || height == 0 || width * height > MAX_PIXELS || maxValue == 0 || maxValue > 255) return false;
+		size_t pixelCount = static_cast<size_t>(width * height);
+		if (position > size || size - position < pixelCount * 3) return false;
+
+		image.width = static_cast<uint32_t>(width);
+		image.height = static_cast<uint32_t>(height);
+		image.pixels.resize(pixelCount * 4);
+		const uint8_t* source = data + position;
+		for (size_t i = 0; i < pixelCount; i++) {
+			for (int c = 0; c < 3; c++) {
+				image.pixels[i * 4 + c] = static_cast<uint8_t>(source[i * 3 + c] * 255u / maxValue);
+			}
+			image.pixels[i * 4 + 3] = 255;
+		}
+		return true;
+	}
+}
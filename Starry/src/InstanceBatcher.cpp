@@ -0,0 +1,49 @@
+#include "InstanceBatcher.h"
+
+namespace Starry
+{
+	void InstanceBatcher::build(const uint64_t* keys, size_t count)
+	{
+		batchOfKey.clear();
+		batches.clear();
+		itemBatch.resize(count);
+		order.resize(count);
+
+		// Scenes tend to push copies of a mesh together, so the previous key catches most lookups
+		uint64_t lastKey = 0;
+		uint32_t lastBatch = 0;
+		for (size_t i = 0; i < count; i++) {
+			uint64_t key = keys[i];
+			uint32_t batch;
+			if (key != 0 && key == lastKey) {
+				batch = lastBatch;
+			}
+			else if (key == 0) {
+				batch = static_cast<uint32_t>(batches.size());
+				batches.push_back({ key, 0, 0 });
+			}
+			else {
+				auto [found, inserted] = batchOfKey.try_emplace(key, static_cast<uint32_t>(batches.size()));
+				if (inserted) {
+					batches.push_back({ key, 0, 0 });
+				}
+				batch = found->second;
+			}
+			batches[batch].instanceCount++;
+			itemBatch[i] = batch;
+			lastKey = key;
+			lastBatch = batch;
+		}
+
+		cursors.resize(batches.size());
+		uint32_t first = 0;
+		for (size_t b = 0; b < batches.size(); b++) {
+			batches[b].firstInstance = first;
+			cursors[b] = first;
+			first += batches[b].instanceCount;
+		}
+		for (size_t i = 0; i < count; i++) {
+			order[cursors[itemBatch[i]]++] = static_cast<uint32_t>(i);
+		}
+	}
+}
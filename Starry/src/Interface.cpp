@@ -1,5 +1,7 @@
 #include "Interface.h"
 
+#include "Profiler.h"
+
 namespace Starry
 {
     Interface::Interface()
@@ -17,6 +19,7 @@ namespace Starry
 
     void Interface::Display()
     {
+        STARRY_PROFILE_SCOPE("UI Draw");
         for (auto element : elements) {
             element.second->Draw();
         }
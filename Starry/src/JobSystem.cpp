@@ -0,0 +1,156 @@
+#include "JobSystem.h"
+
+#include "Parallel.h"
+#include "Profiler.h"
+
+namespace Starry
+{
+	namespace
+	{
+		// Which pool the current thread works for, and its queue there
+		thread_local const JobSystem* workerOwner = nullptr;
+		thread_local size_t workerQueue = 0;
+	}
+
+	JobSystem& JobSystem::get()
+	{
+		static JobSystem system(defaultThreadCount() - 1);
+		return system;
+	}
+
+	JobSystem::JobSystem(size_t workerCount)
+	{
+		queues.reserve(workerCount + 1);
+		for (size_t i = 0; i < workerCount + 1; i++) {
+			queues.push_back(std::make_unique<WorkQueue>());
+		}
+		workers.reserve(workerCount);
+		for (size_t i = 0; i < workerCount; i++) {
+			workers.emplace_back(&JobSystem::workerLoop, this, i + 1);
+		}
+	}
+
+	JobSystem::~JobSystem()
+	{
+		running.store(false, std::memory_order_release);
+		{
+			std::lock_guard<std::mutex> lock(sleepMutex);
+		}
+		wake.notify_all();
+		for (auto& worker : workers) {
+			worker.join();
+		}
+	}
+
+	void JobSystem::run(Job job, JobCounter* counter)
+	{
+		if (counter != nullptr) {
+			counter->pending.fetch_add(1, std::memory_order_relaxed);
+		}
+		push({ std::move(job), counter });
+	}
+
+	void JobSystem::wait(JobCounter& counter)
+	{
+		while (!counter.done()) {
+			if (!runOne(&counter)) {
+				std::this_thread::yield();
+			}
+		}
+	}
+
+	void JobSystem::workerLoop(size_t queue)
+	{
+		workerOwner = this;
+		workerQueue = queue;
+		STARRY_PROFILE_THREAD("Job Worker");
+
+		while (running.load(std::memory_order_acquire)) {
+			if (runOne()) continue;
+
+			std::unique_lock<std::mutex> lock(sleepMutex);
+			sleepingCount.fetch_add(1);
+			wake.wait(lock, [&]() { return !running.load(std::memory_order_acquire) || queuedCount.load() > 0; });
+			sleepingCount.fetch_sub(1);
+		}
+	}
+
+	void JobSystem::push(Task task)
+	{
+		// Raised first so the count never drops below what is really queued
+		queuedCount.fetch_add(1);
+
+		WorkQueue& queue = *queues[currentQueue()];
+		{
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			queue.tasks.push_back(std::move(task));
+		}
+
+		if (sleepingCount.load() > 0) {
+			{
+				std::lock_guard<std::mutex> lock(sleepMutex);
+			}
+			wake.notify_one();
+		}
+	}
+
+	bool JobSystem::take(std::deque<Task>& tasks, const JobCounter* only, bool newest, Task& task)
+	{
+		if (tasks.empty()) return false;
+		if (only == nullptr) {
+			task = std::move(newest ? tasks.back() : tasks.front());
+			newest ? tasks.pop_back() : tasks.pop_front();
+			return true;
+		}
+
+		// Waiters scan for their own jobs, queues stay a few batches per thread long
+		for (size_t i = 0; i < tasks.size(); i++) {
+			auto entry = newest ? tasks.end() - 1 - i : tasks.begin() + i;
+			if (entry->counter != only) continue;
+			task = std::move(*entry);
+			tasks.erase(entry);
+			return true;
+		}
+		return false;
+	}
+
+	bool JobSystem::runOne(const JobCounter* only)
+	{
+		if (queuedCount.load(std::memory_order_relaxed) == 0) return false;
+
+		Task task;
+		bool found = false;
+		size_t own = currentQueue();
+
+		// Newest job of our own queue first, it is the one most likely still in cache
+		{
+			WorkQueue& queue = *queues[own];
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			found = take(queue.tasks, only, true, task);
+		}
+		// Otherwise steal the oldest job of someone else, usually the biggest piece of work left
+		for (size_t i = 1; !found && i < queues.size(); i++) {
+			WorkQueue& victim = *queues[(own + i) % queues.size()];
+			std::lock_guard<std::mutex> lock(victim.mutex);
+			found = take(victim.tasks, only, false, task);
+		}
+		if (!found) return false;
+
+		queuedCount.fetch_sub(1);
+		task.job();
+		finish(task.counter);
+		return true;
+	}
+
+	void JobSystem::finish(JobCounter* counter)
+	{
+		if (counter == nullptr) return;
+		// The last touch of the counter, a waiter may destroy it as soon as it reads zero
+		counter->pending.fetch_sub(1, std::memory_order_acq_rel);
+	}
+
+	size_t JobSystem::currentQueue() const
+	{
+		return workerOwner == this ? workerQueue : 0;
+	}
+}
@@ -0,0 +1,132 @@
+#include "MappedFile.h"
+
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Starry
+{
+	MappedFile::~MappedFile()
+	{
+		close();
+	}
+
+	MappedFile::MappedFile(MappedFile&& other) noexcept
+	{
+		*this = std::move(other);
+	}
+
+	MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+	{
+		if (this == &other) return *this;
+		close();
+
+		opened = std::exchange(other.opened, false);
+		view = std::exchange(other.view, nullptr);
+		length = std::exchange(other.length, 0);
+#ifdef _WIN32
+		fileHandle = std::exchange(other.fileHandle, nullptr);
+		mappingHandle = std::exchange(other.mappingHandle, nullptr);
+#else
+		fileDescriptor = std::exchange(other.fileDescriptor, -1);
+#endif
+		return *this;
+	}
+
+#ifdef _WIN32
+	bool MappedFile::open(const std::string& filePath)
+	{
+		close();
+
+		HANDLE file = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+			OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE) return false;
+
+		LARGE_INTEGER fileSize{};
+		if (!GetFileSizeEx(file, &fileSize)) {
+			CloseHandle(file);
+			return false;
+		}
+		fileHandle = file;
+		length = static_cast<size_t>(fileSize.QuadPart);
+		opened = true;
+
+		if (length == 0) return true;
+
+		HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mapping == nullptr) {
+			close();
+			return false;
+		}
+		mappingHandle = mapping;
+
+		view = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+		if (view == nullptr) {
+			close();
+			return false;
+		}
+		return true;
+	}
+
+	void MappedFile::close()
+	{
+		if (view != nullptr) UnmapViewOfFile(view);
+		if (mappingHandle != nullptr) CloseHandle(static_cast<HANDLE>(mappingHandle));
+		if (fileHandle != nullptr) CloseHandle(static_cast<HANDLE>(fileHandle));
+
+		view = nullptr;
+		mappingHandle = nullptr;
+		fileHandle = nullptr;
+		length = 0;
+		opened = false;
+	}
+#else
+	bool MappedFile::open(const std::string& filePath)
+	{
+		close();
+
+		int fd = ::open(filePath.c_str(), O_RDONLY);
+		if (fd < 0) return false;
+
+		struct stat fileStat{};
+		if (fstat(fd, &fileStat) != 0) {
+			::close(fd);
+			return false;
+		}
+		fileDescriptor = fd;
+		length = static_cast<size_t>(fileStat.st_size);
+		opened = true;
+
+		if (length == 0) return true;
+
+		void* mapped = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (mapped == MAP_FAILED) {
+			close();
+			return false;
+		}
+		madvise(mapped, length, MADV_SEQUENTIAL);
+		view = static_cast<const char*>(mapped);
+		return true;
+	}
+
+	void MappedFile::close()
+	{
+		if (view != nullptr) munmap(const_cast<char*>(view), length);
+		if (fileDescriptor >= 0) ::close(fileDescriptor);
+
+		view = nullptr;
+		fileDescriptor = -1;
+		length = 0;
+		opened = false;
+	}
+#endif
+}
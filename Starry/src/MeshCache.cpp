@@ -0,0 +1,142 @@
+#include "MeshCache.h"
+
+#include "ContentHash.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+#include <vector>
+
+namespace Starry
+{
+	namespace
+	{
+		uint64_t alignUp(uint64_t value, uint64_t alignment)
+		{
+			return (value + alignment - 1) & ~(alignment - 1);
+		}
+
+		bool writePadding(std::ofstream& stream, uint64_t from, uint64_t to)
+		{
+			static const char zeros[MeshCache::PAYLOAD_ALIGNMENT] = {};
+			if (to > from) stream.write(zeros, static_cast<std::streamsize>(to - from));
+			return stream.good();
+		}
+	}
+
+	std::string MeshCache::cachePathFor(const std::string& sourcePath, const std::string& cacheDirectory, uint64_t sourceHash)
+	{
+		if (cacheDirectory.empty()) {
+			return sourcePath + ".smesh";
+		}
+		std::filesystem::path source(sourcePath);
+		std::filesystem::path cached = std::filesystem::path(cacheDirectory) /
+			(source.stem().string() + "-" + hashToString(sourceHash) + ".smesh");
+		return cached.string();
+	}
+
+	bool MeshCache::write(const std::string& filePath, const MeshCacheData& data, uint64_t sourceSize)
+	{
+		MeshCacheHeader header{};
+		header.version = VERSION;
+		header.vertexStride = data.vertexStride;
+		header.flags = data.flags;
+		header.vertexCount = data.vertexCount;
+		header.indexCount = data.indexCount;
+		header.vertexOffset = alignUp(sizeof(MeshCacheHeader), PAYLOAD_ALIGNMENT);
+		header.indexOffset = alignUp(header.vertexOffset + header.vertexCount * header.vertexStride, PAYLOAD_ALIGNMENT);
+		std::memcpy(header.boundsMin, data.boundsMin, sizeof(header.boundsMin));
+		std::memcpy(header.boundsMax, data.boundsMax, sizeof(header.boundsMax));
+		header.sourceHash = data.sourceHash;
+		header.sourceSize = sourceSize;
+		header.optionsHash = data.optionsHash;
+		header.acmrBefore = data.optimizeReport.before.acmr;
+		header.atvrBefore = data.optimizeReport.before.atvr;
+		header.acmrAfter = data.optimizeReport.after.acmr;
+		header.atvrAfter = data.optimizeReport.after.atvr;
+		header.clusters = data.optimizeReport.clusters;
+		header.overdrawApplied = data.optimizeReport.overdrawApplied;
+
+		std::error_code error;
+		std::filesystem::path target(filePath);
+		if (target.has_parent_path()) {
+			std::filesystem::create_directories(target.parent_path(), error);
+		}
+
+		std::filesystem::path temporary = target;
+		temporary += ".tmp";
+
+		{
+			std::ofstream stream(temporary, std::ios::binary | std::ios::trunc);
+			if (!stream) return false;
+
+			uint64_t vertexBytes = header.vertexCount * header.vertexStride;
+
+			stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			writePadding(stream, sizeof(header), header.vertexOffset);
+			stream.write(static_cast<const char*>(data.vertices), static_cast<std::streamsize>(vertexBytes));
+			writePadding(stream, header.vertexOffset + vertexBytes, header.indexOffset);
+			stream.write(reinterpret_cast<const char*>(data.indices), static_cast<std::streamsize>(header.indexCount * sizeof(uint32_t)));
+
+			if (!stream.good()) {
+				stream.close();
+				std::filesystem::remove(temporary, error);
+				return false;
+			}
+		}
+
+		std::filesystem::rename(temporary, target, error);
+		if (error) {
+			std::filesystem::remove(temporary, error);
+			return false;
+		}
+		return true;
+	}
+
+	bool MeshCache::open(const std::string& filePath, uint64_t expectedSourceHash, uint64_t expectedSourceSize, uint32_t expectedStride,
+		uint32_t expectedFlags, uint64_t expectedOptionsHash)
+	{
+		close();
+
+		if (!file.open(filePath) || file.size() < sizeof(MeshCacheHeader)) {
+			close();
+			return false;
+		}
+
+		MeshCacheHeader header{};
+		std::memcpy(&header, file.data(), sizeof(header));
+
+		bool valid = std::memcmp(header.magic, MeshCacheHeader{}.magic, sizeof(header.magic)) == 0
+			&& header.version == VERSION
+			&& header.vertexStride == expectedStride
+			&& header.flags == expectedFlags
+			&& header.sourceHash == expectedSourceHash
+			&& header.sourceSize == expectedSourceSize
+			&& header.optionsHash == expectedOptionsHash
+			&& header.vertexOffset % PAYLOAD_ALIGNMENT == 0
+			&& header.indexOffset % PAYLOAD_ALIGNMENT == 0
+			&& header.vertexOffset + header.vertexCount * header.vertexStride <= header.indexOffset
+			&& header.indexOffset + header.indexCount * sizeof(uint32_t) <= file.size();
+		if (!valid) {
+			close();
+			return false;
+		}
+
+		data.vertices = file.data() + header.vertexOffset;
+		data.vertexStride = header.vertexStride;
+		data.vertexCount = header.vertexCount;
+		data.indices = reinterpret_cast<const uint32_t*>(file.data() + header.indexOffset);
+		data.indexCount = header.indexCount;
+		data.flags = header.flags;
+		std::memcpy(data.boundsMin, header.boundsMin, sizeof(data.boundsMin));
+		std::memcpy(data.boundsMax, header.boundsMax, sizeof(data.boundsMax));
+		data.sourceHash = header.sourceHash;
+		data.optionsHash = header.optionsHash;
+		data.optimizeReport.before = { header.acmrBefore, header.atvrBefore };
+		data.optimizeReport.after = { header.acmrAfter, header.atvrAfter };
+		data.optimizeReport.clusters = static_cast<size_t>(header.clusters);
+		data.optimizeReport.overdrawApplied = header.overdrawApplied != 0;
+		return true;
+	}
+}
@@ -1,9 +1,26 @@
 #include "MeshObject.h"
 
+#include "AssetLoader.h"
+#include "AsyncLog.h"
+#include "ContentHash.h"
+#include "MappedFile.h"
+#include "MeshCache.h"
+#include "ObjImporter.h"
+#include "Profiler.h"
+#include "VertexWelder.h"
+
 #include <glm/gtc/matrix_transform.hpp>
 
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <format>
+#include <limits>
+
 #define EXTERN_ERROR(x) if(x->getAlertSeverity() == FATAL) { return; }
 
+using WeldEngine = Starry::VertexWelder<Render::Vertex>;
+
 namespace Starry
 {
 	MeshObject::MeshObject(std::string nameInput) :  SceneObject(SceneObject::Type::MESH, std::string("Mesh, ") + nameInput)
@@ -26,21 +43,394 @@ namespace Starry
 
 	void MeshObject::Destroy()
 	{
+		cancelPendingMesh();
 		if (buffer != nullptr) {
 			buffer.reset();
 		}
 		if (textureImage != nullptr) {
 			textureImage.reset();
 		}
+		geometry.reset();
 	}
 
 	void MeshObject::addVertexData(std::vector<Render::Vertex>& verticesInput, std::vector<uint32_t> indicesInput) 
 	{
-		vertices = verticesInput;
-		indices = indicesInput;
-		isEmpty = vertices.empty() || indices.empty();
+		uint64_t contentHash = hashBytes(verticesInput.data(), verticesInput.size() * sizeof(Render::Vertex));
+		contentHash = hashBytes(indicesInput.data(), indicesInput.size() * sizeof(uint32_t), contentHash);
+
+		BuildSettings settings = buildSettings();
+		attachGeometry(MeshRegistry::get().acquire(geometryKey(settings, contentHash), [&](MeshGeometry& mesh) {
+			mesh.vertices = verticesInput;
+			mesh.indices = std::move(indicesInput);
+			computeBounds(mesh);
+
+			if (settings.optimize) {
+				optimizeVertexData(mesh, settings);
+			}
+			finishGeometry(mesh, settings);
+			return true;
+		}));
+	}
+
+	MeshObject::BuildSettings MeshObject::buildSettings() const
+	{
+		BuildSettings settings{};
+		settings.optimize = shouldOptimize();
+		settings.optimizeOptions = optimization == Optimization::ENABLED ? optimizeOptions : globalOptimizeOptions;
+		settings.lodRatios = lodRatios;
+		settings.meshletCulling = meshletCulling;
+		settings.meshCaching = meshCaching;
+		settings.meshCacheDirectory = meshCacheDirectory;
+		return settings;
+	}
+
+	uint64_t MeshObject::geometryKey(const BuildSettings& settings, uint64_t contentHash)
+	{
+		// Everything that changes what gets built out of the same content
+		const MeshOptimizeOptions& options = settings.optimizeOptions;
+		uint32_t values[] = {
+			settings.optimize, options.vertexCache, options.overdraw, options.vertexFetch, options.cacheSize,
+			std::bit_cast<uint32_t>(options.overdrawThreshold), settings.meshletCulling
+		};
+		uint64_t key = hashBytes(values, sizeof(values), contentHash);
+		return hashBytes(settings.lodRatios.data(), settings.lodRatios.size() * sizeof(float), key);
+	}
+
+	void MeshObject::finishGeometry(MeshGeometry& mesh, const BuildSettings& settings)
+	{
+		if (mesh.vertices.empty() || mesh.indices.empty()) return;
+
+		STARRY_PROFILE_SCOPE("Finish Geometry");
+		{
+			STARRY_PROFILE_SCOPE("Generate LODs");
+			generateLods(mesh, settings);
+		}
+		{
+			STARRY_PROFILE_SCOPE("Build Meshlets");
+			buildMeshlets(mesh, settings);
+		}
+
+		if (mesh.lods.size() < 2 && mesh.meshletLevels.empty()) {
+			STARRY_PROFILE_SCOPE("Buffer Upload");
+			mesh.buffer = std::make_shared<Render::Buffer>();
+			RenderBackend::bufferData(*mesh.buffer, mesh.vertices, mesh.indices);
+		}
+	}
+
+	void MeshObject::attachGeometry(std::shared_ptr<MeshGeometry> mesh, bool privateBuffer)
+	{
+		bindGeometry(std::move(mesh), privateBuffer);
+		hasBounds = !isEmpty;
+		localBounds = hasBounds ? Aabb{ geometry->boundsMin, geometry->boundsMax } : Aabb{};
+		markBoundsDirty();
+	}
+
+	void MeshObject::bindGeometry(std::shared_ptr<MeshGeometry> mesh, bool privateBuffer)
+	{
+		// The render context keeps the buffer it was handed at Register, so from then on the data moves instead
+		if (registered && !ownsBuffer) {
+			Alert("Cannot replace the shared buffer of a registered mesh.", CRITICAL);
+			return;
+		}
+
+		geometry = std::move(mesh);
+		isEmpty = geometry == nullptr || geometry->vertices.empty() || geometry->indices.empty();
+		activeLod = 0;
+		meshletVisibility.clear();
+		culledLevel = SIZE_MAX;
+		pendingIndices = nullptr;
+		if (isEmpty) return;
+
+		if (registered) {
+			RenderBackend::bufferData(*buffer, geometry->vertices, geometry->indices);
+			return;
+		}
+
+		ownsBuffer = privateBuffer || geometry->buffer == nullptr;
+		if (!ownsBuffer) {
+			buffer = geometry->buffer;
+			return;
+		}
+		// LOD switches and meshlet culling rewrite the index list, so those objects keep a buffer of their own
+		buffer = std::make_shared<Render::Buffer>();
+		RenderBackend::bufferData(*buffer, geometry->vertices, geometry->indices);
+	}
+
+	std::shared_ptr<MeshGeometry> MeshObject::placeholderGeometry()
+	{
+		// Unit cube, a face per axis and side so every face gets a flat normal
+		constexpr uint64_t PLACEHOLDER_KEY = 0x706c616365686f6cull;
+		return MeshRegistry::get().acquire(PLACEHOLDER_KEY, [](MeshGeometry& mesh) {
+			for (int face = 0; face < 6; face++) {
+				int axis = face / 2;
+				float side = face % 2 ? 1.0f : -1.0f;
+				glm::vec3 normal(0.0f), u(0.0f), v(0.0f);
+				normal[axis] = side;
+				u[(axis + 1) % 3] = 0.5f;
+				v[(axis + 2) % 3] = 0.5f;
+
+				uint32_t base = static_cast<uint32_t>(mesh.vertices.size());
+				for (int corner = 0; corner < 4; corner++) {
+					float cornerU = corner & 1 ? 1.0f : -1.0f;
+					float cornerV = corner & 2 ? 1.0f : -1.0f;
+
+					Render::Vertex vertex{};
+					vertex.position = normal * 0.5f + u * cornerU + v * cornerV;
+					vertex.normal = normal;
+					vertex.texCoord = { (cornerU + 1.0f) * 0.5f, (cornerV + 1.0f) * 0.5f };
+					vertex.color = { 1.0f, 1.0f, 1.0f };
+					mesh.vertices.push_back(vertex);
+				}
+				// u x v points along +axis, flip the winding for the faces on the negative side
+				const uint32_t front[] = { 0, 1, 3, 0, 3, 2 };
+				const uint32_t back[] = { 0, 3, 1, 0, 2, 3 };
+				const uint32_t* quad = side > 0.0f ? front : back;
+				for (int i = 0; i < 6; i++) {
+					mesh.indices.push_back(base + quad[i]);
+				}
+			}
+			mesh.boundsMin = glm::vec3(-0.5f);
+			mesh.boundsMax = glm::vec3(0.5f);
+			return true;
+		});
+	}
+
+	bool MeshObject::commitLoad()
+	{
+		if (pendingMesh == nullptr) return true;
+		if (!pendingMesh->finished.load(std::memory_order_acquire)) return false;
 
-		buffer->loadData(vertices, indices);
+		std::shared_ptr<MeshGeometry> mesh = std::move(pendingMesh->geometry);
+		pendingMesh.reset();
+		// Failed loads keep the placeholder, the loader already raised the error
+		if (mesh == nullptr) return true;
+
+		bindGeometry(std::move(mesh), false);
+		loadedBounds = { geometry->boundsMin, geometry->boundsMax };
+		boundsLoaded = true;
+		return true;
+	}
+
+	void MeshObject::commitLoadedBounds()
+	{
+		if (!boundsLoaded) return;
+		boundsLoaded = false;
+		hasBounds = true;
+		localBounds = loadedBounds;
+		markBoundsDirty();
+	}
+
+	void MeshObject::generateLods(MeshGeometry& mesh, const BuildSettings& settings)
+	{
+		if (settings.lodRatios.empty()) return;
+
+		std::vector<MeshLod>& lods = mesh.lods;
+		lods.push_back({ mesh.indices, 0.0f });
+
+		SimplifyInput input{};
+		input.indices = &mesh.indices;
+		input.vertexCount = mesh.vertices.size();
+		input.positions = &mesh.vertices[0].position[0];
+		input.positionStride = sizeof(Render::Vertex);
+		input.attributes = &mesh.vertices[0].normal[0];
+		input.attributeStride = sizeof(Render::Vertex);
+		input.attributeCount = 3;
+
+		for (float ratio : settings.lodRatios) {
+			size_t target = static_cast<size_t>(static_cast<double>(mesh.indices.size()) * ratio) / 3 * 3;
+			SimplifyResult simplified = MeshSimplifier::simplify(input, target, std::numeric_limits<float>::max());
+
+			// Stop once the simplifier cannot make progress, further levels would be copies
+			if (simplified.indices.size() >= lods.back().indices.size()) break;
+
+			if (settings.optimize) {
+				MeshOptimizer::optimizeVertexCache(simplified.indices, mesh.vertices.size());
+			}
+			lods.push_back({ std::move(simplified.indices), std::max(simplified.error, lods.back().error) });
+		}
+
+		std::string summary;
+		for (const auto& lod : lods) {
+			summary += std::format(" {} tris ({:.4f})", lod.indices.size() / 3, lod.error);
+		}
+		logInfo("Generated LODs:" + summary);
+	}
+
+	void MeshObject::updateDetail(const ViewParameters& view, const glm::mat4& model, const glm::mat4& modelViewProjection)
+	{
+		if (isEmpty) return;
+		if (geometry->lods.size() >= 2) {
+			selectLod(view, model);
+		}
+		if (!geometry->meshletLevels.empty()) {
+			cullMeshlets(view, model, modelViewProjection);
+		}
+	}
+
+	void MeshObject::flushDetail()
+	{
+		if (pendingIndices == nullptr) return;
+		RenderBackend::bufferData(*buffer, geometry->vertices, *pendingIndices);
+		pendingIndices = nullptr;
+	}
+
+	void MeshObject::selectLod(const ViewParameters& view, const glm::mat4& model)
+	{
+		const glm::vec3& boundsMin = geometry->boundsMin;
+		const glm::vec3& boundsMax = geometry->boundsMax;
+		glm::vec3 center = glm::vec3(model * glm::vec4((boundsMin + boundsMax) * 0.5f, 1.0f));
+		float worldScale = std::max({ glm::length(glm::vec3(model[0])), glm::length(glm::vec3(model[1])), glm::length(glm::vec3(model[2])) });
+		float radius = glm::length(boundsMax - boundsMin) * 0.5f * worldScale;
+
+		float distance = std::max(glm::length(center - view.cameraPosition) - radius, view.nearPlane);
+		float pixelsPerUnit = worldScale * view.projectionScale / distance;
+
+		// Coarsest level whose error stays under the budget. Going coarser needs some margin so a
+		// camera resting on the threshold does not flip levels every frame.
+		const std::vector<MeshLod>& lods = geometry->lods;
+		size_t level = 0;
+		for (size_t i = 1; i < lods.size(); i++) {
+			float budget = i > activeLod ? lodPixelError * 0.8f : lodPixelError;
+			if (lods[i].error * pixelsPerUnit > budget) break;
+			level = i;
+		}
+
+		if (level != activeLod) {
+			switchLod(level);
+		}
+	}
+
+	void MeshObject::switchLod(size_t level)
+	{
+		activeLod = level;
+		// The culling pass uploads whatever part of the new level is visible
+		if (!geometry->meshletLevels.empty()) return;
+
+		pendingIndices = &geometry->lods[level].indices;
+	}
+
+	void MeshObject::buildMeshlets(MeshGeometry& mesh, const BuildSettings& settings)
+	{
+		if (!settings.meshletCulling) return;
+
+		std::string summary;
+		auto build = [&](const std::vector<uint32_t>& levelIndices) {
+			mesh.meshletLevels.push_back(MeshletBuilder::build(levelIndices, &mesh.vertices[0].position[0], sizeof(Render::Vertex), mesh.vertices.size()));
+			summary += std::format(" {}", mesh.meshletLevels.back().meshlets.size());
+		};
+
+		if (mesh.lods.empty()) {
+			build(mesh.indices);
+		}
+		for (const auto& lod : mesh.lods) {
+			build(lod.indices);
+		}
+		logInfo("Built meshlets per level:" + summary);
+	}
+
+	void MeshObject::cullMeshlets(const ViewParameters& view, const glm::mat4& model, const glm::mat4& modelViewProjection)
+	{
+		const std::vector<MeshletMesh>& meshletLevels = geometry->meshletLevels;
+		const MeshletMesh& meshlets = meshletLevels[std::min(activeLod, meshletLevels.size() - 1)];
+
+		meshletStats = MeshletCuller::cull(meshlets, model, modelViewProjection, view.cameraPosition, nextVisibility);
+
+		// Only touch the buffer when the visible set actually changed
+		if (culledLevel == activeLod && nextVisibility == meshletVisibility) return;
+		meshletVisibility.swap(nextVisibility);
+		culledLevel = activeLod;
+
+		MeshletCuller::emitIndices(meshlets, meshletVisibility, culledIndices);
+		// Keep the buffer valid with a single degenerate triangle when nothing survives
+		if (culledIndices.empty()) {
+			culledIndices.assign(3, 0);
+		}
+		pendingIndices = &culledIndices;
+	}
+
+	uint64_t MeshObject::getBatchKey() const
+	{
+		// Objects streaming their own indices or holding a private copy draw on their own
+		if (isEmpty || ownsBuffer) return 0;
+		return hashBytes(&geometry->key, sizeof(geometry->key), texturePathHash);
+	}
+
+	bool MeshObject::getDrawResources(Render::Buffer*& bufferOutput, Render::DescriptorSet*& descriptorSetOutput) const
+	{
+		if (!registered) return false;
+		bufferOutput = buffer.get();
+		descriptorSetOutput = descriptorSet.get();
+		return true;
+	}
+
+	bool MeshObject::saveRecord(SceneObjectRecord& record, SceneFileWriter& writer) const
+	{
+		// Meshes built from vertex data have no source to point at
+		if (meshPath.empty()) return false;
+
+		record.mesh = writer.addAsset(SceneAssetKind::MESH, meshPath, getMeshContentHash());
+		if (!texturePath.empty()) record.texture = writer.addAsset(SceneAssetKind::TEXTURE, texturePath);
+		if (meshletCulling) record.flags |= SceneObjectRecord::MESHLET_CULLING;
+		return true;
+	}
+
+	void MeshObject::loadRecord(const SceneObjectRecord& record, const SceneFile& file)
+	{
+		// Settings first, they are part of the registry key
+		meshletCulling = (record.flags & SceneObjectRecord::MESHLET_CULLING) != 0;
+
+		if (const SceneAssetRecord* texture = file.getAsset(record.texture)) {
+			loadTextureFromFile(std::string(file.getPath(*texture)));
+		}
+		if (const SceneAssetRecord* mesh = file.getAsset(record.mesh)) {
+			loadMeshAsync(std::string(file.getPath(*mesh)), mesh->contentHash);
+		}
+	}
+
+	bool MeshObject::shouldOptimize() const
+	{
+		if (optimization == Optimization::GLOBAL) {
+			return globalOptimization;
+		}
+		return optimization == Optimization::ENABLED;
+	}
+
+	void MeshObject::optimizeVertexData(MeshGeometry& mesh, const BuildSettings& settings)
+	{
+		MeshOptimizeReport& optimizeReport = mesh.optimizeReport;
+		optimizeReport = MeshOptimizer::optimize(mesh.vertices, mesh.indices, settings.optimizeOptions, offsetof(Render::Vertex, position));
+
+		logInfo(std::format("Mesh optimized: ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f}, {} clusters{}",
+			optimizeReport.before.acmr, optimizeReport.after.acmr,
+			optimizeReport.before.atvr, optimizeReport.after.atvr,
+			optimizeReport.clusters, optimizeReport.overdrawApplied ? ", overdraw ordered" : ""));
+	}
+
+	void MeshObject::computeBounds(MeshGeometry& mesh)
+	{
+		if (mesh.vertices.empty()) {
+			mesh.boundsMin = mesh.boundsMax = glm::vec3(0.0f);
+			return;
+		}
+		mesh.boundsMin = mesh.boundsMax = mesh.vertices[0].position;
+		for (const auto& vertex : mesh.vertices) {
+			mesh.boundsMin = glm::min(mesh.boundsMin, vertex.position);
+			mesh.boundsMax = glm::max(mesh.boundsMax, vertex.position);
+		}
+	}
+
+	bool MeshObject::getLocalBounds(Aabb& bounds) const
+	{
+		if (!hasBounds) return false;
+		bounds = localBounds;
+		return true;
+	}
+
+	void MeshObject::hide()
+	{
+		// Render::RenderContext still draws every loaded buffer, collapse the mesh to a point so it rasterizes nothing
+		Render::UniformData hiddenData = { 0.0f, 1.0f, 1.0f };
+		RenderBackend::uniformData(*uniform, hiddenData);
 	}
 
 	void MeshObject::Register(Renderer* renderer)
@@ -49,65 +439,220 @@ namespace Starry
 			Alert("Cannot register empty mesh buffer!", FATAL);
 			return;
 		}
-		descriptorSet->addDescriptors({ uniform->getUUID(), textureImage->getUUID() });
+		RenderBackend::descriptorData(*descriptorSet, { uniform->getUUID(), textureImage->getUUID() });
 
 		renderer->context().Load(buffer);
 		renderer->context().Load(descriptorSet);
+		registered = true;
 	}
 
 	void MeshObject::Update(Renderer* renderer)
 	{
-		rotate(renderer->timer.getDeltaTimeSeconds() * 0.25 * glm::radians(90.0f), glm::vec3(0.0f, 1.0f, 0.0f));
-		uniform->setData(mvpBufferData);
+		rotate(renderer->getSimulationDeltaSeconds() * 0.25 * glm::radians(90.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+	}
+
+	void MeshObject::logInfo(const std::string& text)
+	{
+		AsyncLog::get().post(LogLevel::INFO, getAssetName() + ": " + text);
+	}
+
+	void MeshObject::uploadUniform(Render::UniformData& data)
+	{
+		RenderBackend::uniformData(*uniform, data);
 	}
 
 	void MeshObject::loadTextureFromFile(const std::string filePath)
 	{
-		textureImage->storeFilePath(filePath);
+		RenderBackend::textureFile(*textureImage, filePath);
+		texturePath = filePath;
+		texturePathHash = hashBytes(filePath.data(), filePath.size());
 	}
 
 	void MeshObject::loadMeshFromFile(const std::string filePath)
 	{
-		auto file = Request<FILETYPE>(FILE_Request, filePath, {Manager::FileFlags::READ | Manager::FileFlags::MODEL});
+		meshPath = filePath;
+		std::shared_ptr<MeshGeometry> mesh = buildFromFile(filePath, 0, buildSettings());
+		if (mesh == nullptr) return;
+
+		attachGeometry(std::move(mesh));
+	}
 
-		if (file.wait() != Manager::State::YES) {
+	std::shared_future<bool> MeshObject::loadMeshAsync(const std::string filePath, uint64_t expectedContentHash)
+	{
+		// One load in flight at a time, the last one asked for wins
+		cancelPendingMesh();
+		meshPath = filePath;
+		auto load = std::make_shared<PendingMesh>();
+		std::shared_future<bool> loaded = load->loaded.get_future().share();
+
+		// Something to register and draw while the mesh is on its way
+		if (geometry == nullptr) {
+			attachGeometry(placeholderGeometry(), true);
+		}
+
+		// Only the alerts, logs and content hash of the build touch the object, Destroy waits for those
+		AssetLoader::get().submit([this, load, filePath, expectedContentHash, settings = buildSettings()]() {
+			std::lock_guard<std::mutex> lock(load->mutex);
+			if (!load->cancelled) {
+				load->geometry = buildFromFile(filePath, expectedContentHash, settings);
+				if (load->geometry != nullptr && load->geometry->indices.empty()) {
+					Alert("Mesh file has no triangles.", CRITICAL);
+					load->geometry.reset();
+				}
+			}
+			// The object may take the geometry as soon as finished is set
+			load->loaded.set_value(load->geometry != nullptr);
+			load->finished.store(true, std::memory_order_release);
+		});
+
+		pendingMesh = std::move(load);
+		markLoadPending();
+		return loaded;
+	}
+
+	void MeshObject::cancelPendingMesh()
+	{
+		if (pendingMesh == nullptr) return;
+		{
+			// Not started yet, the loader skips it. Already running, the lock waits for it to finish.
+			std::lock_guard<std::mutex> lock(pendingMesh->mutex);
+			pendingMesh->cancelled = true;
+		}
+		pendingMesh.reset();
+	}
+
+	std::shared_ptr<MeshGeometry> MeshObject::buildFromFile(const std::string& filePath, uint64_t expectedContentHash, const BuildSettings& settings)
+	{
+		// Only the first build under the expected hash reads the file. A source changed since the hash was
+		// taken still loads its current content, filed under the old hash until the next save.
+		if (expectedContentHash != 0) {
+			std::shared_ptr<MeshGeometry> mesh = MeshRegistry::get().acquire(geometryKey(settings, expectedContentHash), [&](MeshGeometry& built) {
+				MappedFile source;
+				if (!source.open(filePath)) {
+					Alert("Could not open mesh file.", CRITICAL);
+					return false;
+				}
+				return importGeometry(filePath, source, hashBytes(source.data(), source.size()), settings, built);
+			});
+			if (mesh != nullptr) meshContentHash.store(expectedContentHash, std::memory_order_relaxed);
+			return mesh;
+		}
+
+		MappedFile source;
+		if (!source.open(filePath)) {
 			Alert("Could not open mesh file.", CRITICAL);
-			return;
+			return nullptr;
 		}
 
-		auto meshFile = dynamic_cast<Manager::ModelFile*>(*file);
+		uint64_t sourceHash = hashBytes(source.data(), source.size());
+		meshContentHash.store(sourceHash, std::memory_order_relaxed);
+		return MeshRegistry::get().acquire(geometryKey(settings, sourceHash), [&](MeshGeometry& built) {
+			return importGeometry(filePath, source, sourceHash, settings, built);
+		});
+	}
 
-		std::unordered_map<Render::Vertex, uint32_t> uniqueVertices{};
+	bool MeshObject::importGeometry(const std::string& filePath, const MappedFile& source, uint64_t sourceHash, const BuildSettings& settings, MeshGeometry& mesh)
+	{
+		STARRY_PROFILE_SCOPE("Mesh Import");
+		std::string cachePath = MeshCache::cachePathFor(filePath, settings.meshCacheDirectory, sourceHash);
 
-		for (const auto& shape : meshFile->shapes) {
-			for (const auto& index : shape.mesh.indices) {
-				Render::Vertex vertex{};
-				vertex.position = {
-					meshFile->attrib.vertices[3 * index.vertex_index + 0],
-					meshFile->attrib.vertices[3 * index.vertex_index + 1],
-					meshFile->attrib.vertices[3 * index.vertex_index + 2]
-				};
-				vertex.normal = {
-					meshFile->attrib.normals[3 * index.normal_index + 0],
-					meshFile->attrib.normals[3 * index.normal_index + 1],
-					meshFile->attrib.normals[3 * index.normal_index + 2]
-				};
+		uint32_t cacheFlags = settings.optimize ? MeshCache::FLAG_OPTIMIZED : 0;
+		uint64_t optionsHash = settings.optimize ? MeshOptimizer::hashOptions(settings.optimizeOptions) : 0;
 
-				vertex.texCoord = {
-					meshFile->attrib.texcoords[2 * index.texcoord_index + 0],
-					1.0f - meshFile->attrib.texcoords[2 * index.texcoord_index + 1]
+		if (settings.meshCaching) {
+			MeshCache cache;
+			if (cache.open(cachePath, sourceHash, source.size(), sizeof(Render::Vertex), cacheFlags, optionsHash)) {
+				auto cachedVertices = cache.vertices<Render::Vertex>();
+				auto cachedIndices = cache.indices();
+
+				// Buffer::loadData takes vectors, so this single copy out of the mapping is the only one
+				mesh.vertices.assign(cachedVertices.begin(), cachedVertices.end());
+				mesh.indices.assign(cachedIndices.begin(), cachedIndices.end());
+
+				const MeshCacheData& cached = cache.getData();
+				mesh.boundsMin = { cached.boundsMin[0], cached.boundsMin[1], cached.boundsMin[2] };
+				mesh.boundsMax = { cached.boundsMax[0], cached.boundsMax[1], cached.boundsMax[2] };
+				mesh.optimizeReport = cached.optimizeReport;
+
+				finishGeometry(mesh, settings);
+				return true;
+			}
+		}
+
+		ObjImporter importer;
+		ObjMeshData meshFile;
+
+		{
+			STARRY_PROFILE_SCOPE("Parse OBJ");
+			if (!importer.importMemory(source.data(), source.size(), meshFile)) {
+				Alert("Could not parse mesh file. " + importer.getError(), CRITICAL);
+				return false;
+			}
+		}
+
+		std::vector<Render::Vertex> corners(meshFile.corners.size());
+		size_t threads = corners.size() < WeldEngine::PARALLEL_THRESHOLD ? 1 : defaultThreadCount();
+
+		parallelRanges(corners.size(), threads, [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; i++) {
+				const ObjCorner& corner = meshFile.corners[i];
+				Render::Vertex& vertex = corners[i];
+
+				vertex.position = {
+					meshFile.positions[3 * corner.position + 0],
+					meshFile.positions[3 * corner.position + 1],
+					meshFile.positions[3 * corner.position + 2]
 				};
+				if (corner.normal >= 0) {
+					vertex.normal = {
+						meshFile.normals[3 * corner.normal + 0],
+						meshFile.normals[3 * corner.normal + 1],
+						meshFile.normals[3 * corner.normal + 2]
+					};
+				}
+				if (corner.texCoord >= 0) {
+					vertex.texCoord = {
+						meshFile.texCoords[2 * corner.texCoord + 0],
+						1.0f - meshFile.texCoords[2 * corner.texCoord + 1]
+					};
+				}
 				vertex.color = { 1.0f, 1.0f, 1.0f };
+			}
+		});
 
-				if (uniqueVertices.count(vertex) == 0) {
-					uniqueVertices[vertex] = static_cast<uint32_t>(vertices.size());
-					vertices.push_back(vertex);
-				}
+		{
+			STARRY_PROFILE_SCOPE("Weld");
+			WeldEngine::weldParallel(corners.data(), corners.size(), mesh.vertices, mesh.indices, threads);
+		}
+		computeBounds(mesh);
 
-				indices.push_back(uniqueVertices[vertex]);
-			}
+		if (settings.optimize) {
+			STARRY_PROFILE_SCOPE("Optimize");
+			optimizeVertexData(mesh, settings);
 		}
+		finishGeometry(mesh, settings);
+
+		if (settings.meshCaching) {
+			MeshCacheData cooked{};
+			cooked.vertices = mesh.vertices.data();
+			cooked.vertexStride = sizeof(Render::Vertex);
+			cooked.vertexCount = mesh.vertices.size();
+			cooked.indices = mesh.indices.data();
+			cooked.indexCount = mesh.indices.size();
+			cooked.sourceHash = sourceHash;
+			cooked.flags = cacheFlags;
+			cooked.optionsHash = optionsHash;
+			cooked.optimizeReport = mesh.optimizeReport;
+			for (int i = 0; i < 3; i++) {
+				cooked.boundsMin[i] = mesh.boundsMin[i];
+				cooked.boundsMax[i] = mesh.boundsMax[i];
+			}
 
-		addVertexData(vertices, indices);
+			STARRY_PROFILE_SCOPE("Write Mesh Cache");
+			if (!MeshCache::write(cachePath, cooked, source.size())) {
+				logInfo("Could not write mesh cache to " + cachePath);
+			}
+		}
+		return true;
 	}
 }
\ No newline at end of file
@@ -0,0 +1,252 @@
+#include "MeshOptimizer.h"
+
+#include "ContentHash.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <numeric>
+
+namespace Starry
+{
+	uint64_t MeshOptimizer::hashOptions(const MeshOptimizeOptions& options)
+	{
+		// Field by field, the struct has padding
+		uint32_t values[] = {
+			options.vertexCache, options.overdraw, options.vertexFetch, options.cacheSize, std::bit_cast<uint32_t>(options.overdrawThreshold)
+		};
+		return hashBytes(values, sizeof(values));
+	}
+
+	VertexCacheStats MeshOptimizer::analyzeVertexCache(const std::vector<uint32_t>& indices, size_t vertexCount, uint32_t cacheSize)
+	{
+		VertexCacheStats stats{};
+		size_t triangleCount = indices.size() / 3;
+		if (triangleCount == 0 || vertexCount == 0) return stats;
+
+		// A vertex is resident while fewer than cacheSize misses happened since it was loaded
+		std::vector<uint64_t> loadedAt(vertexCount, 0);
+		uint64_t misses = 0;
+		size_t referenced = 0;
+
+		for (uint32_t index : indices) {
+			uint64_t loaded = loadedAt[index];
+			if (loaded == 0) referenced++;
+
+			if (loaded == 0 || misses + 1 - loaded >= cacheSize) {
+				misses++;
+				loadedAt[index] = misses;
+			}
+		}
+
+		stats.acmr = static_cast<float>(misses) / static_cast<float>(triangleCount);
+		stats.atvr = referenced == 0 ? 0.0f : static_cast<float>(misses) / static_cast<float>(referenced);
+		return stats;
+	}
+
+	void MeshOptimizer::optimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexCount, uint32_t cacheSize,
+		std::vector<uint32_t>* clusterStarts)
+	{
+		size_t triangleCount = indices.size() / 3;
+		if (clusterStarts != nullptr) clusterStarts->clear();
+		if (triangleCount == 0 || vertexCount == 0) return;
+
+		// Vertex to triangle adjacency, CSR style
+		std::vector<uint32_t> live(vertexCount, 0);
+		for (size_t i = 0; i < triangleCount * 3; i++) {
+			live[indices[i]]++;
+		}
+		std::vector<uint32_t> offsets(vertexCount + 1, 0);
+		for (size_t v = 0; v < vertexCount; v++) {
+			offsets[v + 1] = offsets[v] + live[v];
+		}
+		std::vector<uint32_t> adjacency(offsets[vertexCount]);
+		{
+			std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+			for (size_t t = 0; t < triangleCount; t++) {
+				for (int c = 0; c < 3; c++) {
+					adjacency[fill[indices[t * 3 + c]]++] = static_cast<uint32_t>(t);
+				}
+			}
+		}
+
+		std::vector<uint32_t> output;
+		output.reserve(triangleCount * 3);
+
+		std::vector<uint64_t> cacheTime(vertexCount, 0);
+		std::vector<bool> emitted(triangleCount, false);
+		std::vector<uint32_t> deadEnd;
+		std::vector<uint32_t> candidates;
+		deadEnd.reserve(vertexCount);
+
+		uint64_t time = cacheSize + 1;
+		size_t cursor = 0;
+
+		auto skipDeadEnd = [&]() -> int64_t {
+			while (!deadEnd.empty()) {
+				uint32_t vertex = deadEnd.back();
+				deadEnd.pop_back();
+				if (live[vertex] > 0) return vertex;
+			}
+			while (cursor < vertexCount) {
+				if (live[cursor] > 0) return static_cast<int64_t>(cursor);
+				cursor++;
+			}
+			return -1;
+		};
+
+		int64_t fanning = skipDeadEnd();
+		if (clusterStarts != nullptr && fanning >= 0) clusterStarts->push_back(0);
+
+		while (fanning >= 0) {
+			candidates.clear();
+
+			for (uint32_t a = offsets[fanning]; a < offsets[fanning + 1]; a++) {
+				uint32_t triangle = adjacency[a];
+				if (emitted[triangle]) continue;
+				emitted[triangle] = true;
+
+				for (int c = 0; c < 3; c++) {
+					uint32_t vertex = indices[triangle * 3 + c];
+					output.push_back(vertex);
+					deadEnd.push_back(vertex);
+					candidates.push_back(vertex);
+					live[vertex]--;
+
+					if (time - cacheTime[vertex] > cacheSize) {
+						cacheTime[vertex] = time;
+						time++;
+					}
+				}
+			}
+
+			// Prefer the candidate that will still be in the cache after its remaining triangles are emitted
+			int64_t best = -1;
+			int64_t bestPriority = -1;
+			for (uint32_t vertex : candidates) {
+				if (live[vertex] == 0) continue;
+
+				int64_t priority = 0;
+				if (time - cacheTime[vertex] + 2 * static_cast<uint64_t>(live[vertex]) <= cacheSize) {
+					priority = static_cast<int64_t>(time - cacheTime[vertex]);
+				}
+				if (priority > bestPriority) {
+					bestPriority = priority;
+					best = vertex;
+				}
+			}
+
+			if (best < 0) {
+				best = skipDeadEnd();
+				if (clusterStarts != nullptr && best >= 0) {
+					clusterStarts->push_back(static_cast<uint32_t>(output.size() / 3));
+				}
+			}
+			fanning = best;
+		}
+
+		indices = std::move(output);
+	}
+
+	void MeshOptimizer::optimizeOverdraw(std::vector<uint32_t>& indices, const std::vector<uint32_t>& clusterStarts,
+		const float* positions, size_t positionStride, size_t vertexCount)
+	{
+		size_t triangleCount = indices.size() / 3;
+		if (triangleCount == 0 || clusterStarts.size() < 2 || vertexCount == 0) return;
+
+		auto position = [&](uint32_t vertex) {
+			return reinterpret_cast<const float*>(reinterpret_cast<const char*>(positions) + vertex * positionStride);
+		};
+
+		struct Cluster {
+			uint32_t begin;
+			uint32_t end;
+			float centroid[3];
+			float normal[3];
+			float sortKey;
+		};
+
+		std::vector<Cluster> clusters(clusterStarts.size());
+		double meshCentroid[3] = { 0.0, 0.0, 0.0 };
+		double meshArea = 0.0;
+
+		for (size_t c = 0; c < clusters.size(); c++) {
+			Cluster& cluster = clusters[c];
+			cluster.begin = clusterStarts[c];
+			cluster.end = c + 1 < clusterStarts.size() ? clusterStarts[c + 1] : static_cast<uint32_t>(triangleCount);
+
+			double centroid[3] = { 0.0, 0.0, 0.0 };
+			double normal[3] = { 0.0, 0.0, 0.0 };
+			double area = 0.0;
+
+			for (uint32_t t = cluster.begin; t < cluster.end; t++) {
+				const float* a = position(indices[t * 3 + 0]);
+				const float* b = position(indices[t * 3 + 1]);
+				const float* d = position(indices[t * 3 + 2]);
+
+				float ab[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+				float ad[3] = { d[0] - a[0], d[1] - a[1], d[2] - a[2] };
+				float n[3] = {
+					ab[1] * ad[2] - ab[2] * ad[1],
+					ab[2] * ad[0] - ab[0] * ad[2],
+					ab[0] * ad[1] - ab[1] * ad[0]
+				};
+				double triangleArea = std::sqrt(static_cast<double>(n[0]) * n[0] + static_cast<double>(n[1]) * n[1] + static_cast<double>(n[2]) * n[2]);
+
+				for (int k = 0; k < 3; k++) {
+					centroid[k] += triangleArea * (a[k] + b[k] + d[k]) / 3.0;
+					normal[k] += n[k];
+				}
+				area += triangleArea;
+			}
+
+			for (int k = 0; k < 3; k++) {
+				meshCentroid[k] += centroid[k];
+				cluster.centroid[k] = area > 0.0 ? static_cast<float>(centroid[k] / area) : 0.0f;
+				cluster.normal[k] = static_cast<float>(normal[k]);
+			}
+			meshArea += area;
+		}
+
+		for (int k = 0; k < 3; k++) {
+			meshCentroid[k] = meshArea > 0.0 ? meshCentroid[k] / meshArea : 0.0;
+		}
+
+		// Clusters that face away from the mesh center occlude the rest from most viewpoints
+		for (auto& cluster : clusters) {
+			float length = std::sqrt(cluster.normal[0] * cluster.normal[0] + cluster.normal[1] * cluster.normal[1] + cluster.normal[2] * cluster.normal[2]);
+			float key = 0.0f;
+			if (length > 0.0f) {
+				for (int k = 0; k < 3; k++) {
+					key += (cluster.centroid[k] - static_cast<float>(meshCentroid[k])) * cluster.normal[k] / length;
+				}
+			}
+			cluster.sortKey = key;
+		}
+
+		std::stable_sort(clusters.begin(), clusters.end(), [](const Cluster& a, const Cluster& b) {
+			return a.sortKey > b.sortKey;
+		});
+
+		std::vector<uint32_t> output;
+		output.reserve(indices.size());
+		for (const auto& cluster : clusters) {
+			output.insert(output.end(), indices.begin() + cluster.begin * 3, indices.begin() + cluster.end * 3);
+		}
+		indices = std::move(output);
+	}
+
+	size_t MeshOptimizer::optimizeVertexFetch(std::vector<uint32_t>& indices, size_t vertexCount, std::vector<uint32_t>& remap)
+	{
+		remap.assign(vertexCount, INVALID_INDEX);
+
+		uint32_t next = 0;
+		for (auto& index : indices) {
+			if (remap[index] == INVALID_INDEX) {
+				remap[index] = next++;
+			}
+			index = remap[index];
+		}
+		return next;
+	}
+}
@@ -0,0 +1,72 @@
+#include "MeshRegistry.h"
+
+namespace Starry
+{
+	size_t MeshGeometry::memoryBytes() const
+	{
+		size_t bytes = vertices.size() * sizeof(Render::Vertex) + indices.size() * sizeof(uint32_t);
+		for (const auto& lod : lods) {
+			bytes += lod.indices.size() * sizeof(uint32_t);
+		}
+		for (const auto& level : meshletLevels) {
+			bytes += level.meshlets.size() * sizeof(Meshlet) + level.vertices.size() * sizeof(uint32_t) + level.triangles.size();
+		}
+		return bytes;
+	}
+
+	MeshRegistry& MeshRegistry::get()
+	{
+		static MeshRegistry registry;
+		return registry;
+	}
+
+	std::shared_ptr<MeshGeometry> MeshRegistry::acquire(uint64_t key, const std::function<bool(MeshGeometry&)>& build)
+	{
+		std::shared_ptr<std::mutex> building;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			requests++;
+			Entry& entry = entries[key];
+			if (auto geometry = entry.geometry.lock()) return geometry;
+			building = entry.building;
+		}
+
+		// One build per key, whoever comes second picks up the result
+		std::lock_guard<std::mutex> buildLock(*building);
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if (auto geometry = entries[key].geometry.lock()) return geometry;
+		}
+
+		auto geometry = std::make_shared<MeshGeometry>();
+		geometry->key = key;
+		if (!build(*geometry)) return nullptr;
+
+		std::lock_guard<std::mutex> lock(mutex);
+		entries[key].geometry = geometry;
+		builds++;
+		return geometry;
+	}
+
+	MeshRegistryStats MeshRegistry::getStats() const
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+
+		MeshRegistryStats stats{};
+		stats.requests = requests;
+		stats.builds = builds;
+		for (const auto& entry : entries) {
+			auto geometry = entry.second.geometry.lock();
+			if (geometry == nullptr) continue;
+
+			// Minus the reference taken just above
+			size_t references = static_cast<size_t>(geometry.use_count()) - 1;
+			size_t bytes = geometry->memoryBytes();
+			stats.meshes++;
+			stats.references += references;
+			stats.bytes += bytes;
+			stats.unsharedBytes += bytes * references;
+		}
+		return stats;
+	}
+}
@@ -0,0 +1,350 @@
+#include "MeshSimplifier.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <queue>
+#include <unordered_map>
+
+namespace Starry
+{
+	namespace
+	{
+		// Symmetric 4x4 plane quadric, upper triangle, plus the area that built it
+		struct Quadric {
+			double a2 = 0, ab = 0, ac = 0, ad = 0;
+			double b2 = 0, bc = 0, bd = 0;
+			double c2 = 0, cd = 0;
+			double d2 = 0;
+			double weight = 0;
+
+			void addPlane(double a, double b, double c, double d, double w)
+			{
+				a2 += w * a * a; ab += w * a * b; ac += w * a * c; ad += w * a * d;
+				b2 += w * b * b; bc += w * b * c; bd += w * b * d;
+				c2 += w * c * c; cd += w * c * d;
+				d2 += w * d * d;
+				weight += w;
+			}
+
+			void add(const Quadric& other)
+			{
+				a2 += other.a2; ab += other.ab; ac += other.ac; ad += other.ad;
+				b2 += other.b2; bc += other.bc; bd += other.bd;
+				c2 += other.c2; cd += other.cd;
+				d2 += other.d2;
+				weight += other.weight;
+			}
+
+			double evaluate(const float* p) const
+			{
+				double x = p[0], y = p[1], z = p[2];
+				double result = a2 * x * x + 2 * ab * x * y + 2 * ac * x * z + 2 * ad * x
+					+ b2 * y * y + 2 * bc * y * z + 2 * bd * y
+					+ c2 * z * z + 2 * cd * z
+					+ d2;
+				return std::max(result, 0.0);
+			}
+		};
+
+		struct Collapse {
+			double cost;
+			uint32_t from;
+			uint32_t to;
+			uint32_t fromVersion;
+			uint32_t toVersion;
+
+			bool operator>(const Collapse& other) const { return cost > other.cost; }
+		};
+
+		struct Triangle {
+			uint32_t rep[3];
+			uint32_t vertex[3];
+			bool alive;
+		};
+
+		const double BORDER_WEIGHT = 10.0;
+
+		inline void sub(const float* a, const float* b, double out[3])
+		{
+			out[0] = double(a[0]) - b[0];
+			out[1] = double(a[1]) - b[1];
+			out[2] = double(a[2]) - b[2];
+		}
+
+		inline void cross(const double a[3], const double b[3], double out[3])
+		{
+			out[0] = a[1] * b[2] - a[2] * b[1];
+			out[1] = a[2] * b[0] - a[0] * b[2];
+			out[2] = a[0] * b[1] - a[1] * b[0];
+		}
+
+		inline double dot(const double a[3], const double b[3]) { return a[0] * b[0] + a[1] * b[1] + a[2] * b[2]; }
+	}
+
+	SimplifyResult MeshSimplifier::simplify(const SimplifyInput& input, size_t targetIndexCount, float maxError)
+	{
+		SimplifyResult result{};
+		const std::vector<uint32_t>& indices = *input.indices;
+		size_t triangleCount = indices.size() / 3;
+		size_t vertexCount = input.vertexCount;
+
+		if (triangleCount == 0 || vertexCount == 0 || targetIndexCount >= indices.size()) {
+			result.indices = indices;
+			return result;
+		}
+
+		auto position = [&](uint32_t v) {
+			return reinterpret_cast<const float*>(reinterpret_cast<const char*>(input.positions) + v * input.positionStride);
+		};
+
+		// Vertices that share a position collapse together, so topology is built on position representatives
+		std::vector<uint32_t> rep(vertexCount);
+		{
+			struct PositionKey {
+				float p[3];
+				bool operator==(const PositionKey& other) const { return std::memcmp(p, other.p, sizeof(p)) == 0; }
+			};
+			struct PositionHash {
+				size_t operator()(const PositionKey& key) const
+				{
+					uint32_t bits[3];
+					std::memcpy(bits, key.p, sizeof(bits));
+					return (bits[0] * 73856093u) ^ (bits[1] * 19349663u) ^ (bits[2] * 83492791u);
+				}
+			};
+
+			std::unordered_map<PositionKey, uint32_t, PositionHash> firstByPosition;
+			firstByPosition.reserve(vertexCount);
+			for (uint32_t v = 0; v < vertexCount; v++) {
+				PositionKey key{};
+				std::memcpy(key.p, position(v), sizeof(key.p));
+				rep[v] = firstByPosition.emplace(key, v).first->second;
+			}
+		}
+
+		// Wedges: every vertex sharing a representative, used to pick attributes after a collapse
+		std::vector<uint32_t> wedgeOffsets(vertexCount + 1, 0);
+		std::vector<uint32_t> wedges(vertexCount);
+		for (uint32_t v = 0; v < vertexCount; v++) wedgeOffsets[rep[v] + 1]++;
+		for (size_t v = 0; v < vertexCount; v++) wedgeOffsets[v + 1] += wedgeOffsets[v];
+		{
+			std::vector<uint32_t> fill(wedgeOffsets.begin(), wedgeOffsets.end() - 1);
+			for (uint32_t v = 0; v < vertexCount; v++) wedges[fill[rep[v]]++] = v;
+		}
+
+		std::vector<Triangle> triangles(triangleCount);
+		std::vector<std::vector<uint32_t>> vertexTriangles(vertexCount);
+		std::vector<Quadric> quadrics(vertexCount);
+
+		size_t aliveTriangles = 0;
+		for (size_t t = 0; t < triangleCount; t++) {
+			Triangle& triangle = triangles[t];
+			for (int c = 0; c < 3; c++) {
+				triangle.vertex[c] = indices[t * 3 + c];
+				triangle.rep[c] = rep[triangle.vertex[c]];
+			}
+			triangle.alive = triangle.rep[0] != triangle.rep[1] && triangle.rep[1] != triangle.rep[2] && triangle.rep[0] != triangle.rep[2];
+			if (!triangle.alive) continue;
+			aliveTriangles++;
+
+			const float* p0 = position(triangle.rep[0]);
+			const float* p1 = position(triangle.rep[1]);
+			const float* p2 = position(triangle.rep[2]);
+			double e1[3], e2[3], normal[3];
+			sub(p1, p0, e1);
+			sub(p2, p0, e2);
+			cross(e1, e2, normal);
+			double length = std::sqrt(dot(normal, normal));
+			if (length > 0.0) {
+				for (double& n : normal) n /= length;
+				double d = -(normal[0] * p0[0] + normal[1] * p0[1] + normal[2] * p0[2]);
+				double area = length * 0.5;
+				for (int c = 0; c < 3; c++) {
+					quadrics[triangle.rep[c]].addPlane(normal[0], normal[1], normal[2], d, area);
+				}
+			}
+
+			for (int c = 0; c < 3; c++) {
+				vertexTriangles[triangle.rep[c]].push_back(static_cast<uint32_t>(t));
+			}
+		}
+
+		// Border edges (one adjacent triangle) get a perpendicular plane so outlines are held in place
+		{
+			std::unordered_map<uint64_t, int> edgeUse;
+			edgeUse.reserve(aliveTriangles * 3);
+			auto edgeKey = [](uint32_t a, uint32_t b) {
+				if (a > b) std::swap(a, b);
+				return (static_cast<uint64_t>(a) << 32) | b;
+			};
+			for (const auto& triangle : triangles) {
+				if (!triangle.alive) continue;
+				for (int c = 0; c < 3; c++) edgeUse[edgeKey(triangle.rep[c], triangle.rep[(c + 1) % 3])]++;
+			}
+			for (const auto& triangle : triangles) {
+				if (!triangle.alive) continue;
+
+				double e1[3], e2[3], normal[3];
+				sub(position(triangle.rep[1]), position(triangle.rep[0]), e1);
+				sub(position(triangle.rep[2]), position(triangle.rep[0]), e2);
+				cross(e1, e2, normal);
+
+				for (int c = 0; c < 3; c++) {
+					uint32_t a = triangle.rep[c];
+					uint32_t b = triangle.rep[(c + 1) % 3];
+					if (edgeUse[edgeKey(a, b)] != 1) continue;
+
+					double edge[3], plane[3];
+					sub(position(b), position(a), edge);
+					cross(edge, normal, plane);
+					double length = std::sqrt(dot(plane, plane));
+					if (length <= 0.0) continue;
+					for (double& n : plane) n /= length;
+
+					const float* pa = position(a);
+					double d = -(plane[0] * pa[0] + plane[1] * pa[1] + plane[2] * pa[2]);
+					double weight = std::sqrt(dot(edge, edge)) * BORDER_WEIGHT;
+					quadrics[a].addPlane(plane[0], plane[1], plane[2], d, weight);
+					quadrics[b].addPlane(plane[0], plane[1], plane[2], d, weight);
+				}
+			}
+		}
+
+		std::vector<uint32_t> versions(vertexCount, 0);
+		std::vector<uint32_t> collapsedTo(vertexCount);
+		for (uint32_t v = 0; v < vertexCount; v++) collapsedTo[v] = v;
+
+		auto collapseCost = [&](uint32_t from, uint32_t to) {
+			Quadric combined = quadrics[from];
+			combined.add(quadrics[to]);
+			if (combined.weight <= 0.0) return 0.0;
+			return combined.evaluate(position(to)) / combined.weight;
+		};
+
+		std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>> queue;
+		auto pushEdges = [&](uint32_t vertex) {
+			for (uint32_t t : vertexTriangles[vertex]) {
+				const Triangle& triangle = triangles[t];
+				if (!triangle.alive) continue;
+				for (int c = 0; c < 3; c++) {
+					uint32_t other = triangle.rep[c];
+					if (other == vertex) continue;
+					queue.push({ collapseCost(vertex, other), vertex, other, versions[vertex], versions[other] });
+					queue.push({ collapseCost(other, vertex), other, vertex, versions[other], versions[vertex] });
+				}
+			}
+		};
+		for (uint32_t v = 0; v < vertexCount; v++) {
+			if (rep[v] == v && !vertexTriangles[v].empty()) pushEdges(v);
+		}
+
+		// Moving `from` onto `to` must not flip any triangle that survives
+		auto flips = [&](uint32_t from, uint32_t to) {
+			for (uint32_t t : vertexTriangles[from]) {
+				const Triangle& triangle = triangles[t];
+				if (!triangle.alive) continue;
+				if (triangle.rep[0] == to || triangle.rep[1] == to || triangle.rep[2] == to) continue;
+
+				const float* before[3];
+				const float* after[3];
+				for (int c = 0; c < 3; c++) {
+					before[c] = position(triangle.rep[c]);
+					after[c] = triangle.rep[c] == from ? position(to) : before[c];
+				}
+				double e1[3], e2[3], n0[3], n1[3];
+				sub(before[1], before[0], e1);
+				sub(before[2], before[0], e2);
+				cross(e1, e2, n0);
+				sub(after[1], after[0], e1);
+				sub(after[2], after[0], e2);
+				cross(e1, e2, n1);
+				if (dot(n0, n1) <= 0.0) return true;
+			}
+			return false;
+		};
+
+		double maxErrorSquared = static_cast<double>(maxError) * maxError;
+		double worstCost = 0.0;
+		size_t targetTriangles = targetIndexCount / 3;
+
+		while (aliveTriangles > targetTriangles && !queue.empty()) {
+			Collapse collapse = queue.top();
+			queue.pop();
+
+			if (collapse.fromVersion != versions[collapse.from] || collapse.toVersion != versions[collapse.to]) continue;
+			if (collapsedTo[collapse.from] != collapse.from || collapsedTo[collapse.to] != collapse.to) continue;
+			if (collapse.cost > maxErrorSquared) break;
+			if (flips(collapse.from, collapse.to)) continue;
+
+			uint32_t from = collapse.from;
+			uint32_t to = collapse.to;
+
+			for (uint32_t t : vertexTriangles[from]) {
+				Triangle& triangle = triangles[t];
+				if (!triangle.alive) continue;
+
+				bool sharesTo = triangle.rep[0] == to || triangle.rep[1] == to || triangle.rep[2] == to;
+				if (sharesTo) {
+					triangle.alive = false;
+					aliveTriangles--;
+					continue;
+				}
+				for (int c = 0; c < 3; c++) {
+					if (triangle.rep[c] == from) triangle.rep[c] = to;
+				}
+				vertexTriangles[to].push_back(t);
+			}
+			vertexTriangles[from].clear();
+
+			quadrics[to].add(quadrics[from]);
+			collapsedTo[from] = to;
+			versions[from]++;
+			versions[to]++;
+			worstCost = std::max(worstCost, collapse.cost);
+
+			// Only collapses touching `to` changed cost, the version bump above retires them
+			auto& toTriangles = vertexTriangles[to];
+			toTriangles.erase(std::remove_if(toTriangles.begin(), toTriangles.end(),
+				[&](uint32_t t) { return !triangles[t].alive; }), toTriangles.end());
+			pushEdges(to);
+		}
+
+		// Pick, for every surviving corner, the wedge at its new position closest to its original attributes
+		auto pickWedge = [&](uint32_t original, uint32_t target) {
+			if (rep[original] == target) return original;
+			uint32_t best = wedges[wedgeOffsets[target]];
+			if (input.attributes == nullptr) return best;
+
+			auto attribute = [&](uint32_t v) {
+				return reinterpret_cast<const float*>(reinterpret_cast<const char*>(input.attributes) + v * input.attributeStride);
+			};
+			const float* reference = attribute(original);
+			double bestDistance = std::numeric_limits<double>::max();
+			for (uint32_t w = wedgeOffsets[target]; w < wedgeOffsets[target + 1]; w++) {
+				const float* candidate = attribute(wedges[w]);
+				double distance = 0.0;
+				for (size_t k = 0; k < input.attributeCount; k++) {
+					double delta = double(candidate[k]) - reference[k];
+					distance += delta * delta;
+				}
+				if (distance < bestDistance) {
+					bestDistance = distance;
+					best = wedges[w];
+				}
+			}
+			return best;
+		};
+
+		result.indices.reserve(aliveTriangles * 3);
+		for (const auto& triangle : triangles) {
+			if (!triangle.alive) continue;
+			for (int c = 0; c < 3; c++) {
+				result.indices.push_back(pickWedge(triangle.vertex[c], triangle.rep[c]));
+			}
+		}
+		result.error = static_cast<float>(std::sqrt(worstCost));
+		return result;
+	}
+}
@@ -0,0 +1,204 @@
+#include "Meshlet.h"
+
+#include "Frustum.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Starry
+{
+	namespace
+	{
+		glm::vec3 positionAt(const float* positions, size_t positionStride, uint32_t index)
+		{
+			const float* position = reinterpret_cast<const float*>(reinterpret_cast<const char*>(positions) + positionStride * index);
+			return { position[0], position[1], position[2] };
+		}
+
+		// Ritter's bounding sphere, within a few percent of the minimal one
+		void computeSphere(Meshlet& meshlet, const std::vector<glm::vec3>& points)
+		{
+			auto farthestFrom = [&](const glm::vec3& origin) {
+				size_t best = 0;
+				float bestDistance = -1.0f;
+				for (size_t i = 0; i < points.size(); i++) {
+					glm::vec3 offset = points[i] - origin;
+					float distance = glm::dot(offset, offset);
+					if (distance > bestDistance) {
+						bestDistance = distance;
+						best = i;
+					}
+				}
+				return points[best];
+			};
+
+			glm::vec3 a = farthestFrom(points[0]);
+			glm::vec3 b = farthestFrom(a);
+
+			glm::vec3 center = (a + b) * 0.5f;
+			float radius = glm::length(b - a) * 0.5f;
+
+			for (const auto& point : points) {
+				float distance = glm::length(point - center);
+				if (distance > radius) {
+					float grown = (radius + distance) * 0.5f;
+					center += (point - center) * ((grown - radius) / distance);
+					radius = grown;
+				}
+			}
+
+			meshlet.center = center;
+			meshlet.radius = radius;
+		}
+
+		void computeCone(Meshlet& meshlet, const std::vector<glm::vec3>& normals)
+		{
+			meshlet.coneAxis = glm::vec3(0.0f);
+			meshlet.coneCutoff = 1.0f;
+
+			glm::vec3 sum(0.0f);
+			for (const auto& normal : normals) {
+				sum += normal;
+			}
+			float length = glm::length(sum);
+			if (normals.empty() || length < 1e-6f) return;
+
+			glm::vec3 axis = sum / length;
+			float minDot = 1.0f;
+			for (const auto& normal : normals) {
+				minDot = std::min(minDot, glm::dot(axis, normal));
+			}
+
+			// Past roughly 84 degrees the cone is so wide it would almost never cull anything
+			if (minDot <= 0.1f) return;
+
+			meshlet.coneAxis = axis;
+			meshlet.coneCutoff = std::sqrt(1.0f - minDot * minDot);
+		}
+
+		void computeBounds(Meshlet& meshlet, const MeshletMesh& mesh, const float* positions, size_t positionStride,
+			std::vector<glm::vec3>& points, std::vector<glm::vec3>& normals)
+		{
+			points.clear();
+			for (uint32_t i = 0; i < meshlet.vertexCount; i++) {
+				points.push_back(positionAt(positions, positionStride, mesh.vertices[meshlet.vertexOffset + i]));
+			}
+
+			normals.clear();
+			for (uint32_t i = 0; i < meshlet.triangleCount; i++) {
+				const uint8_t* triangle = &mesh.triangles[meshlet.triangleOffset + 3 * i];
+				glm::vec3 normal = glm::cross(points[triangle[1]] - points[triangle[0]], points[triangle[2]] - points[triangle[0]]);
+				float area = glm::length(normal);
+				// Degenerate triangles face nowhere and are never drawn
+				if (area > 0.0f) normals.push_back(normal / area);
+			}
+
+			computeSphere(meshlet, points);
+			computeCone(meshlet, normals);
+		}
+	}
+
+	MeshletMesh MeshletBuilder::build(const std::vector<uint32_t>& indices, const float* positions, size_t positionStride,
+		size_t vertexCount, size_t maxVertices, size_t maxTriangles)
+	{
+		maxVertices = std::clamp<size_t>(maxVertices, 3, 256);
+		maxTriangles = std::max<size_t>(maxTriangles, 1);
+
+		MeshletMesh mesh;
+		mesh.vertices.reserve(indices.size());
+		mesh.triangles.reserve(indices.size());
+
+		// stamp[v] holds the meshlet that last used v, so the local map never needs clearing
+		std::vector<uint32_t> stamp(vertexCount, ~0u);
+		std::vector<uint8_t> local(vertexCount, 0);
+
+		std::vector<glm::vec3> points;
+		std::vector<glm::vec3> normals;
+
+		Meshlet current{};
+		uint32_t currentId = 0;
+
+		auto finish = [&]() {
+			if (current.triangleCount == 0) return;
+			computeBounds(current, mesh, positions, positionStride, points, normals);
+			mesh.meshlets.push_back(current);
+
+			current = Meshlet{};
+			current.vertexOffset = static_cast<uint32_t>(mesh.vertices.size());
+			current.triangleOffset = static_cast<uint32_t>(mesh.triangles.size());
+			currentId++;
+		};
+
+		for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+			uint32_t a = indices[i + 0];
+			uint32_t b = indices[i + 1];
+			uint32_t c = indices[i + 2];
+
+			size_t added = (stamp[a] != currentId) + (stamp[b] != currentId && b != a) + (stamp[c] != currentId && c != a && c != b);
+			if (current.vertexCount + added > maxVertices || current.triangleCount + 1 > maxTriangles) {
+				finish();
+			}
+
+			for (uint32_t vertex : { a, b, c }) {
+				if (stamp[vertex] != currentId) {
+					stamp[vertex] = currentId;
+					local[vertex] = static_cast<uint8_t>(current.vertexCount++);
+					mesh.vertices.push_back(vertex);
+				}
+				mesh.triangles.push_back(local[vertex]);
+			}
+			current.triangleCount++;
+		}
+		finish();
+
+		return mesh;
+	}
+
+	MeshletCullStats MeshletCuller::cull(const MeshletMesh& mesh, const glm::mat4& model, const glm::mat4& modelViewProjection,
+		const glm::vec3& cameraPosition, std::vector<uint8_t>& visibility)
+	{
+		// Everything is tested in object space so the meshlet bounds never need transforming
+		Frustum frustum(modelViewProjection);
+		glm::vec3 eye = glm::vec3(glm::inverse(model) * glm::vec4(cameraPosition, 1.0f));
+
+		MeshletCullStats stats{};
+		stats.meshlets = mesh.meshlets.size();
+		visibility.assign(mesh.meshlets.size(), 0);
+
+		for (size_t i = 0; i < mesh.meshlets.size(); i++) {
+			const Meshlet& meshlet = mesh.meshlets[i];
+			stats.triangles += meshlet.triangleCount;
+
+			if (!frustum.intersectsSphere(meshlet.center, meshlet.radius)) {
+				stats.frustumCulled++;
+				continue;
+			}
+
+			glm::vec3 toCenter = meshlet.center - eye;
+			if (glm::dot(toCenter, meshlet.coneAxis) >= meshlet.coneCutoff * glm::length(toCenter) + meshlet.radius) {
+				stats.backfaceCulled++;
+				continue;
+			}
+
+			visibility[i] = 1;
+			stats.visibleMeshlets++;
+			stats.visibleTriangles += meshlet.triangleCount;
+		}
+		return stats;
+	}
+
+	void MeshletCuller::emitIndices(const MeshletMesh& mesh, const std::vector<uint8_t>& visibility, std::vector<uint32_t>& indices)
+	{
+		indices.clear();
+		for (size_t i = 0; i < mesh.meshlets.size(); i++) {
+			if (!visibility[i]) continue;
+
+			const Meshlet& meshlet = mesh.meshlets[i];
+			const uint32_t* vertices = &mesh.vertices[meshlet.vertexOffset];
+			const uint8_t* triangles = &mesh.triangles[meshlet.triangleOffset];
+			for (uint32_t j = 0; j < meshlet.triangleCount * 3; j++) {
+				indices.push_back(vertices[triangles[j]]);
+			}
+		}
+	}
+}
@@ -0,0 +1,148 @@
+#include "NullBackend.h"
+
+#include "ContentHash.h"
+
+namespace Starry
+{
+	NullBackend::NullBackend(std::array<unsigned int, 2> extentInput) : extent(extentInput)
+	{
+	}
+
+	void NullBackend::Load(std::shared_ptr<Render::Buffer>& buffer)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		drawBuffers.push_back(buffer);
+	}
+
+	void NullBackend::record(const RenderCommand& command, size_t bytes)
+	{
+		frameCommands.push_back(command);
+		switch (command.type) {
+			case RenderCommandType::LOAD_BUFFER:
+				frameStats.bufferLoads++;
+				frameStats.redundantBufferLoads += command.redundant;
+				break;
+			case RenderCommandType::WRITE_UNIFORM:
+				frameStats.uniformWrites++;
+				frameStats.redundantUniformWrites += command.redundant;
+				break;
+			case RenderCommandType::LOAD_TEXTURE:
+				frameStats.textureLoads++;
+				break;
+			case RenderCommandType::WRITE_OBJECTS:
+				frameStats.objectWrites++;
+				frameStats.redundantObjectWrites += command.redundant;
+				break;
+			case RenderCommandType::DRAW:
+				frameStats.draws++;
+				frameStats.drawnIndices += static_cast<size_t>(command.count) * command.instances;
+				frameStats.drawnInstances += command.instances;
+				break;
+		}
+		frameStats.uploadBytes += bytes;
+	}
+
+	void NullBackend::loadBufferData(Render::Buffer& buffer, std::vector<Render::Vertex>& vertices, std::vector<uint32_t>& indices)
+	{
+		size_t vertexBytes = vertices.size() * sizeof(Render::Vertex);
+		size_t indexBytes = indices.size() * sizeof(uint32_t);
+		uint64_t hash = hashBytes(indices.data(), indexBytes, hashBytes(vertices.data(), vertexBytes));
+
+		std::lock_guard<std::mutex> lock(mutex);
+		auto previous = contents.find(&buffer);
+		bool redundant = previous != contents.end() && previous->second == hash;
+		contents[&buffer] = hash;
+		indexCounts[&buffer] = static_cast<uint32_t>(indices.size());
+		record({ RenderCommandType::LOAD_BUFFER, redundant, static_cast<uint32_t>(indices.size()), buffer.getUUID(), hash }, vertexBytes + indexBytes);
+	}
+
+	void NullBackend::writeUniform(Render::Uniform& uniform, Render::UniformData& data)
+	{
+		uint64_t hash = hashBytes(&data, sizeof(data));
+
+		std::lock_guard<std::mutex> lock(mutex);
+		auto previous = contents.find(&uniform);
+		bool redundant = previous != contents.end() && previous->second == hash;
+		contents[&uniform] = hash;
+		record({ RenderCommandType::WRITE_UNIFORM, redundant, static_cast<uint32_t>(sizeof(data)), uniform.getUUID(), hash }, sizeof(data));
+	}
+
+	void NullBackend::storeTexture(Render::TextureImage& texture, const std::string& filePath)
+	{
+		uint64_t hash = hashBytes(filePath.data(), filePath.size());
+
+		std::lock_guard<std::mutex> lock(mutex);
+		contents[&texture] = hash;
+		record({ RenderCommandType::LOAD_TEXTURE, false, 0, texture.getUUID(), hash }, 0);
+	}
+
+	void NullBackend::submitObjects(const ObjectData* objects, size_t count, const std::vector<ObjectDraw>& draws)
+	{
+		size_t bytes = count * sizeof(ObjectData);
+		uint64_t hash = hashBytes(objects, bytes);
+
+		std::lock_guard<std::mutex> lock(mutex);
+		bool redundant = objectsSubmitted && objectHash == hash;
+		objectsSubmitted = true;
+		objectHash = hash;
+		objectDraws = draws;
+		record({ RenderCommandType::WRITE_OBJECTS, redundant, static_cast<uint32_t>(bytes), 0, hash }, bytes);
+	}
+
+	void NullBackend::Draw()
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (objectsSubmitted) {
+			for (const ObjectDraw& draw : objectDraws) {
+				auto count = indexCounts.find(draw.buffer);
+				uint32_t indices = count != indexCounts.end() ? count->second : 0;
+				record({ RenderCommandType::DRAW, false, indices, draw.buffer->getUUID(), 0, draw.instanceCount }, 0);
+			}
+		}
+		else {
+			for (const auto& buffer : drawBuffers) {
+				auto count = indexCounts.find(buffer.get());
+				uint32_t indices = count != indexCounts.end() ? count->second : 0;
+				record({ RenderCommandType::DRAW, false, indices, buffer->getUUID(), 0 }, 0);
+			}
+		}
+
+		frameStats.frames = 1;
+		totals.frames += frameStats.frames;
+		totals.draws += frameStats.draws;
+		totals.drawnIndices += frameStats.drawnIndices;
+		totals.drawnInstances += frameStats.drawnInstances;
+		totals.bufferLoads += frameStats.bufferLoads;
+		totals.redundantBufferLoads += frameStats.redundantBufferLoads;
+		totals.uniformWrites += frameStats.uniformWrites;
+		totals.redundantUniformWrites += frameStats.redundantUniformWrites;
+		totals.textureLoads += frameStats.textureLoads;
+		totals.objectWrites += frameStats.objectWrites;
+		totals.redundantObjectWrites += frameStats.redundantObjectWrites;
+		totals.uploadBytes += frameStats.uploadBytes;
+
+		lastStats = frameStats;
+		frameStats = {};
+		// Swapped rather than copied so the next frame reuses the allocation
+		std::swap(lastCommands, frameCommands);
+		frameCommands.clear();
+	}
+
+	std::vector<RenderCommand> NullBackend::getLastFrame() const
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		return lastCommands;
+	}
+
+	NullFrameStats NullBackend::getLastFrameStats() const
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		return lastStats;
+	}
+
+	NullFrameStats NullBackend::getTotals() const
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		return totals;
+	}
+}
@@ -0,0 +1,459 @@
+#include "ObjImporter.h"
+
+#include "MappedFile.h"
+#include "Parallel.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+namespace Starry
+{
+	struct ObjImporter::Chunk {
+		const char* begin = nullptr;
+		const char* end = nullptr;
+
+		std::vector<float> positions;
+		std::vector<float> texCoords;
+		std::vector<float> normals;
+
+		// Polygons as written, faceSizes[i] corners each
+		std::vector<ObjCorner> faceCorners;
+		std::vector<uint32_t> faceSizes;
+
+		// Negative (relative) indices are stored chunk-relative until the chunk bases are known
+		struct Fixup {
+			uint32_t corner;
+			uint8_t component;
+		};
+		std::vector<Fixup> fixups;
+
+		size_t triangles = 0;
+
+		size_t positionBase = 0;
+		size_t texCoordBase = 0;
+		size_t normalBase = 0;
+		size_t triangleBase = 0;
+
+		std::string error;
+	};
+
+	namespace
+	{
+		using Clock = std::chrono::steady_clock;
+
+		double secondsSince(Clock::time_point start)
+		{
+			return std::chrono::duration<double>(Clock::now() - start).count();
+		}
+
+		inline bool isSpace(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+		inline bool isDigit(char c) { return static_cast<unsigned char>(c - '0') < 10; }
+
+		inline const char* skipSpace(const char* p, const char* end)
+		{
+			while (p < end && isSpace(*p)) p++;
+			return p;
+		}
+
+		inline const char* skipLine(const char* p, const char* end)
+		{
+			const char* newline = static_cast<const char*>(std::memchr(p, '\n', end - p));
+			return newline ? newline + 1 : end;
+		}
+
+		const double POWERS_OF_TEN[] = {
+			1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+			1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+		};
+
+		// Decimal float in [+-]digits[.digits][(e|E)[+-]digits] form. Returns nullptr when no number is present.
+		const char* parseFloat(const char* p, const char* end, float& out)
+		{
+			p = skipSpace(p, end);
+
+			bool negative = false;
+			if (p < end && (*p == '-' || *p == '+')) {
+				negative = *p == '-';
+				p++;
+			}
+
+			uint64_t mantissa = 0;
+			int exponent = 0;
+			int significantDigits = 0;
+			bool anyDigits = false;
+
+			for (; p < end && isDigit(*p); p++) {
+				anyDigits = true;
+				if (significantDigits < 19) {
+					mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+					if (mantissa != 0) significantDigits++;
+				}
+				else {
+					exponent++;
+				}
+			}
+			if (p < end && *p == '.') {
+				p++;
+				for (; p < end && isDigit(*p); p++) {
+					anyDigits = true;
+					if (significantDigits < 19) {
+						mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+						if (mantissa != 0) significantDigits++;
+						exponent--;
+					}
+				}
+			}
+			if (!anyDigits) return nullptr;
+
+			if (p < end && (*p == 'e' || *p == 'E')) {
+				const char* expStart = p++;
+				bool expNegative = false;
+				if (p < end && (*p == '-' || *p == '+')) {
+					expNegative = *p == '-';
+					p++;
+				}
+				if (p < end && isDigit(*p)) {
+					int value = 0;
+					for (; p < end && isDigit(*p); p++) {
+						if (value < 10000) value = value * 10 + (*p - '0');
+					}
+					exponent += expNegative ? -value : value;
+				}
+				else {
+					p = expStart;
+				}
+			}
+
+			double value = static_cast<double>(mantissa);
+			if (exponent < 0 && exponent >= -22) {
+				value /= POWERS_OF_TEN[-exponent];
+			}
+			else if (exponent > 0 && exponent <= 22) {
+				value *= POWERS_OF_TEN[exponent];
+			}
+			else if (exponent != 0) {
+				value *= std::pow(10.0, exponent);
+			}
+
+			out = static_cast<float>(negative ? -value : value);
+			return p;
+		}
+
+		inline const char* parseIndex(const char* p, const char* end, int64_t& out, bool& present)
+		{
+			bool negative = false;
+			if (p < end && (*p == '-' || *p == '+')) {
+				negative = *p == '-';
+				p++;
+			}
+			present = p < end && isDigit(*p);
+
+			int64_t value = 0;
+			for (; p < end && isDigit(*p); p++) {
+				value = value * 10 + (*p - '0');
+			}
+			out = negative ? -value : value;
+			return p;
+		}
+	}
+
+	ObjImporter::ObjImporter(size_t threadCount)
+	{
+		threads = threadCount == 0 ? defaultThreadCount() : threadCount;
+	}
+
+	bool ObjImporter::importFile(const std::string& filePath, ObjMeshData& output)
+	{
+		auto start = Clock::now();
+
+		MappedFile file;
+		if (!file.open(filePath)) {
+			error = "Could not map file: " + filePath;
+			return false;
+		}
+		double mapSeconds = secondsSince(start);
+
+		bool result = importMemory(file.data(), file.size(), output);
+		stats.mapSeconds = mapSeconds;
+		return result;
+	}
+
+	bool ObjImporter::importMemory(const char* data, size_t size, ObjMeshData& output)
+	{
+		error.clear();
+		stats = {};
+		stats.bytes = size;
+
+		output = {};
+		if (data == nullptr || size == 0) {
+			return true;
+		}
+
+		auto start = Clock::now();
+
+		size_t chunkCount = std::clamp<size_t>(size / MIN_CHUNK_BYTES, 1, threads);
+		std::vector<Chunk> chunks(chunkCount);
+
+		const char* end = data + size;
+		const char* cursor = data;
+		for (size_t i = 0; i < chunkCount; i++) {
+			const char* split = (i + 1 == chunkCount) ? end : data + (size * (i + 1)) / chunkCount;
+			if (split < cursor) split = cursor;
+			if (split < end) split = skipLine(split, end);
+
+			chunks[i].begin = cursor;
+			chunks[i].end = split;
+			cursor = split;
+		}
+		stats.chunks = chunkCount;
+
+		runParallel(chunkCount, [&](size_t i) { parseChunk(chunks[i]); });
+		stats.parseSeconds = secondsSince(start);
+
+		for (auto& chunk : chunks) {
+			if (!chunk.error.empty()) {
+				error = chunk.error;
+				output = {};
+				return false;
+			}
+		}
+
+		start = Clock::now();
+		bool merged = mergeChunks(chunks, output);
+		stats.mergeSeconds = secondsSince(start);
+
+		if (!merged) {
+			output = {};
+		}
+		return merged;
+	}
+
+	void ObjImporter::parseChunk(Chunk& chunk)
+	{
+		// Rough guess from sphere.obj style files, avoids most regrowth
+		size_t estimatedLines = static_cast<size_t>(chunk.end - chunk.begin) / 24;
+		chunk.positions.reserve(estimatedLines);
+		chunk.faceCorners.reserve(estimatedLines);
+
+		const char* p = chunk.begin;
+		const char* end = chunk.end;
+
+		while (p < end) {
+			p = skipSpace(p, end);
+			if (p >= end) break;
+
+			char c = *p;
+			if (c == 'v' && p + 1 < end) {
+				char kind = p[1];
+				std::vector<float>* target = nullptr;
+				int components = 0;
+
+				if (isSpace(kind)) {
+					target = &chunk.positions;
+					components = 3;
+					p += 1;
+				}
+				else if (kind == 't' && p + 2 < end && isSpace(p[2])) {
+					target = &chunk.texCoords;
+					components = 2;
+					p += 2;
+				}
+				else if (kind == 'n' && p + 2 < end && isSpace(p[2])) {
+					target = &chunk.normals;
+					components = 3;
+					p += 2;
+				}
+
+				if (target != nullptr) {
+					for (int i = 0; i < components; i++) {
+						float value = 0.0f;
+						const char* next = parseFloat(p, end, value);
+						if (next == nullptr) {
+							// A missing trailing vt component defaults to 0 like tinyobj
+							if (target == &chunk.texCoords && i > 0) {
+								target->push_back(0.0f);
+								continue;
+							}
+							chunk.error = "Malformed vertex record in OBJ data.";
+							return;
+						}
+						target->push_back(value);
+						p = next;
+					}
+				}
+			}
+			else if (c == 'f' && p + 1 < end && isSpace(p[1])) {
+				p++;
+
+				size_t positionCount = chunk.positions.size() / 3;
+				size_t texCoordCount = chunk.texCoords.size() / 2;
+				size_t normalCount = chunk.normals.size() / 3;
+
+				uint32_t faceSize = 0;
+				while (true) {
+					p = skipSpace(p, end);
+					if (p >= end || *p == '\n' || *p == '#') break;
+
+					ObjCorner corner{};
+					int32_t* components[3] = { &corner.position, &corner.texCoord, &corner.normal };
+					size_t counts[3] = { positionCount, texCoordCount, normalCount };
+
+					for (uint8_t component = 0; component < 3; component++) {
+						if (component > 0) {
+							if (p >= end || *p != '/') break;
+							p++;
+						}
+
+						int64_t raw = 0;
+						bool present = false;
+						p = parseIndex(p, end, raw, present);
+						if (!present) {
+							if (component == 0) {
+								chunk.error = "Malformed face record in OBJ data.";
+								return;
+							}
+							continue;
+						}
+						if (raw == 0) {
+							chunk.error = "OBJ face index of 0 is invalid.";
+							return;
+						}
+
+						if (raw > 0) {
+							*components[component] = static_cast<int32_t>(raw - 1);
+						}
+						else {
+							*components[component] = static_cast<int32_t>(static_cast<int64_t>(counts[component]) + raw);
+							chunk.fixups.push_back({ static_cast<uint32_t>(chunk.faceCorners.size()), component });
+						}
+					}
+
+					chunk.faceCorners.push_back(corner);
+					faceSize++;
+
+					if (p < end && !isSpace(*p) && *p != '\n' && *p != '#') {
+						chunk.error = "Malformed face record in OBJ data.";
+						return;
+					}
+				}
+
+				chunk.faceSizes.push_back(faceSize);
+				if (faceSize >= 3) {
+					chunk.triangles += faceSize - 2;
+				}
+			}
+
+			p = skipLine(p, end);
+		}
+	}
+
+	bool ObjImporter::mergeChunks(std::vector<Chunk>& chunks, ObjMeshData& output)
+	{
+		size_t positionFloats = 0;
+		size_t texCoordFloats = 0;
+		size_t normalFloats = 0;
+		size_t triangles = 0;
+
+		for (auto& chunk : chunks) {
+			chunk.positionBase = positionFloats / 3;
+			chunk.texCoordBase = texCoordFloats / 2;
+			chunk.normalBase = normalFloats / 3;
+			chunk.triangleBase = triangles;
+
+			positionFloats += chunk.positions.size();
+			texCoordFloats += chunk.texCoords.size();
+			normalFloats += chunk.normals.size();
+			triangles += chunk.triangles;
+		}
+
+		output.positions.resize(positionFloats);
+		output.texCoords.resize(texCoordFloats);
+		output.normals.resize(normalFloats);
+		output.corners.resize(triangles * 3);
+
+		const int64_t positionCount = static_cast<int64_t>(positionFloats / 3);
+		const int64_t texCoordCount = static_cast<int64_t>(texCoordFloats / 2);
+		const int64_t normalCount = static_cast<int64_t>(normalFloats / 3);
+
+		// Attributes first so every chunk can read any position while triangulating quads
+		runParallel(chunks.size(), [&](size_t i) {
+			Chunk& chunk = chunks[i];
+			std::copy(chunk.positions.begin(), chunk.positions.end(), output.positions.begin() + chunk.positionBase * 3);
+			std::copy(chunk.texCoords.begin(), chunk.texCoords.end(), output.texCoords.begin() + chunk.texCoordBase * 2);
+			std::copy(chunk.normals.begin(), chunk.normals.end(), output.normals.begin() + chunk.normalBase * 3);
+
+			for (const auto& fixup : chunk.fixups) {
+				ObjCorner& corner = chunk.faceCorners[fixup.corner];
+				switch (fixup.component) {
+					case 0: corner.position += static_cast<int32_t>(chunk.positionBase); break;
+					case 1: corner.texCoord += static_cast<int32_t>(chunk.texCoordBase); break;
+					default: corner.normal += static_cast<int32_t>(chunk.normalBase); break;
+				}
+			}
+
+			for (const auto& corner : chunk.faceCorners) {
+				bool valid = corner.position >= 0 && corner.position < positionCount
+					&& corner.texCoord >= -1 && corner.texCoord < texCoordCount
+					&& corner.normal >= -1 && corner.normal < normalCount;
+				if (!valid) {
+					chunk.error = "OBJ face index out of range.";
+					return;
+				}
+			}
+		});
+
+		for (auto& chunk : chunks) {
+			if (!chunk.error.empty()) {
+				error = chunk.error;
+				return false;
+			}
+		}
+
+		runParallel(chunks.size(), [&](size_t i) {
+			Chunk& chunk = chunks[i];
+			ObjCorner* out = output.corners.data() + chunk.triangleBase * 3;
+			const ObjCorner* face = chunk.faceCorners.data();
+			const float* positions = output.positions.data();
+
+			for (uint32_t faceSize : chunk.faceSizes) {
+				if (faceSize == 3) {
+					*out++ = face[0];
+					*out++ = face[1];
+					*out++ = face[2];
+				}
+				else if (faceSize == 4) {
+					const float* v0 = positions + face[0].position * 3;
+					const float* v1 = positions + face[1].position * 3;
+					const float* v2 = positions + face[2].position * 3;
+					const float* v3 = positions + face[3].position * 3;
+
+					float e02[3] = { v2[0] - v0[0], v2[1] - v0[1], v2[2] - v0[2] };
+					float e13[3] = { v3[0] - v1[0], v3[1] - v1[1], v3[2] - v1[2] };
+					float sqr02 = e02[0] * e02[0] + e02[1] * e02[1] + e02[2] * e02[2];
+					float sqr13 = e13[0] * e13[0] + e13[1] * e13[1] + e13[2] * e13[2];
+
+					if (sqr02 < sqr13) {
+						*out++ = face[0]; *out++ = face[1]; *out++ = face[2];
+						*out++ = face[0]; *out++ = face[2]; *out++ = face[3];
+					}
+					else {
+						*out++ = face[0]; *out++ = face[1]; *out++ = face[3];
+						*out++ = face[1]; *out++ = face[2]; *out++ = face[3];
+					}
+				}
+				else if (faceSize > 4) {
+					for (uint32_t k = 1; k + 1 < faceSize; k++) {
+						*out++ = face[0];
+						*out++ = face[k];
+						*out++ = face[k + 1];
+					}
+				}
+				face += faceSize;
+			}
+		});
+
+		return true;
+	}
+}
@@ -0,0 +1,66 @@
+#include "ObjectDataBuffer.h"
+
+#include "JobSystem.h"
+#include "TransformKernels.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Starry
+{
+	ObjectDataBuffer::ObjectDataBuffer(size_t framesInFlight) : frames(std::max<size_t>(framesInFlight, 1))
+	{
+	}
+
+	const ObjectData* ObjectDataBuffer::pack(const glm::mat4& viewProjection, const glm::mat4* models, size_t objectCount)
+	{
+		if (objectCount > capacity) {
+			// Regions stay equally sized so offsets are a plain multiple, older regions are dropped on growth
+			capacity = std::max(objectCount, capacity * 2);
+			storage.assign(capacity * frames, ObjectData{});
+		}
+		frame = (frame + 1) % frames;
+		count = objectCount;
+
+		ObjectData* output = storage.data() + frame * capacity;
+		JobSystem::get().parallelFor(count, PARALLEL_OBJECTS, [&](size_t begin, size_t end) {
+			packRange(viewProjection, models + begin, output + begin, end - begin);
+		});
+		return output;
+	}
+
+	void ObjectDataBuffer::packRange(const glm::mat4& viewProjection, const glm::mat4* models, ObjectData* output, size_t count)
+	{
+		// The SIMD kernels want contiguous matrices, so products go through a small buffer that stays in L1
+		constexpr size_t BATCH = 64;
+		glm::mat4 products[BATCH];
+
+		for (size_t base = 0; base < count; base += BATCH) {
+			size_t batch = std::min(BATCH, count - base);
+			TransformKernels::multiply(viewProjection, models + base, products, batch);
+
+			for (size_t i = 0; i < batch; i++) {
+				const glm::mat4& model = models[base + i];
+				ObjectData& object = output[base + i];
+				object.modelViewProjection = products[i];
+
+				// transpose(inverse(M)) is the cofactor matrix over the determinant, and the cofactor
+				// columns are cross products of the other two columns
+				glm::vec3 x(model[0]);
+				glm::vec3 y(model[1]);
+				glm::vec3 z(model[2]);
+				glm::vec3 cofactorX = glm::cross(y, z);
+				glm::vec3 cofactorY = glm::cross(z, x);
+				glm::vec3 cofactorZ = glm::cross(x, y);
+
+				// A collapsed model has no inverse, its normals are meaningless either way
+				float determinant = glm::dot(x, cofactorX);
+				float inverseDeterminant = std::fabs(determinant) > 1e-20f ? 1.0f / determinant : 1.0f;
+
+				object.normalMatrix[0] = glm::vec4(cofactorX * inverseDeterminant, 0.0f);
+				object.normalMatrix[1] = glm::vec4(cofactorY * inverseDeterminant, 0.0f);
+				object.normalMatrix[2] = glm::vec4(cofactorZ * inverseDeterminant, 0.0f);
+			}
+		}
+	}
+}
@@ -0,0 +1,205 @@
+#include "Profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+namespace Starry
+{
+	namespace
+	{
+		thread_local void* threadRing = nullptr;
+
+		const std::chrono::steady_clock::time_point& profileEpoch()
+		{
+			static const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+			return epoch;
+		}
+
+		void appendEscaped(std::string& out, const char* text)
+		{
+			for (const char* c = text; *c != '\0'; c++) {
+				switch (*c) {
+					case '"': out += "\\\""; break;
+					case '\\': out += "\\\\"; break;
+					case '\n': out += "\\n"; break;
+					case '\t': out += "\\t"; break;
+					default:
+						if (static_cast<unsigned char>(*c) < 0x20) {
+							char code[8];
+							std::snprintf(code, sizeof(code), "\\u%04x", *c);
+							out += code;
+						}
+						else {
+							out += *c;
+						}
+				}
+			}
+		}
+
+		bool sameName(const char* a, const char* b)
+		{
+			return a == b || (a != nullptr && b != nullptr && std::strcmp(a, b) == 0);
+		}
+	}
+
+	uint64_t Profiler::now()
+	{
+		auto elapsed = std::chrono::steady_clock::now() - profileEpoch();
+		// Zero marks a scope that never started
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) + 1;
+	}
+
+	Profiler::ThreadRing& Profiler::localRing()
+	{
+		if (threadRing == nullptr) {
+			auto ring = std::make_unique<ThreadRing>();
+			std::lock_guard<std::mutex> lock(registryMutex);
+			ring->id = static_cast<uint32_t>(rings.size() + 1);
+			ring->name = "Thread " + std::to_string(ring->id);
+			threadRing = ring.get();
+			rings.push_back(std::move(ring));
+		}
+		return *static_cast<ThreadRing*>(threadRing);
+	}
+
+	void Profiler::setThreadName(const char* name)
+	{
+		ThreadRing& ring = localRing();
+		std::lock_guard<std::mutex> lock(registryMutex);
+		ring.name = name;
+	}
+
+	uint32_t Profiler::enter()
+	{
+		return localRing().depth++;
+	}
+
+	void Profiler::leave(const char* name, uint64_t start, uint32_t depth)
+	{
+		uint64_t end = now();
+		ThreadRing& ring = localRing();
+		ring.depth = depth;
+
+		uint64_t head = ring.head.load(std::memory_order_relaxed);
+		Slot& slot = ring.slots[head % RING_SIZE];
+		// Pairs with the fence in copyRing, a reader that sees any of these stores also sees the head that
+		// tells it the slot is being reused
+		std::atomic_thread_fence(std::memory_order_release);
+		slot.name.store(name, std::memory_order_relaxed);
+		slot.start.store(start, std::memory_order_relaxed);
+		slot.end.store(end, std::memory_order_relaxed);
+		slot.depth.store(depth, std::memory_order_relaxed);
+		ring.head.store(head + 1, std::memory_order_release);
+	}
+
+	void Profiler::copyRing(const ThreadRing& ring, std::vector<ProfileRecord>& records)
+	{
+		uint64_t head = ring.head.load(std::memory_order_acquire);
+		uint64_t first = head > RING_SIZE ? head - RING_SIZE : 0;
+
+		size_t copied = records.size();
+		for (uint64_t i = first; i < head; i++) {
+			const Slot& slot = ring.slots[i % RING_SIZE];
+			ProfileRecord record;
+			record.name = slot.name.load(std::memory_order_relaxed);
+			record.thread = ring.id;
+			record.depth = slot.depth.load(std::memory_order_relaxed);
+			record.start = slot.start.load(std::memory_order_relaxed);
+			record.end = slot.end.load(std::memory_order_relaxed);
+			records.push_back(record);
+		}
+
+		// Anything the owner may have started overwriting while this copied is dropped
+		std::atomic_thread_fence(std::memory_order_acquire);
+		uint64_t after = ring.head.load(std::memory_order_relaxed);
+		uint64_t reused = after + 1 > RING_SIZE ? after + 1 - RING_SIZE : 0;
+		if (reused > first) {
+			size_t stale = static_cast<size_t>(std::min(reused, head) - first);
+			records.erase(records.begin() + copied, records.begin() + copied + stale);
+		}
+	}
+
+	std::vector<ProfileRecord> Profiler::collect()
+	{
+		std::vector<ProfileRecord> records;
+		std::lock_guard<std::mutex> lock(registryMutex);
+		for (const auto& ring : rings) {
+			copyRing(*ring, records);
+		}
+		return records;
+	}
+
+	std::vector<ProfileThread> Profiler::threads()
+	{
+		std::vector<ProfileThread> result;
+		std::lock_guard<std::mutex> lock(registryMutex);
+		for (const auto& ring : rings) {
+			result.push_back({ ring->id, ring->name, ring->head.load(std::memory_order_relaxed) });
+		}
+		return result;
+	}
+
+	bool Profiler::collectLatest(const char* root, std::vector<ProfileRecord>& records)
+	{
+		records.clear();
+		std::vector<ProfileRecord> all = collect();
+
+		const ProfileRecord* latest = nullptr;
+		for (const ProfileRecord& record : all) {
+			if (sameName(record.name, root) && (latest == nullptr || record.end > latest->end)) {
+				latest = &record;
+			}
+		}
+		if (latest == nullptr) return false;
+
+		records.push_back(*latest);
+		for (const ProfileRecord& record : all) {
+			if (record.thread == latest->thread && record.depth > latest->depth &&
+				record.start >= latest->start && record.end <= latest->end) {
+				records.push_back(record);
+			}
+		}
+		std::sort(records.begin() + 1, records.end(), [](const ProfileRecord& a, const ProfileRecord& b) {
+			return a.start < b.start || (a.start == b.start && a.depth < b.depth);
+		});
+		return true;
+	}
+
+	bool Profiler::writeChromeTrace(const std::string& filePath)
+	{
+		std::vector<ProfileThread> threadList = threads();
+		std::vector<ProfileRecord> records = collect();
+
+		std::string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+		bool first = true;
+		char buffer[128];
+
+		for (const ProfileThread& thread : threadList) {
+			if (!first) json += ",\n";
+			first = false;
+			std::snprintf(buffer, sizeof(buffer), "{\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"name\":\"thread_name\",\"args\":{\"name\":\"", thread.id);
+			json += buffer;
+			appendEscaped(json, thread.name.c_str());
+			json += "\"}}";
+		}
+		for (const ProfileRecord& record : records) {
+			if (!first) json += ",\n";
+			first = false;
+			json += "{\"ph\":\"X\",\"pid\":1,\"name\":\"";
+			appendEscaped(json, record.name != nullptr ? record.name : "?");
+			// Microseconds with nanosecond precision kept in the fraction
+			std::snprintf(buffer, sizeof(buffer), "\",\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+				record.thread, record.start / 1000.0, (record.end - record.start) / 1000.0);
+			json += buffer;
+		}
+		json += "\n]}\n";
+
+		std::ofstream stream(filePath, std::ios::binary | std::ios::trunc);
+		if (!stream) return false;
+		stream.write(json.data(), static_cast<std::streamsize>(json.size()));
+		return stream.good();
+	}
+}
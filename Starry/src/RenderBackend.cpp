@@ -0,0 +1,66 @@
+#include "RenderBackend.h"
+
+#include "NullBackend.h"
+#include "SoftwareBackend.h"
+#ifndef STARRY_HEADLESS
+#include "VulkanBackend.h"
+#endif
+
+namespace Starry
+{
+	std::unique_ptr<RenderBackend> RenderBackend::create(std::shared_ptr<Render::Window>& window, const RenderConfig& config)
+	{
+		switch (config.backend) {
+			case RenderBackendType::NONE:
+				return std::make_unique<NullBackend>(config.headlessExtent);
+			case RenderBackendType::SOFTWARE:
+				return std::make_unique<SoftwareBackend>(config);
+#ifdef STARRY_HEADLESS
+			// No device to draw on, the frame is recorded like RenderBackendType::NONE
+			case RenderBackendType::VULKAN:
+			default:
+				return std::make_unique<NullBackend>(config.headlessExtent);
+#else
+			case RenderBackendType::VULKAN:
+			default:
+				return std::make_unique<VulkanBackend>(window, config);
+#endif
+		}
+	}
+
+	void RenderBackend::bufferData(Render::Buffer& buffer, std::vector<Render::Vertex>& vertices, std::vector<uint32_t>& indices)
+	{
+		if (RenderBackend* backend = getActive()) {
+			backend->loadBufferData(buffer, vertices, indices);
+			return;
+		}
+		buffer.loadData(vertices, indices);
+	}
+
+	void RenderBackend::uniformData(Render::Uniform& uniform, Render::UniformData& data)
+	{
+		if (RenderBackend* backend = getActive()) {
+			backend->writeUniform(uniform, data);
+			return;
+		}
+		uniform.setData(data);
+	}
+
+	void RenderBackend::textureFile(Render::TextureImage& texture, const std::string& filePath)
+	{
+		if (RenderBackend* backend = getActive()) {
+			backend->storeTexture(texture, filePath);
+			return;
+		}
+		texture.storeFilePath(filePath);
+	}
+
+	void RenderBackend::descriptorData(Render::DescriptorSet& descriptorSet, const std::vector<size_t>& descriptors)
+	{
+		if (RenderBackend* backend = getActive()) {
+			backend->bindDescriptors(descriptorSet, descriptors);
+			return;
+		}
+		descriptorSet.addDescriptors(descriptors);
+	}
+}
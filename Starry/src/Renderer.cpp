@@ -1,19 +1,21 @@
 #include "Renderer.h"
 
+#include "Profiler.h"
 #include "Scene.h"
 
-#define EXTERN_ERROR(x) if(x.getAlertSeverity() == FATAL) { return; }
 #define EXTERN_ERROR_PTR(x) if(x->getAlertSeverity() == FATAL) { return; }
 
 namespace Starry
 {
 	Renderer::Renderer(std::shared_ptr<Window>& windowRef, RenderConfig config)
 	{
-		renderer.Init(windowRef, config); EXTERN_ERROR(renderer);
+		renderer = RenderBackend::create(windowRef, config);
+		if (renderer->isFatal()) return;
+		RenderBackend::setActive(renderer.get());
 
 		interface = std::make_shared<Interface>();
 		auto cnvs = static_pointer_cast<Render::Canvas>(interface);
-		renderer.Load(cnvs);
+		renderer->Load(cnvs);
 	}
 
 	Renderer::~Renderer()
@@ -22,6 +24,9 @@ namespace Starry
 			joinRenderer();
 		}
 		activeScene.reset();
+		if (RenderBackend::getActive() == renderer.get()) {
+			RenderBackend::setActive(nullptr);
+		}
 	}
 
 	void Renderer::askCallback(std::shared_ptr<Manager::ResourceAsk>& ask)
@@ -38,58 +43,168 @@ namespace Starry
 
 	void Renderer::disbatchRenderer()
 	{
-		if (renderer.getAlertSeverity() == FATAL) {
+		if (renderer->isFatal()) {
 			Alert("Render Context experienced a fatal error, could not disbatch renderer", FATAL);
 			return;
 		}
 
 		activeScene->loadObjects(this); EXTERN_ERROR_PTR(activeScene);
 
-		renderer.Ready(); EXTERN_ERROR(renderer);
+		renderer->Ready();
+		if (renderer->isFatal()) return;
 
 		renderRunning.store(true);
+		if (fixedUpdateRate > 0.0) {
+			// Publish a first snapshot so the first frame has something to present
+			simulationDelta = static_cast<float>(1.0 / fixedUpdateRate);
+			activeScene->simulate(this); EXTERN_ERROR_PTR(activeScene);
+			simulationThread = std::thread(&Renderer::simulationLoop, this);
+		}
 		renderThread = std::thread(&Renderer::renderLoop, this);
 	}
 
 	void Renderer::joinRenderer()
 	{
-		renderRunning.store(false);
+		stopRendering();
+		if (simulationThread.joinable()) {
+			simulationThread.join();
+		}
 		if (renderThread.joinable()) {
 			renderThread.join();
 		}
-		renderer.WaitIdle();
+		renderer->WaitIdle();
+	}
+
+	bool Renderer::waitWhileRunning(std::chrono::milliseconds timeout)
+	{
+		std::unique_lock<std::mutex> lock(wakeMutex);
+		stopSignal.wait_for(lock, timeout, [this]() { return !renderRunning.load(); });
+		return renderRunning.load();
+	}
+
+	void Renderer::stopRendering()
+	{
+		renderRunning.store(false);
+		std::lock_guard<std::mutex> lock(wakeMutex);
+		redrawSignal.notify_all();
+		stopSignal.notify_all();
+	}
+
+	void Renderer::requestRedraw()
+	{
+		// Already pending is the common case, transform changes land here once per object per tick
+		if (redrawRequested.load(std::memory_order_relaxed) || redrawRequested.exchange(true)) return;
+		std::lock_guard<std::mutex> lock(wakeMutex);
+		redrawSignal.notify_one();
+	}
+
+	void Renderer::refreshHealth()
+	{
+		auto now = std::chrono::steady_clock::now();
+		if (now < nextHealthCheck) return;
+		nextHealthCheck = now + HEALTH_CHECK_INTERVAL;
+
+		auto manager = Manager::AssetManager::get().lock();
+		if (manager != nullptr && manager->isFatal()) fatal.store(true, std::memory_order_relaxed);
+	}
+
+	bool Renderer::waitForRedraw()
+	{
+		if (redrawRequested.exchange(false)) return false;
+
+		STARRY_PROFILE_SCOPE("Idle");
+		// Idle time is neither a frame nor simulated
+		timer.stop();
+		std::unique_lock<std::mutex> lock(wakeMutex);
+		redrawSignal.wait_for(lock, idleRedraw, [this]() { return redrawRequested.load() || !renderRunning.load(); });
+		redrawRequested.store(false);
+		return true;
 	}
 
 	void Renderer::renderLoop()
 	{
+		STARRY_PROFILE_THREAD("Render");
 		timer.setLogging();
+		limiter.reset();
 		while (renderRunning.load()) {
+			bool idled = renderMode == RenderMode::ON_DEMAND && waitForRedraw();
+			if (!renderRunning.load()) break;
+			{
+				STARRY_PROFILE_SCOPE("Frame Limit");
+				limiter.wait();
+			}
+
+			STARRY_PROFILE_SCOPE("Frame");
 			timer.time();
 
-			activeScene->updateObjects(this); EXTERN_ERROR_PTR(activeScene);
+			if (fixedUpdateRate > 0.0) {
+				activeScene->present(this, interpolateUpdates);
+			}
+			else {
+				STARRY_PROFILE_SCOPE("Scene Update");
+				simulationDelta = idled ? 0.0f : timer.getDeltaTimeSeconds();
+				activeScene->updateObjects(this);
+				if (activeScene->getAlertSeverity() == FATAL) {
+					fatal.store(true, std::memory_order_relaxed);
+					stopRendering();
+					return;
+				}
+			}
 
 			// Error checks
-			if (renderer.getErrorState()) {
-				Alert("Fatal rendering error occurred!", FATAL);
-				renderRunning.store(false);
-				continue;
-			}
-			if (Manager::AssetManager::get().lock()->isFatal()) {
-				renderRunning.store(false);
-				continue;
+			{
+				STARRY_PROFILE_SCOPE("Error Checks");
+				refreshHealth();
+				if (renderer->getErrorState()) {
+					Alert("Fatal rendering error occurred!", FATAL);
+					fatal.store(true, std::memory_order_relaxed);
+				}
+				if (isFatal()) {
+					stopRendering();
+					continue;
+				}
 			}
 
-			renderer.Draw();
+			{
+				STARRY_PROFILE_SCOPE("Draw");
+				renderer->Draw();
+			}
 
 			// Error checks
-			if (renderer.getErrorState()) {
-				Alert("Fatal rendering error occurred!", FATAL);
-				renderRunning.store(false);
-				continue;
+			{
+				STARRY_PROFILE_SCOPE("Error Checks");
+				if (renderer->getErrorState()) {
+					Alert("Fatal rendering error occurred!", FATAL);
+					fatal.store(true, std::memory_order_relaxed);
+					stopRendering();
+				}
+			}
+		}
+	}
+
+	void Renderer::simulationLoop()
+	{
+		using Clock = std::chrono::steady_clock;
+		auto tick = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / fixedUpdateRate));
+		auto nextTick = Clock::now() + tick;
+		STARRY_PROFILE_THREAD("Simulation");
+
+		while (renderRunning.load()) {
+			std::this_thread::sleep_until(nextTick);
+
+			for (int i = 0; i < MAX_CATCH_UP_TICKS && Clock::now() >= nextTick; i++) {
+				STARRY_PROFILE_SCOPE("Simulation Tick");
+				activeScene->simulate(this);
+				if (activeScene->getAlertSeverity() == FATAL) {
+					fatal.store(true, std::memory_order_relaxed);
+					stopRendering();
+					return;
+				}
+				nextTick += tick;
 			}
-			if (Manager::AssetManager::get().lock()->isFatal()) {
-				renderRunning.store(false);
-				continue;
+			// Too far behind, drop the missed time instead of running ever longer bursts
+			if (Clock::now() >= nextTick) {
+				nextTick = Clock::now() + tick;
 			}
 		}
 	}
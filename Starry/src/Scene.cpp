@@ -1,6 +1,13 @@
 #include "Scene.h"
 
 #include "Renderer.h"
+#include "AssetLoader.h"
+#include "CameraObject.h"
+#include "JobSystem.h"
+#include "Profiler.h"
+#include "TransformKernels.h"
+
+#include <algorithm>
 
 #define EXTERN_ERROR(x) if(x->getAlertSeverity() == FATAL) { return; }
 
@@ -14,61 +21,670 @@ namespace Starry
 	Scene::~Scene() 
 	{
 		for (auto& obj : sceneObjects) {
-			obj.second->Destroy();
-			obj.second.reset();
+			// Hand the local transform back in case something else still holds the object
+			if (obj->transforms != nullptr) {
+				obj->localTransform = obj->getLocalTransform();
+				obj->transforms = nullptr;
+			}
+			obj->scene = nullptr;
+			obj->sceneHandle = INVALID_HANDLE;
+			obj->Destroy();
+			obj.reset();
+		}
+		for (auto& obj : pendingRemovals) {
+			if (obj->transforms != nullptr) {
+				obj->localTransform = obj->getLocalTransform();
+				obj->transforms = nullptr;
+			}
+			obj->scene = nullptr;
+		}
+		// The simulation stopped before getting to them
+		for (auto& pending : pendingSaves) {
+			pending.written.set_value(false);
 		}
 	}
 
-	void Scene::pushObject(std::shared_ptr<SceneObject>& obj)
+	SceneHandle Scene::pushObject(std::shared_ptr<SceneObject>& obj)
 	{
-		obj->Init(); EXTERN_ERROR(obj);
-		sceneObjects.emplace(obj->getName(), obj);
+		obj->Init();
+		if (obj->getAlertSeverity() == FATAL) return INVALID_HANDLE;
+
+		SceneHandle handle;
+		{
+			std::lock_guard<std::mutex> lock(objectMutex);
+			handle = insertObject(obj);
+		}
+		requestRedraw();
+		return handle;
 	}
 
 	void Scene::pushObjects(std::vector<std::shared_ptr<SceneObject>>& objs)
 	{
-		for (auto& obj : objs) {
-			obj->Init(); EXTERN_ERROR(obj);
-			sceneObjects.emplace(obj->getName(), obj);
+		// Stops at the first object that fails to initialise, the ones before it still go in
+		size_t ready = 0;
+		for (; ready < objs.size(); ready++) {
+			objs[ready]->Init();
+			if (objs[ready]->getAlertSeverity() == FATAL) break;
 		}
+		if (ready == 0) return;
+
+		// One lock for the whole batch, bulk loads push thousands at a time
+		{
+			std::lock_guard<std::mutex> lock(objectMutex);
+			for (size_t i = 0; i < ready; i++) {
+				insertObject(objs[i]);
+			}
+		}
+		requestRedraw();
 	}
 
-	void Scene::loadObjects(Renderer* renderer)
+	SceneHandle Scene::insertObject(std::shared_ptr<SceneObject>& obj)
 	{
-		if (sceneObjects.size() == 0) {
-			Alert("No objects in scene to render!", FATAL);
-			return;
+		if (obj->sceneHandle != INVALID_HANDLE) {
+			Alert("Object " + obj->getName() + " is already in a scene!", CRITICAL);
+			return INVALID_HANDLE;
+		}
+		obj->sceneHandle = sceneObjects.insert(obj);
+		nameIndex.emplace(obj->getName(), obj->sceneHandle);
+		pendingAdds.push_back(obj);
+		if (objectsRegistered) pendingRegistration.push_back(obj);
+		totalObjectCount.store(sceneObjects.size(), std::memory_order_relaxed);
+		return obj->sceneHandle;
+	}
+
+	bool Scene::removeObject(SceneHandle handle)
+	{
+		{
+			std::lock_guard<std::mutex> lock(objectMutex);
+			std::shared_ptr<SceneObject>* found = sceneObjects.get(handle);
+			if (found == nullptr) return false;
+
+			std::shared_ptr<SceneObject> obj = std::move(*found);
+			sceneObjects.remove(handle);
+			auto named = nameIndex.equal_range(obj->getName());
+			for (auto entry = named.first; entry != named.second; entry++) {
+				if (entry->second == handle) {
+					nameIndex.erase(entry);
+					break;
+				}
+			}
+			obj->sceneHandle = INVALID_HANDLE;
+			pendingRemovals.push_back(std::move(obj));
+			totalObjectCount.store(sceneObjects.size(), std::memory_order_relaxed);
+		}
+		requestRedraw();
+		return true;
+	}
+
+	std::shared_ptr<SceneObject> Scene::getObject(SceneHandle handle) const
+	{
+		std::lock_guard<std::mutex> lock(objectMutex);
+		const std::shared_ptr<SceneObject>* found = sceneObjects.get(handle);
+		return found != nullptr ? *found : nullptr;
+	}
+
+	std::shared_ptr<SceneObject> Scene::findObject(const std::string& name) const
+	{
+		std::lock_guard<std::mutex> lock(objectMutex);
+		auto found = nameIndex.find(name);
+		if (found == nameIndex.end()) return nullptr;
+		return *sceneObjects.get(found->second);
+	}
+
+	std::future<bool> Scene::save(const std::string& filePath)
+	{
+		std::promise<bool> written;
+		std::future<bool> result = written.get_future();
+
+		if (redrawTarget != nullptr && redrawTarget->isRenderRunning().load()) {
+			{
+				std::lock_guard<std::mutex> lock(saveMutex);
+				pendingSaves.push_back({ filePath, std::move(written) });
+			}
+			// An idle on demand renderer would not tick otherwise
+			requestRedraw();
+			return result;
+		}
+
+		std::vector<PendingSave> saves;
+		saves.push_back({ filePath, std::move(written) });
+		auto writer = std::make_shared<SceneFileWriter>();
+		gatherRecords(*writer);
+		writeRecords(std::move(writer), std::move(saves));
+		return result;
+	}
+
+	void Scene::applySaves()
+	{
+		std::vector<PendingSave> saves;
+		{
+			std::lock_guard<std::mutex> lock(saveMutex);
+			if (pendingSaves.empty()) return;
+			saves.swap(pendingSaves);
+		}
+		// Later saves in the same tick see the same scene, so one gather serves them all
+		auto writer = std::make_shared<SceneFileWriter>();
+		gatherRecords(*writer);
+		writeRecords(std::move(writer), std::move(saves));
+	}
+
+	void Scene::gatherRecords(SceneFileWriter& writer)
+	{
+		std::vector<std::shared_ptr<SceneObject>> objects;
+		{
+			std::lock_guard<std::mutex> lock(objectMutex);
+			objects.assign(sceneObjects.begin(), sceneObjects.end());
+		}
+
+		// Parents go before their children, so the loader can link each child as it is built
+		std::vector<std::pair<uint32_t, SceneObject*>> ordered;
+		ordered.reserve(objects.size());
+		for (auto& obj : objects) {
+			uint32_t depth = 0;
+			for (SceneObject* parent = obj->parentObject; parent != nullptr; parent = parent->parentObject) {
+				depth++;
+			}
+			ordered.emplace_back(depth, obj.get());
+		}
+		std::stable_sort(ordered.begin(), ordered.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+		std::unordered_map<const SceneObject*, uint32_t> recordIndices;
+		recordIndices.reserve(ordered.size());
+		writer.reserve(ordered.size());
+		for (auto& [depth, obj] : ordered) {
+			SceneObjectRecord record{};
+			if (!obj->saveRecord(record, writer)) continue;
+
+			record.type = static_cast<uint32_t>(obj->getType());
+			const LocalTransform& local = obj->getLocalTransform();
+			for (int i = 0; i < 3; i++) {
+				record.translation[i] = local.translation[i];
+				record.scale[i] = local.scale[i];
+			}
+			record.rotation[0] = local.rotation.w;
+			record.rotation[1] = local.rotation.x;
+			record.rotation[2] = local.rotation.y;
+			record.rotation[3] = local.rotation.z;
+
+			// A parent left out of the snapshot leaves the child a root, keeping its local transform
+			auto parent = recordIndices.find(obj->parentObject);
+			if (parent != recordIndices.end()) record.parent = parent->second;
+
+			recordIndices.emplace(obj, static_cast<uint32_t>(writer.getObjectCount()));
+			writer.addObject(record, obj->name);
+		}
+	}
+
+	void Scene::writeRecords(std::shared_ptr<SceneFileWriter> writer, std::vector<PendingSave> saves)
+	{
+		// AssetLoader jobs are std::function, which needs something copyable to hold the promises
+		auto pending = std::make_shared<std::vector<PendingSave>>(std::move(saves));
+		AssetLoader::get().submit([writer, pending]() {
+			writer->hashMissingAssets();
+			for (auto& save : *pending) {
+				save.written.set_value(writer->write(save.filePath));
+			}
+		});
+	}
+
+	void Scene::applyChanges()
+	{
+		std::vector<std::shared_ptr<SceneObject>> added;
+		std::vector<std::shared_ptr<SceneObject>> removed;
+		{
+			std::lock_guard<std::mutex> lock(objectMutex);
+			added.swap(pendingAdds);
+			removed.swap(pendingRemovals);
+		}
+		if (added.empty() && removed.empty()) return;
+
+		// In order, an object pushed and removed within one tick goes in and straight back out
+		for (auto& obj : added) {
+			addObject(obj.get());
+		}
+		for (auto& obj : removed) {
+			detachObject(obj.get());
+		}
+		if (removed.empty()) return;
+
+		// The snapshot this tick publishes is the first without them
+		std::lock_guard<std::mutex> lock(retireMutex);
+		for (auto& obj : removed) {
+			retiredObjects.emplace_back(tickIndex + 1, std::move(obj));
+		}
+	}
+
+	void Scene::addObject(SceneObject* obj)
+	{
+		if (obj->getType() == SceneObject::Type::MESH) {
+			obj->transformHandle = transformStore.create(obj->localTransform);
+			obj->transforms = &transformStore;
+			if (transformOwners.size() <= obj->transformHandle) {
+				transformOwners.resize(obj->transformHandle + 1, nullptr);
+			}
+			transformOwners[obj->transformHandle] = obj;
+			linkParent(obj);
+
+			obj->scene = this;
+			obj->boundsDirty = false;
+			obj->markBoundsDirty();
+			obj->listIndex = static_cast<uint32_t>(boundedObjects.size());
+			boundedObjects.push_back(obj);
+		}
+		else {
+			obj->scene = this;
+			obj->listIndex = static_cast<uint32_t>(unboundedObjects.size());
+			unboundedObjects.push_back(obj);
+		}
+		if (obj->hasPendingLoad()) {
+			trackLoad(obj);
+		}
+	}
+
+	void Scene::detachObject(SceneObject* obj)
+	{
+		std::vector<SceneObject*>& list = obj->transforms == &transformStore ? boundedObjects : unboundedObjects;
+		list[obj->listIndex] = list.back();
+		list[obj->listIndex]->listIndex = obj->listIndex;
+		list.pop_back();
+
+		if (obj->transforms == &transformStore) {
+			// Children become roots in the store and forget this object
+			transformStore.forEachChild(obj->transformHandle, [&](TransformStore::Handle child) {
+				transformOwners[child]->parentObject = nullptr;
+			});
+			obj->localTransform = obj->getLocalTransform();
+			obj->transforms = nullptr;
+			transformStore.destroy(obj->transformHandle);
+			transformOwners[obj->transformHandle] = nullptr;
+			obj->transformHandle = TransformStore::INVALID_HANDLE;
+		}
+		if (obj->treeProxy != DynamicAabbTree::NULL_NODE) {
+			boundsTree.destroyProxy(obj->treeProxy);
+			obj->treeProxy = DynamicAabbTree::NULL_NODE;
+		}
+
+		// Links still waiting on a parent to arrive, in either direction
+		auto waiting = waitingChildren.find(obj);
+		if (waiting != waitingChildren.end()) {
+			for (SceneObject* child : waiting->second) {
+				if (child->parentObject == obj) child->parentObject = nullptr;
+			}
+			waitingChildren.erase(waiting);
+		}
+		if (obj->parentObject != nullptr) {
+			auto siblings = waitingChildren.find(obj->parentObject);
+			if (siblings != waitingChildren.end()) {
+				std::erase(siblings->second, obj);
+			}
+			obj->parentObject = nullptr;
+		}
+
+		// Loads in flight drop the object, the render side checks scene under the same lock before requeueing
+		std::lock_guard<std::mutex> lock(loadMutex);
+		std::erase(loadingObjects, obj);
+		std::erase(loadedObjects, obj);
+		obj->scene = nullptr;
+		obj->boundsDirty = false;
+	}
+
+	void Scene::linkParent(SceneObject* obj)
+	{
+		SceneObject* parent = obj->parentObject;
+		if (parent != nullptr) {
+			if (parent->transforms == &transformStore) {
+				transformStore.setParent(obj->transformHandle, parent->transformHandle);
+			}
+			else {
+				waitingChildren[parent].push_back(obj);
+			}
 		}
+
+		auto waiting = waitingChildren.find(obj);
+		if (waiting == waitingChildren.end()) return;
+		for (SceneObject* child : waiting->second) {
+			if (child->parentObject == obj) {
+				transformStore.setParent(child->transformHandle, obj->transformHandle);
+			}
+		}
+		waitingChildren.erase(waiting);
+	}
+
+	void Scene::refitBounds()
+	{
+		for (SceneObject* obj : refitQueue) {
+			// Removed since it was queued
+			if (obj->scene != this) continue;
+			obj->boundsDirty = false;
+
+			Aabb local{};
+			if (!obj->getLocalBounds(local)) {
+				if (obj->treeProxy != DynamicAabbTree::NULL_NODE) {
+					boundsTree.destroyProxy(obj->treeProxy);
+					obj->treeProxy = DynamicAabbTree::NULL_NODE;
+				}
+				continue;
+			}
+
+			Aabb world = local.transformed(obj->getModelMatrix());
+			if (obj->treeProxy == DynamicAabbTree::NULL_NODE) {
+				obj->treeProxy = boundsTree.createProxy(world, obj);
+			}
+			else {
+				boundsTree.moveProxy(obj->treeProxy, world, world.center() - obj->treeCenter);
+			}
+			obj->treeCenter = world.center();
+		}
+		refitQueue.clear();
+	}
+
+	void Scene::trackLoad(SceneObject* obj)
+	{
+		{
+			std::lock_guard<std::mutex> lock(loadMutex);
+			if (std::find(loadingObjects.begin(), loadingObjects.end(), obj) != loadingObjects.end()) return;
+			loadingObjects.push_back(obj);
+		}
+		requestRedraw();
+	}
+
+	void Scene::commitLoads()
+	{
+		{
+			std::lock_guard<std::mutex> lock(loadMutex);
+			if (loadingObjects.empty()) return;
+			committingObjects.swap(loadingObjects);
+		}
+
+		// Uploads happen outside the lock so the simulation never waits on them
+		auto committed = std::partition(committingObjects.begin(), committingObjects.end(), [](SceneObject* obj) { return !obj->commitLoad(); });
+
+		{
+			std::lock_guard<std::mutex> lock(loadMutex);
+			for (auto obj = committingObjects.begin(); obj != committingObjects.end(); obj++) {
+				// Removed while its commit ran
+				if ((*obj)->scene != this) continue;
+				(obj < committed ? loadingObjects : loadedObjects).push_back(*obj);
+			}
+			committingObjects.clear();
+		}
+		// Keeps frames coming while loads are in flight, nothing else says when one finishes
+		requestRedraw();
+	}
+
+	void Scene::commitLoadedBounds()
+	{
+		std::vector<SceneObject*> loaded;
+		{
+			std::lock_guard<std::mutex> lock(loadMutex);
+			if (loadedObjects.empty()) return;
+			loaded.swap(loadedObjects);
+		}
+		for (SceneObject* obj : loaded) {
+			obj->commitLoadedBounds();
+		}
+	}
+
+	void Scene::loadObjects(Renderer* renderer)
+	{
 		if (renderer == nullptr) {
 			Alert("Renderer is null!", FATAL);
 			return;
 		}
-		for (auto& obj : sceneObjects) {
-			obj.second->Register(renderer); EXTERN_ERROR(obj.second);
+		applyChanges();
+		std::vector<std::shared_ptr<SceneObject>> objects;
+		{
+			std::lock_guard<std::mutex> lock(objectMutex);
+			objects.assign(sceneObjects.begin(), sceneObjects.end());
+			objectsRegistered = true;
+		}
+		if (objects.empty()) {
+			Alert("No objects in scene to render!", FATAL);
+			return;
+		}
+		redrawTarget = renderer;
+		// Loads done by now go in before registering, so they share buffers instead of refilling a placeholder
+		commitLoads();
+		commitLoadedBounds();
+
+		for (auto& obj : objects) {
+			obj->Register(renderer); EXTERN_ERROR(obj);
+		}
+	}
+
+	void Scene::registerPending(Renderer* renderer)
+	{
+		std::vector<std::shared_ptr<SceneObject>> registering;
+		{
+			std::lock_guard<std::mutex> lock(objectMutex);
+			if (pendingRegistration.empty()) return;
+			registering.swap(pendingRegistration);
+			std::erase_if(registering, [](const std::shared_ptr<SceneObject>& obj) { return obj->sceneHandle == INVALID_HANDLE; });
+		}
+		for (auto& obj : registering) {
+			obj->Register(renderer);
+		}
+	}
+
+	void Scene::releaseRetired(uint64_t presentedTick)
+	{
+		std::vector<std::shared_ptr<SceneObject>> released;
+		{
+			std::lock_guard<std::mutex> lock(retireMutex);
+			if (retiredObjects.empty()) return;
+			for (auto& retired : retiredObjects) {
+				if (retired.first <= presentedTick) released.push_back(std::move(retired.second));
+			}
+			std::erase_if(retiredObjects, [](const auto& retired) { return retired.second == nullptr; });
+		}
+		// The backend keeps drawing every buffer it was given. Objects never presented were not hidden yet.
+		for (auto& obj : released) {
+			obj->hide();
 		}
 	}
 
 	void Scene::updateObjects(Renderer* renderer)
 	{
+		simulate(renderer); EXTERN_ERROR(this);
+		present(renderer, false);
+	}
+
+	void Scene::simulate(Renderer* renderer)
+	{
+		STARRY_PROFILE_SCOPE("Scene Simulate");
 		if (renderer == nullptr) {
 			Alert("Renderer is null!", FATAL);
 			return;
 		}
+		applyChanges();
+		applySaves();
 		glm::mat4 view(1);
 		glm::mat4 proj(1);
+		ViewParameters viewParameters{};
+		bool hasCamera = false;
 
-		for (auto& obj : sceneObjects) {
-			obj.second->Update(renderer); EXTERN_ERROR(obj.second);
-			if (obj.second->getType() == SceneObject::Type::CAMERA) {
-				view = obj.second->getBufferData().view;
-				proj = obj.second->getBufferData().proj;
+		commitLoadedBounds();
+
+		for (SceneObject* obj : unboundedObjects) {
+			obj->Update(renderer); EXTERN_ERROR(obj);
+			if (obj->getType() == SceneObject::Type::CAMERA) {
+				view = obj->getBufferData().view;
+				proj = obj->getBufferData().proj;
+				viewParameters = static_cast<CameraObject*>(obj)->getViewParameters();
+				hasCamera = true;
 			}
 		}
-		for (auto& obj : sceneObjects) {
-			if (obj.second->getType() == SceneObject::Type::MESH) {
-				obj.second->setView(view);
-				obj.second->setProjection(proj);
+
+		// Every object steps, visible or not, so nothing freezes while off screen. Objects only touch their own
+		// state here, so batches of them spread across the job system.
+		JobSystem& jobs = JobSystem::get();
+		std::atomic<bool> failed{ false };
+		transformStore.beginConcurrentWrites();
+		jobs.parallelFor(boundedObjects.size(), UPDATE_BATCH, [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; i++) {
+				SceneObject* obj = boundedObjects[i];
+				obj->Update(renderer);
+				if (obj->getAlertSeverity() == FATAL) failed.store(true, std::memory_order_relaxed);
+			}
+		});
+		transformStore.endConcurrentWrites();
+		if (failed.load()) return;
+
+		// Only subtrees that changed since the last tick are recomputed and refit
+		transformStore.updateWorldMatrices([&](TransformStore::Handle handle) { transformOwners[handle]->markBoundsDirty(); });
+		refitBounds();
+		tickIndex++;
+
+		// Culling only limits what gets published, detail selection and uploads
+		visibleObjects.clear();
+		if (hasCamera) {
+			boundsTree.queryFrustum(Frustum(proj * view), [&](void* userData) {
+				visibleObjects.push_back(static_cast<SceneObject*>(userData));
+			});
+			// Nothing to test objects without bounds against, keep drawing them
+			for (SceneObject* obj : boundedObjects) {
+				if (obj->treeProxy == DynamicAabbTree::NULL_NODE) visibleObjects.push_back(obj);
+			}
+		}
+		else {
+			visibleObjects = boundedObjects;
+		}
+
+		FrameSnapshot& snapshot = snapshots.writeBuffer();
+		snapshot.objects = visibleObjects;
+		snapshot.models.resize(visibleObjects.size());
+		snapshot.previousModels.resize(visibleObjects.size());
+		jobs.parallelFor(visibleObjects.size(), TransformStore::PARALLEL_MATRICES, [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; i++) {
+				SceneObject* obj = visibleObjects[i];
+				glm::mat4 model = obj->getModelMatrix();
+				// Objects that just came into view have nothing to blend from
+				snapshot.previousModels[i] = obj->publishedTick != 0 && obj->publishedTick + 1 == tickIndex ? obj->publishedModel : model;
+				snapshot.models[i] = model;
+				obj->publishedModel = model;
+				obj->publishedTick = tickIndex;
+			}
+		});
+		snapshot.view = view;
+		snapshot.proj = proj;
+		snapshot.viewParameters = viewParameters;
+		snapshot.tick = tickIndex;
+		snapshot.time = std::chrono::steady_clock::now();
+		snapshot.tickSeconds = renderer->getSimulationDeltaSeconds();
+		snapshots.publish();
+
+		visibleObjectCount.store(visibleObjects.size(), std::memory_order_relaxed);
+	}
+
+	void Scene::present(Renderer* renderer, bool interpolate)
+	{
+		STARRY_PROFILE_SCOPE("Scene Present");
+		commitLoads();
+		registerPending(renderer);
+
+		bool fresh = snapshots.acquire();
+		const FrameSnapshot& snapshot = snapshots.readBuffer();
+		// Nothing moved since the last frame
+		if (!fresh && !interpolate) return;
+
+		float blend = 1.0f;
+		if (interpolate && snapshot.tickSeconds > 0.0f) {
+			float sincePublish = std::chrono::duration<float>(std::chrono::steady_clock::now() - snapshot.time).count();
+			blend = std::clamp(sincePublish / snapshot.tickSeconds, 0.0f, 1.0f);
+		}
+		// Such backends only draw what is submitted, so nothing needs hiding and no uniform is written
+		bool packing = renderer->context().drawsObjectBuffer();
+
+		if (fresh) {
+			// Dropped snapshots never reached the renderer, so hiding compares against what was actually presented
+			presentFrame++;
+			for (SceneObject* obj : snapshot.objects) {
+				obj->presentedFrame = presentFrame;
+			}
+			for (SceneObject* obj : presentedObjects) {
+				if (obj->presentedFrame != presentFrame && !packing) obj->hide();
+			}
+			presentedObjects = snapshot.objects;
+			releaseRetired(snapshot.tick);
+
+			// Instances of one mesh and material become neighbours in the object buffer
+			batchKeys.resize(snapshot.objects.size());
+			for (size_t i = 0; i < snapshot.objects.size(); i++) {
+				batchKeys[i] = snapshot.objects[i]->getBatchKey();
+			}
+			batcher.build(batchKeys.data(), batchKeys.size());
+			instanceBatchCount.store(batcher.getBatches().size(), std::memory_order_relaxed);
+		}
+
+		size_t count = snapshot.objects.size();
+		JobSystem& jobs = JobSystem::get();
+		const std::vector<uint32_t>& order = batcher.getOrder();
+
+		// Gathered into batch order, blending on the way when interpolating. Unless the object buffer is packed,
+		// which computes them too, each batch is then multiplied into model view projections while still in cache.
+		glm::mat4 viewProjection = snapshot.proj * snapshot.view;
+		presentModels.resize(count);
+		if (!packing) presentModelViewProjections.resize(count);
+		jobs.parallelFor(count, TransformStore::PARALLEL_MATRICES, [&](size_t begin, size_t end) {
+			for (size_t position = begin; position < end; position++) {
+				uint32_t i = order[position];
+				if (blend >= 1.0f) {
+					presentModels[position] = snapshot.models[i];
+					continue;
+				}
+				// Column blend, close enough to a proper TRS blend over the small motion of one tick
+				for (int column = 0; column < 4; column++) {
+					presentModels[position][column] = glm::mix(snapshot.previousModels[i][column], snapshot.models[i][column], blend);
+				}
+			}
+			if (!packing) {
+				TransformKernels::multiply(viewProjection, presentModels.data() + begin, presentModelViewProjections.data() + begin, end - begin);
+			}
+		});
+		const glm::mat4* models = presentModels.data();
+
+		// One contiguous pass for every object's model view projection and normal matrix, for backends that bind it
+		const ObjectData* packed = packing ? objectData.pack(viewProjection, models, count) : nullptr;
+
+		jobs.parallelFor(count, UPDATE_BATCH, [&](size_t begin, size_t end) {
+			for (size_t position = begin; position < end; position++) {
+				SceneObject* obj = snapshot.objects[order[position]];
+				obj->objectIndex = static_cast<uint32_t>(position);
+
+				// Render::RenderContext binds one uniform per object, it cannot bind the object buffer yet
+				if (!packing) {
+					Render::UniformData data = { 1.0f, 1.0f, 1.0f };
+					data.model = models[position];
+					data.view = snapshot.view;
+					data.proj = snapshot.proj;
+					obj->uploadUniform(data);
+				}
+				const glm::mat4& modelViewProjection = packed != nullptr ? packed[position].modelViewProjection : presentModelViewProjections[position];
+				obj->updateDetail(snapshot.viewParameters, models[position], modelViewProjection);
+			}
+		});
+		for (SceneObject* obj : snapshot.objects) {
+			obj->flushDetail();
+		}
+		if (!packing) return;
+
+		// One instanced draw per batch, instance i reads entry i of the object buffer. A batch only splits
+		// around members with nothing to draw or another buffer.
+		objectDraws.clear();
+		for (const InstanceBatch& batch : batcher.getBatches()) {
+			ObjectDraw draw;
+			for (uint32_t position = batch.firstInstance; position < batch.firstInstance + batch.instanceCount; position++) {
+				ObjectDraw next{ nullptr, nullptr, position, 1 };
+				bool drawable = snapshot.objects[order[position]]->getDrawResources(next.buffer, next.descriptorSet);
+				if (drawable && draw.instanceCount > 0 && next.buffer == draw.buffer) {
+					draw.instanceCount++;
+					continue;
+				}
+				if (draw.instanceCount > 0) objectDraws.push_back(draw);
+				draw = drawable ? next : ObjectDraw{};
 			}
+			if (draw.instanceCount > 0) objectDraws.push_back(draw);
 		}
+		renderer->context().submitObjects(packed, count, objectDraws);
 	}
-}
\ No newline at end of file
+}
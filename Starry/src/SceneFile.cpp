@@ -0,0 +1,182 @@
+#include "SceneFile.h"
+
+#include "ContentHash.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+
+namespace Starry
+{
+	namespace
+	{
+		uint64_t alignUp(uint64_t value, uint64_t alignment)
+		{
+			return (value + alignment - 1) & ~(alignment - 1);
+		}
+
+		// Byte for byte what write() puts after the header, so the hash can be taken before writing
+		void appendBytes(std::string& payload, const void* data, size_t size, uint64_t offset)
+		{
+			payload.resize(offset - sizeof(SceneFileHeader), '\0');
+			payload.append(static_cast<const char*>(data), size);
+		}
+	}
+
+	void SceneFileWriter::reserve(size_t objectCount)
+	{
+		objects.reserve(objectCount);
+		strings.reserve(objectCount * 16);
+	}
+
+	uint32_t SceneFileWriter::addString(std::string_view text)
+	{
+		uint32_t offset = static_cast<uint32_t>(strings.size());
+		strings.append(text);
+		return offset;
+	}
+
+	uint32_t SceneFileWriter::addAsset(SceneAssetKind kind, const std::string& path, uint64_t contentHash)
+	{
+		std::string key = std::to_string(static_cast<uint32_t>(kind)) + ":" + path;
+		auto found = assetIndices.find(key);
+		if (found != assetIndices.end()) {
+			SceneAssetRecord& asset = assets[found->second];
+			if (asset.contentHash == 0) asset.contentHash = contentHash;
+			return found->second;
+		}
+
+		SceneAssetRecord asset{};
+		asset.contentHash = contentHash;
+		asset.kind = kind;
+		asset.pathOffset = addString(path);
+		asset.pathLength = static_cast<uint32_t>(path.size());
+
+		uint32_t index = static_cast<uint32_t>(assets.size());
+		assets.push_back(asset);
+		assetIndices.emplace(std::move(key), index);
+		return index;
+	}
+
+	void SceneFileWriter::addObject(SceneObjectRecord record, std::string_view name)
+	{
+		record.nameOffset = addString(name);
+		record.nameLength = static_cast<uint32_t>(name.size());
+		objects.push_back(record);
+	}
+
+	void SceneFileWriter::hashMissingAssets()
+	{
+		for (SceneAssetRecord& asset : assets) {
+			if (asset.contentHash != 0) continue;
+			hashFile(std::string(assetPath(asset)), asset.contentHash);
+		}
+	}
+
+	bool SceneFileWriter::write(const std::string& filePath) const
+	{
+		SceneFileHeader header{};
+		header.version = SceneFile::VERSION;
+		header.objectCount = static_cast<uint32_t>(objects.size());
+		header.assetCount = static_cast<uint32_t>(assets.size());
+		header.objectOffset = alignUp(sizeof(SceneFileHeader), SceneFile::PAYLOAD_ALIGNMENT);
+		header.assetOffset = alignUp(header.objectOffset + objects.size() * sizeof(SceneObjectRecord), SceneFile::PAYLOAD_ALIGNMENT);
+		header.stringOffset = alignUp(header.assetOffset + assets.size() * sizeof(SceneAssetRecord), SceneFile::PAYLOAD_ALIGNMENT);
+		header.stringBytes = strings.size();
+
+		std::string payload;
+		payload.reserve(header.stringOffset + strings.size() - sizeof(SceneFileHeader));
+		appendBytes(payload, objects.data(), objects.size() * sizeof(SceneObjectRecord), header.objectOffset);
+		appendBytes(payload, assets.data(), assets.size() * sizeof(SceneAssetRecord), header.assetOffset);
+		appendBytes(payload, strings.data(), strings.size(), header.stringOffset);
+		header.payloadHash = hashBytes(payload.data(), payload.size());
+
+		std::error_code error;
+		std::filesystem::path target(filePath);
+		if (target.has_parent_path()) {
+			std::filesystem::create_directories(target.parent_path(), error);
+		}
+
+		std::filesystem::path temporary = target;
+		temporary += ".tmp";
+
+		{
+			std::ofstream stream(temporary, std::ios::binary | std::ios::trunc);
+			if (!stream) return false;
+
+			stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			stream.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+
+			if (!stream.good()) {
+				stream.close();
+				std::filesystem::remove(temporary, error);
+				return false;
+			}
+		}
+
+		std::filesystem::rename(temporary, target, error);
+		if (error) {
+			std::filesystem::remove(temporary, error);
+			return false;
+		}
+		return true;
+	}
+
+	void SceneFile::close()
+	{
+		file.close();
+		objects = {};
+		assets = {};
+		strings = {};
+	}
+
+	bool SceneFile::open(const std::string& filePath)
+	{
+		close();
+
+		if (!file.open(filePath) || file.size() < sizeof(SceneFileHeader)) {
+			close();
+			return false;
+		}
+
+		SceneFileHeader header{};
+		std::memcpy(&header, file.data(), sizeof(header));
+
+		bool valid = std::memcmp(header.magic, SceneFileHeader{}.magic, sizeof(header.magic)) == 0
+			&& header.version == VERSION
+			&& header.objectOffset % PAYLOAD_ALIGNMENT == 0
+			&& header.assetOffset % PAYLOAD_ALIGNMENT == 0
+			&& header.objectOffset >= sizeof(SceneFileHeader)
+			&& header.objectOffset + uint64_t(header.objectCount) * sizeof(SceneObjectRecord) <= header.assetOffset
+			&& header.assetOffset + uint64_t(header.assetCount) * sizeof(SceneAssetRecord) <= header.stringOffset
+			&& header.stringOffset + header.stringBytes == file.size()
+			&& hashBytes(file.data() + sizeof(header), file.size() - sizeof(header)) == header.payloadHash;
+		if (!valid) {
+			close();
+			return false;
+		}
+
+		objects = { reinterpret_cast<const SceneObjectRecord*>(file.data() + header.objectOffset), header.objectCount };
+		assets = { reinterpret_cast<const SceneAssetRecord*>(file.data() + header.assetOffset), header.assetCount };
+		strings = std::string_view(file.data() + header.stringOffset, header.stringBytes);
+
+		// Records are trusted from here on, so every reference is checked once up front
+		auto inStrings = [&](uint32_t offset, uint32_t length) { return uint64_t(offset) + length <= strings.size(); };
+		for (const SceneAssetRecord& asset : assets) {
+			if (!inStrings(asset.pathOffset, asset.pathLength)) valid = false;
+		}
+		for (size_t i = 0; i < objects.size() && valid; i++) {
+			const SceneObjectRecord& object = objects[i];
+			valid = inStrings(object.nameOffset, object.nameLength)
+				&& (object.parent == SceneObjectRecord::NO_INDEX || object.parent < i)
+				&& (object.mesh == SceneObjectRecord::NO_INDEX || object.mesh < assets.size())
+				&& (object.texture == SceneObjectRecord::NO_INDEX || object.texture < assets.size());
+		}
+		if (!valid) {
+			close();
+			return false;
+		}
+		return true;
+	}
+}
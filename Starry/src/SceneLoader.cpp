@@ -0,0 +1,78 @@
+#include "SceneLoader.h"
+
+#include "CameraObject.h"
+#include "MeshObject.h"
+
+#include <algorithm>
+
+namespace Starry
+{
+	bool SceneLoader::open(const std::string& filePath)
+	{
+		close();
+		if (!file.open(filePath)) return false;
+		built.resize(file.getObjects().size());
+		return true;
+	}
+
+	void SceneLoader::close()
+	{
+		file.close();
+		next = 0;
+		built.clear();
+		batch.clear();
+	}
+
+	std::shared_ptr<SceneObject> SceneLoader::create(const SceneObjectRecord& record)
+	{
+		switch (record.type) {
+			case SceneObject::Type::MESH: return std::make_shared<MeshObject>();
+			case SceneObject::Type::CAMERA: return std::make_shared<CameraObject>();
+			default: return nullptr;
+		}
+	}
+
+	size_t SceneLoader::loadNext(Scene& scene, size_t maxObjects)
+	{
+		std::span<const SceneObjectRecord> records = file.getObjects();
+		size_t end = std::min(records.size(), next + maxObjects);
+		size_t first = next;
+
+		batch.clear();
+		for (; next < end; next++) {
+			const SceneObjectRecord& record = records[next];
+			std::shared_ptr<SceneObject> obj = create(record);
+			if (obj == nullptr) continue;
+
+			obj->name = std::string(file.getName(record));
+			// Before the transform and the push, loads have to start while the object is outside the scene
+			obj->loadRecord(record, file);
+
+			LocalTransform local{};
+			local.translation = glm::vec3(record.translation[0], record.translation[1], record.translation[2]);
+			local.rotation = glm::quat(record.rotation[0], record.rotation[1], record.rotation[2], record.rotation[3]);
+			local.scale = glm::vec3(record.scale[0], record.scale[1], record.scale[2]);
+			obj->setLocalTransform(local);
+
+			// Parents come earlier in the file, so they were built in this batch or a previous one
+			if (record.parent != SceneObjectRecord::NO_INDEX && built[record.parent] != nullptr) {
+				obj->setParent(built[record.parent].get());
+			}
+
+			built[next] = obj;
+			batch.push_back(std::move(obj));
+		}
+
+		scene.pushObjects(batch);
+		batch.clear();
+		return next - first;
+	}
+
+	bool SceneLoader::load(Scene& scene, const std::string& filePath)
+	{
+		SceneLoader loader;
+		if (!loader.open(filePath)) return false;
+		loader.loadNext(scene, loader.getObjectCount());
+		return true;
+	}
+}
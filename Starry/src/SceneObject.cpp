@@ -1,20 +1,112 @@
 #include "SceneObject.h"
 
+#include "Scene.h"
+
 namespace Starry
 {
 	void SceneObject::rotate(float angleRadians, const glm::vec3& axis)
 	{
-		mvpBufferData.model = glm::rotate(mvpBufferData.model, angleRadians, axis);
+		LocalTransform local = getLocalTransform();
+		local.rotation = glm::normalize(local.rotation * glm::angleAxis(angleRadians, glm::normalize(axis)));
+		setLocalTransform(local);
 	}
 
 	void SceneObject::translate(const glm::vec3& translation)
 	{
-		mvpBufferData.model = glm::translate(mvpBufferData.model, translation);
+		LocalTransform local = getLocalTransform();
+		local.translation = glm::vec3(local.matrix() * glm::vec4(translation, 1.0f));
+		setLocalTransform(local);
 	}
 
 	void SceneObject::scale(const glm::vec3& scaleFactors)
 	{
-		mvpBufferData.model = glm::scale(mvpBufferData.model, scaleFactors);
+		LocalTransform local = getLocalTransform();
+		local.scale *= scaleFactors;
+		setLocalTransform(local);
+	}
+
+	const LocalTransform& SceneObject::getLocalTransform() const
+	{
+		return transforms != nullptr ? transforms->getLocal(transformHandle) : localTransform;
+	}
+
+	void SceneObject::setLocalTransform(const LocalTransform& local)
+	{
+		if (transforms != nullptr) {
+			transforms->setLocal(transformHandle, local);
+		}
+		else {
+			localTransform = local;
+		}
+		if (scene != nullptr) scene->requestRedraw();
+	}
+
+	void SceneObject::setPosition(const glm::vec3& position)
+	{
+		LocalTransform local = getLocalTransform();
+		local.translation = position;
+		setLocalTransform(local);
+	}
+
+	void SceneObject::setRotation(const glm::quat& rotation)
+	{
+		LocalTransform local = getLocalTransform();
+		local.rotation = glm::normalize(rotation);
+		setLocalTransform(local);
+	}
+
+	void SceneObject::setScale(const glm::vec3& scaleFactors)
+	{
+		LocalTransform local = getLocalTransform();
+		local.scale = scaleFactors;
+		setLocalTransform(local);
+	}
+
+	void SceneObject::setParent(SceneObject* parent)
+	{
+		if (parent == parentObject) return;
+
+		if (transforms != nullptr && parent != nullptr && parent->transforms == transforms) {
+			if (!transforms->setParent(transformHandle, parent->transformHandle)) {
+				Alert("Cannot parent an object to itself or one of its children!", CRITICAL);
+				return;
+			}
+		}
+		else if (transforms != nullptr) {
+			// Unlinks now, a parent outside the store is linked once it joins the scene
+			transforms->setParent(transformHandle, TransformStore::INVALID_HANDLE);
+		}
+		parentObject = parent;
+	}
+
+	void SceneObject::markBoundsDirty()
+	{
+		if (boundsDirty) return;
+		boundsDirty = true;
+		if (scene != nullptr) scene->refitQueue.push_back(this);
+	}
+
+	void SceneObject::markLoadPending()
+	{
+		if (scene != nullptr) scene->trackLoad(this);
+	}
+
+	Aabb SceneObject::getWorldBounds() const
+	{
+		Aabb local{};
+		if (!getLocalBounds(local)) return local;
+		return local.transformed(getModelMatrix());
+	}
+
+	glm::mat4 SceneObject::getModelMatrix() const
+	{
+		return transforms != nullptr ? transforms->computeWorld(transformHandle) : localTransform.matrix();
+	}
+
+	Render::UniformData& SceneObject::getBufferData()
+	{
+		mvpBufferData.model = getModelMatrix();
+		return mvpBufferData;
 	}
 
 	void SceneObject::setProjection(const glm::mat4& proj)
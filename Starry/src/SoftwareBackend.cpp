@@ -0,0 +1,193 @@
+#include "SoftwareBackend.h"
+
+#include "ImageDecoder.h"
+#include "Profiler.h"
+
+#include <algorithm>
+
+namespace Starry
+{
+	namespace
+	{
+		uint32_t sampleCount(Render::RenderConfig::MSAAOptions msaa)
+		{
+			switch (msaa) {
+				case Render::RenderConfig::MSAAOptions::MSAA_2X: return 2;
+				case Render::RenderConfig::MSAAOptions::MSAA_4X: return 4;
+				case Render::RenderConfig::MSAAOptions::MSAA_8X: return 8;
+				default: return 1;
+			}
+		}
+	}
+
+	SoftwareBackend::SoftwareBackend(const RenderConfig& config) : extent(config.headlessExtent)
+	{
+		const auto& clear = config.softwareClearColor;
+		rasterizer.setClearColor(glm::vec4(clear[0], clear[1], clear[2], 1.0f));
+		rasterizer.setTarget(extent[0], extent[1], sampleCount(config.softwareMsaa));
+		// Created before any texture loads, an application decoder set earlier wins
+		if (!TextureCooker::hasDecoder()) TextureCooker::setDecoder(ImageDecoder::decode);
+	}
+
+	void SoftwareBackend::Load(std::shared_ptr<Render::Buffer>& buffer)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		drawItems.push_back({ buffer, nullptr });
+	}
+
+	void SoftwareBackend::Load(std::shared_ptr<Render::DescriptorSet>& descriptorSet)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		// Objects load their buffer and then their descriptor set
+		for (auto item = drawItems.rbegin(); item != drawItems.rend(); item++) {
+			if (item->descriptorSet == nullptr) {
+				item->descriptorSet = descriptorSet;
+				return;
+			}
+		}
+	}
+
+	void SoftwareBackend::loadBufferData(Render::Buffer& buffer, std::vector<Render::Vertex>& vertices, std::vector<uint32_t>& indices)
+	{
+		MeshData mesh;
+		mesh.vertices.resize(vertices.size());
+		for (size_t i = 0; i < vertices.size(); i++) {
+			mesh.vertices[i].position = vertices[i].position;
+			mesh.vertices[i].texCoord = vertices[i].texCoord;
+		}
+		mesh.indices = indices;
+
+		std::lock_guard<std::mutex> lock(mutex);
+		meshes[&buffer] = std::move(mesh);
+	}
+
+	void SoftwareBackend::writeUniform(Render::Uniform& uniform, Render::UniformData& data)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		uniforms.insert_or_assign(uniform.getUUID(), data);
+	}
+
+	void SoftwareBackend::storeTexture(Render::TextureImage& texture, const std::string& filePath)
+	{
+		TextureImageData image;
+		CookedTexture cooked;
+		TextureCookOptions options{ TextureCompression::NONE, false };
+		if (TextureCooker::cookFile(filePath, "", options, cooked) && !cooked.mips.empty()) {
+			const TextureMip& top = cooked.mips[0];
+			image.width = top.width;
+			image.height = top.height;
+			image.pixels.assign(cooked.data.begin() + top.offset, cooked.data.begin() + top.offset + top.size);
+		}
+
+		std::lock_guard<std::mutex> lock(mutex);
+		textures[texture.getUUID()] = std::move(image);
+	}
+
+	void SoftwareBackend::bindDescriptors(Render::DescriptorSet& descriptorSet, const std::vector<size_t>& descriptors)
+	{
+		RenderBackend::bindDescriptors(descriptorSet, descriptors);
+
+		std::lock_guard<std::mutex> lock(mutex);
+		descriptorSets[&descriptorSet] = descriptors;
+	}
+
+	void SoftwareBackend::submitObjects(const ObjectData* objects, size_t count, const std::vector<ObjectDraw>& draws)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		objectsSubmitted = true;
+		objectData.assign(objects, objects + count);
+		objectDraws = draws;
+	}
+
+	const TextureImageData* SoftwareBackend::boundTexture(const std::vector<size_t>& bindings) const
+	{
+		if (bindings.size() < 2) return nullptr;
+		auto found = textures.find(bindings[1]);
+		return found != textures.end() ? &found->second : nullptr;
+	}
+
+	void SoftwareBackend::drawLoadedBuffers()
+	{
+		for (const DrawItem& item : drawItems) {
+			auto mesh = meshes.find(item.buffer.get());
+			if (mesh == meshes.end() || item.descriptorSet == nullptr) continue;
+			auto bindings = descriptorSets.find(item.descriptorSet.get());
+			if (bindings == descriptorSets.end() || bindings->second.empty()) continue;
+
+			auto uniform = uniforms.find(bindings->second[0]);
+			if (uniform == uniforms.end()) continue;
+
+			const Render::UniformData& data = uniform->second;
+			RasterDraw draw;
+			draw.vertices = mesh->second.vertices.data();
+			draw.vertexCount = mesh->second.vertices.size();
+			draw.indices = mesh->second.indices.data();
+			draw.indexCount = mesh->second.indices.size();
+			draw.modelViewProjection = data.proj * data.view * data.model;
+			draw.texture = boundTexture(bindings->second);
+			rasterizer.draw(draw);
+		}
+	}
+
+	void SoftwareBackend::drawObjects()
+	{
+		for (const ObjectDraw& objectDraw : objectDraws) {
+			auto mesh = meshes.find(objectDraw.buffer);
+			if (mesh == meshes.end()) continue;
+			auto bindings = descriptorSets.find(objectDraw.descriptorSet);
+
+			RasterDraw draw;
+			draw.vertices = mesh->second.vertices.data();
+			draw.vertexCount = mesh->second.vertices.size();
+			draw.indices = mesh->second.indices.data();
+			draw.indexCount = mesh->second.indices.size();
+			draw.texture = bindings != descriptorSets.end() ? boundTexture(bindings->second) : nullptr;
+			// The rasterizer has no instancing, each instance becomes a draw of its own
+			size_t end = std::min<size_t>(objectDraw.firstInstance + objectDraw.instanceCount, objectData.size());
+			for (size_t instance = objectDraw.firstInstance; instance < end; instance++) {
+				draw.modelViewProjection = objectData[instance].modelViewProjection;
+				rasterizer.draw(draw);
+			}
+		}
+	}
+
+	void SoftwareBackend::Draw()
+	{
+		STARRY_PROFILE_FUNCTION();
+		std::lock_guard<std::mutex> lock(mutex);
+
+		rasterizer.begin();
+		if (objectsSubmitted) {
+			drawObjects();
+		}
+		else {
+			drawLoadedBuffers();
+		}
+		rasterizer.render();
+		frames++;
+	}
+
+	std::vector<uint8_t> SoftwareBackend::getFrame() const
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		return rasterizer.getImage();
+	}
+
+	bool SoftwareBackend::writeFrame(const std::string& filePath) const
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		return SoftwareRasterizer::writeImage(filePath, rasterizer.getImage().data(), rasterizer.getWidth(), rasterizer.getHeight());
+	}
+
+	RasterStats SoftwareBackend::getLastFrameStats() const
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		return rasterizer.getStats();
+	}
+
+	uint64_t SoftwareBackend::getFrameCount() const
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		return frames;
+	}
+}
@@ -0,0 +1,539 @@
+#include "SoftwareRasterizer.h"
+
+#include "JobSystem.h"
+#include "Profiler.h"
+#include "TransformKernels.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace Starry
+{
+	namespace
+	{
+		// Vulkan's standard sample locations, in pixel units from the top left corner
+		constexpr float SAMPLE_X_1[] = { 0.5f };
+		constexpr float SAMPLE_Y_1[] = { 0.5f };
+		constexpr float SAMPLE_X_2[] = { 0.75f, 0.25f };
+		constexpr float SAMPLE_Y_2[] = { 0.75f, 0.25f };
+		constexpr float SAMPLE_X_4[] = { 0.375f, 0.875f, 0.125f, 0.625f };
+		constexpr float SAMPLE_Y_4[] = { 0.125f, 0.375f, 0.625f, 0.875f };
+		constexpr float SAMPLE_X_8[] = { 0.5625f, 0.4375f, 0.8125f, 0.3125f, 0.1875f, 0.0625f, 0.6875f, 0.9375f };
+		constexpr float SAMPLE_Y_8[] = { 0.3125f, 0.6875f, 0.5625f, 0.1875f, 0.8125f, 0.4375f, 0.9375f, 0.0625f };
+
+		const float* sampleXFor(uint32_t samples)
+		{
+			switch (samples) {
+				case 2: return SAMPLE_X_2;
+				case 4: return SAMPLE_X_4;
+				case 8: return SAMPLE_X_8;
+				default: return SAMPLE_X_1;
+			}
+		}
+
+		const float* sampleYFor(uint32_t samples)
+		{
+			switch (samples) {
+				case 2: return SAMPLE_Y_2;
+				case 4: return SAMPLE_Y_4;
+				case 8: return SAMPLE_Y_8;
+				default: return SAMPLE_Y_1;
+			}
+		}
+
+		// Vulkan's clip volume, 0 <= z <= w, plus a guard band on x and y and a floor on w for the divide
+		constexpr int CLIP_PLANES = 7;
+		constexpr float MIN_W = 1e-5f;
+		// Each plane adds at most one corner
+		constexpr int MAX_CLIP_CORNERS = 3 + CLIP_PLANES;
+
+		float planeDistance(const glm::vec4& p, int plane)
+		{
+			const float guard = SoftwareRasterizer::GUARD_BAND;
+			switch (plane) {
+				case 0: return p.w - MIN_W;
+				case 1: return p.z;
+				case 2: return p.w - p.z;
+				case 3: return p.x + guard * p.w;
+				case 4: return guard * p.w - p.x;
+				case 5: return p.y + guard * p.w;
+				default: return guard * p.w - p.y;
+			}
+		}
+
+		uint32_t outsideMask(const glm::vec4& p)
+		{
+			uint32_t mask = 0;
+			for (int plane = 0; plane < CLIP_PLANES; plane++) {
+				if (!(planeDistance(p, plane) >= 0.0f)) mask |= 1u << plane;
+			}
+			return mask;
+		}
+
+		uint8_t toUnorm8(float value)
+		{
+			return static_cast<uint8_t>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+		}
+
+		// Bilinear, repeat addressing, the top mip only
+		uint32_t sampleTexture(const TextureImageData& texture, float u, float v)
+		{
+			if (!std::isfinite(u)) u = 0.0f;
+			if (!std::isfinite(v)) v = 0.0f;
+			float fu = (u - std::floor(u)) * texture.width - 0.5f;
+			float fv = (v - std::floor(v)) * texture.height - 0.5f;
+			float baseU = std::floor(fu);
+			float baseV = std::floor(fv);
+			float fx = fu - baseU;
+			float fy = fv - baseV;
+
+			int32_t w = static_cast<int32_t>(texture.width);
+			int32_t h = static_cast<int32_t>(texture.height);
+			int32_t x0 = (static_cast<int32_t>(baseU) + w) % w;
+			int32_t y0 = (static_cast<int32_t>(baseV) + h) % h;
+			int32_t x1 = (x0 + 1) % w;
+			int32_t y1 = (y0 + 1) % h;
+
+			const uint8_t* p00 = &texture.pixels[(static_cast<size_t>(y0) * w + x0) * 4];
+			const uint8_t* p10 = &texture.pixels[(static_cast<size_t>(y0) * w + x1) * 4];
+			const uint8_t* p01 = &texture.pixels[(static_cast<size_t>(y1) * w + x0) * 4];
+			const uint8_t* p11 = &texture.pixels[(static_cast<size_t>(y1) * w + x1) * 4];
+
+			uint32_t color = 0;
+			for (int c = 0; c < 4; c++) {
+				float top = p00[c] * (1.0f - fx) + p10[c] * fx;
+				float bottom = p01[c] * (1.0f - fx) + p11[c] * fx;
+				float value = top * (1.0f - fy) + bottom * fy;
+				color |= static_cast<uint32_t>(std::min(value + 0.5f, 255.0f)) << (8 * c);
+			}
+			return color;
+		}
+	}
+
+	void SoftwareRasterizer::setTarget(uint32_t targetWidth, uint32_t targetHeight, uint32_t targetSamples)
+	{
+		width = std::max<uint32_t>(targetWidth, 1);
+		height = std::max<uint32_t>(targetHeight, 1);
+		samples = (targetSamples == 2 || targetSamples == 4 || targetSamples == 8) ? targetSamples : 1;
+		stride = (width + SPAN - 1) / SPAN * SPAN;
+		tilesX = (width + TILE_SIZE - 1) / TILE_SIZE;
+		tilesY = (height + TILE_SIZE - 1) / TILE_SIZE;
+
+		size_t plane = static_cast<size_t>(stride) * height;
+		depthSamples.assign(plane * samples, 1.0f);
+		colorSamples.assign(plane * samples, clearColor);
+		image.assign(static_cast<size_t>(width) * height * 4, 0);
+	}
+
+	void SoftwareRasterizer::setClearColor(const glm::vec4& color)
+	{
+		clearColor = static_cast<uint32_t>(toUnorm8(color.x)) | static_cast<uint32_t>(toUnorm8(color.y)) << 8 |
+			static_cast<uint32_t>(toUnorm8(color.z)) << 16 | static_cast<uint32_t>(toUnorm8(color.w)) << 24;
+	}
+
+	void SoftwareRasterizer::begin()
+	{
+		draws.clear();
+	}
+
+	void SoftwareRasterizer::draw(const RasterDraw& drawInput)
+	{
+		if (drawInput.vertices == nullptr || drawInput.indices == nullptr || drawInput.indexCount < 3) return;
+		if (drawInput.texture != nullptr && (drawInput.texture->width == 0 || drawInput.texture->height == 0 ||
+			drawInput.texture->pixels.size() < static_cast<size_t>(drawInput.texture->width) * drawInput.texture->height * 4)) {
+			RasterDraw untextured = drawInput;
+			untextured.texture = nullptr;
+			draws.push_back(untextured);
+			return;
+		}
+		draws.push_back(drawInput);
+	}
+
+	void SoftwareRasterizer::render()
+	{
+		STARRY_PROFILE_SCOPE("Software Raster");
+		if (width == 0) return;
+
+		stats = {};
+		stats.draws = draws.size();
+
+		drawTriangles.assign(draws.size() + 1, 0);
+		drawVertices.assign(draws.size() + 1, 0);
+		for (size_t i = 0; i < draws.size(); i++) {
+			drawTriangles[i + 1] = drawTriangles[i] + draws[i].indexCount / 3;
+			drawVertices[i + 1] = drawVertices[i] + draws[i].vertexCount;
+		}
+		size_t triangleCount = drawTriangles.back();
+		stats.triangles = triangleCount;
+
+		JobSystem& jobs = JobSystem::get();
+		auto setupStart = std::chrono::steady_clock::now();
+		{
+			STARRY_PROFILE_SCOPE("Raster Setup");
+			transformVertices();
+
+			size_t batchCount = std::clamp<size_t>((triangleCount + SETUP_BATCH - 1) / SETUP_BATCH, 1,
+				jobs.threadCount() * JobSystem::BATCHES_PER_THREAD);
+			size_t tileCount = static_cast<size_t>(tilesX) * tilesY;
+			batches.resize(batchCount);
+			for (size_t i = 0; i < batchCount; i++) {
+				Batch& batch = batches[i];
+				batch.triangleBegin = (triangleCount * i) / batchCount;
+				batch.triangleEnd = (triangleCount * (i + 1)) / batchCount;
+			}
+
+			jobs.parallelFor(batchCount, 1, [&](size_t begin, size_t end) {
+				for (size_t i = begin; i < end; i++) {
+					Batch& batch = batches[i];
+					batch.bins.resize(tileCount);
+					setupBatch(batch);
+				}
+			});
+
+			for (const Batch& batch : batches) {
+				stats.clipped += batch.clipped;
+				stats.culled += batch.culled;
+				stats.binned += batch.binned;
+			}
+		}
+		auto rasterStart = std::chrono::steady_clock::now();
+		{
+			STARRY_PROFILE_SCOPE("Raster Tiles");
+			std::atomic<size_t> shaded{ 0 };
+			jobs.parallelFor(static_cast<size_t>(tilesX) * tilesY, 1, [&](size_t begin, size_t end) {
+				for (size_t tile = begin; tile < end; tile++) {
+					rasterizeTile(static_cast<uint32_t>(tile), shaded);
+				}
+			});
+			stats.shadedPixels = shaded.load(std::memory_order_relaxed);
+		}
+		auto rasterEnd = std::chrono::steady_clock::now();
+
+		stats.setupSeconds = std::chrono::duration<double>(rasterStart - setupStart).count();
+		stats.rasterSeconds = std::chrono::duration<double>(rasterEnd - rasterStart).count();
+	}
+
+	void SoftwareRasterizer::transformVertices()
+	{
+		clipVertices.resize(drawVertices.back());
+		JobSystem& jobs = JobSystem::get();
+		for (size_t d = 0; d < draws.size(); d++) {
+			const RasterDraw& current = draws[d];
+			glm::vec4* output = clipVertices.data() + drawVertices[d];
+			jobs.parallelFor(current.vertexCount, 4096, [&](size_t begin, size_t end) {
+				for (size_t i = begin; i < end; i++) {
+					output[i] = current.modelViewProjection * glm::vec4(current.vertices[i].position, 1.0f);
+				}
+			});
+		}
+	}
+
+	void SoftwareRasterizer::setupBatch(Batch& batch)
+	{
+		batch.triangles.clear();
+		for (auto& bin : batch.bins) {
+			bin.clear();
+		}
+		batch.clipped = 0;
+		batch.culled = 0;
+		batch.binned = 0;
+		if (batch.triangleBegin == batch.triangleEnd) return;
+
+		size_t drawIndex = std::upper_bound(drawTriangles.begin(), drawTriangles.end(), batch.triangleBegin) - drawTriangles.begin() - 1;
+		for (size_t t = batch.triangleBegin; t < batch.triangleEnd; t++) {
+			while (t >= drawTriangles[drawIndex + 1]) drawIndex++;
+			const RasterDraw& current = draws[drawIndex];
+			const uint32_t* indices = current.indices + (t - drawTriangles[drawIndex]) * 3;
+			const glm::vec4* clip = clipVertices.data() + drawVertices[drawIndex];
+
+			ClipVertex corners[3];
+			uint32_t outside[3];
+			bool valid = true;
+			for (int i = 0; i < 3; i++) {
+				if (indices[i] >= current.vertexCount) {
+					valid = false;
+					break;
+				}
+				corners[i] = { clip[indices[i]], current.vertices[indices[i]].texCoord };
+				outside[i] = outsideMask(corners[i].position);
+			}
+			// Every corner beyond the same plane, or a bad index
+			if (!valid || (outside[0] & outside[1] & outside[2]) != 0) {
+				batch.culled++;
+				continue;
+			}
+			if ((outside[0] | outside[1] | outside[2]) == 0) {
+				setupTriangle(batch, corners, static_cast<uint32_t>(drawIndex));
+				continue;
+			}
+
+			// Sutherland Hodgman against only the planes some corner is beyond, then a fan
+			batch.clipped++;
+			ClipVertex polygons[2][MAX_CLIP_CORNERS];
+			std::copy(corners, corners + 3, polygons[0]);
+			int count = 3;
+			int source = 0;
+			uint32_t planes = outside[0] | outside[1] | outside[2];
+			for (int plane = 0; plane < CLIP_PLANES && count >= 3; plane++) {
+				if ((planes & (1u << plane)) == 0) continue;
+				const ClipVertex* input = polygons[source];
+				ClipVertex* output = polygons[source ^ 1];
+				int written = 0;
+				for (int i = 0; i < count; i++) {
+					const ClipVertex& a = input[i];
+					const ClipVertex& b = input[(i + 1) % count];
+					float da = planeDistance(a.position, plane);
+					float db = planeDistance(b.position, plane);
+					if (da >= 0.0f) output[written++] = a;
+					if ((da >= 0.0f) != (db >= 0.0f)) {
+						float f = da / (da - db);
+						output[written++] = { a.position + (b.position - a.position) * f, a.texCoord + (b.texCoord - a.texCoord) * f };
+					}
+				}
+				count = written;
+				source ^= 1;
+			}
+			for (int i = 1; i + 1 < count; i++) {
+				ClipVertex fan[3] = { polygons[source][0], polygons[source][i], polygons[source][i + 1] };
+				setupTriangle(batch, fan, static_cast<uint32_t>(drawIndex));
+			}
+		}
+	}
+
+	void SoftwareRasterizer::setupTriangle(Batch& batch, const ClipVertex* corners, uint32_t drawIndex)
+	{
+		float x[3], y[3];
+		Triangle triangle;
+		for (int i = 0; i < 3; i++) {
+			const glm::vec4& p = corners[i].position;
+			float inverseW = 1.0f / p.w;
+			// Vulkan viewport covering the target, y already points down in clip space
+			x[i] = (p.x * inverseW * 0.5f + 0.5f) * width;
+			y[i] = (p.y * inverseW * 0.5f + 0.5f) * height;
+			triangle.depth[i] = p.z * inverseW;
+			triangle.inverseW[i] = inverseW;
+			triangle.texCoordW[i][0] = corners[i].texCoord.x * inverseW;
+			triangle.texCoordW[i][1] = corners[i].texCoord.y * inverseW;
+		}
+
+		// Twice Vulkan's signed framebuffer area, positive for counter clockwise
+		float area = (x[0] - x[1]) * (y[2] - y[1]) - (y[0] - y[1]) * (x[2] - x[1]);
+		bool culled = !std::isfinite(area) || area == 0.0f ||
+			(cullMode == RasterCullMode::BACK && area < 0.0f) || (cullMode == RasterCullMode::FRONT && area > 0.0f);
+
+		triangle.minX = std::max(0, static_cast<int32_t>(std::floor(std::min({ x[0], x[1], x[2] }))));
+		triangle.minY = std::max(0, static_cast<int32_t>(std::floor(std::min({ y[0], y[1], y[2] }))));
+		triangle.maxX = std::min(static_cast<int32_t>(width) - 1, static_cast<int32_t>(std::floor(std::max({ x[0], x[1], x[2] }))));
+		triangle.maxY = std::min(static_cast<int32_t>(height) - 1, static_cast<int32_t>(std::floor(std::max({ y[0], y[1], y[2] }))));
+		if (culled || triangle.minX > triangle.maxX || triangle.minY > triangle.maxY) {
+			batch.culled++;
+			return;
+		}
+
+		// Edges flipped for clockwise triangles so inside is always positive
+		float sign = area > 0.0f ? 1.0f : -1.0f;
+		for (int i = 0; i < 3; i++) {
+			int a = (i + 1) % 3;
+			int b = (i + 2) % 3;
+			triangle.edgeA[i] = sign * (y[b] - y[a]);
+			triangle.edgeB[i] = sign * -(x[b] - x[a]);
+			triangle.originX[i] = x[a];
+			triangle.originY[i] = y[a];
+			// Left edges have the inside to their right, top edges have it below
+			triangle.topLeft[i] = triangle.edgeA[i] > 0.0f || (triangle.edgeA[i] == 0.0f && triangle.edgeB[i] > 0.0f);
+		}
+		triangle.inverseArea = 1.0f / std::abs(area);
+		triangle.draw = drawIndex;
+
+		uint32_t index = static_cast<uint32_t>(batch.triangles.size());
+		batch.triangles.push_back(triangle);
+		for (uint32_t tileY = triangle.minY / TILE_SIZE; tileY <= triangle.maxY / TILE_SIZE; tileY++) {
+			for (uint32_t tileX = triangle.minX / TILE_SIZE; tileX <= triangle.maxX / TILE_SIZE; tileX++) {
+				batch.bins[tileY * tilesX + tileX].push_back(index);
+				batch.binned++;
+			}
+		}
+	}
+
+	void SoftwareRasterizer::coverSpanScalar(const Triangle& triangle, int32_t x, int32_t y, const SpanTarget& target, uint8_t* masks)
+	{
+		std::fill(masks, masks + SPAN, uint8_t(0));
+		for (uint32_t s = 0; s < target.samples; s++) {
+			float sampleY = static_cast<float>(y) + target.sampleY[s];
+			float row[3];
+			for (int e = 0; e < 3; e++) {
+				row[e] = triangle.edgeB[e] * (sampleY - triangle.originY[e]);
+			}
+
+			float* depth = target.depth + s * target.samplePlane;
+			for (uint32_t i = 0; i < SPAN; i++) {
+				float sampleX = static_cast<float>(x + static_cast<int32_t>(i)) + target.sampleX[s];
+				float edge[3];
+				bool inside = true;
+				for (int e = 0; e < 3; e++) {
+					edge[e] = triangle.edgeA[e] * (sampleX - triangle.originX[e]) + row[e];
+					inside = inside && (triangle.topLeft[e] ? edge[e] >= 0.0f : edge[e] > 0.0f);
+				}
+				if (!inside) continue;
+
+				float z = triangle.depth[0] * (edge[0] * triangle.inverseArea) + triangle.depth[1] * (edge[1] * triangle.inverseArea);
+				z = z + triangle.depth[2] * (edge[2] * triangle.inverseArea);
+				if (z < depth[i]) {
+					depth[i] = z;
+					masks[i] |= static_cast<uint8_t>(1u << s);
+				}
+			}
+		}
+	}
+
+	uint32_t SoftwareRasterizer::shade(const Triangle& triangle, int32_t x, int32_t y) const
+	{
+		const TextureImageData* texture = draws[triangle.draw].texture;
+		if (texture == nullptr) return 0xFFFFFFFF;
+
+		// Attributes at the pixel center, perspective correct
+		float centerX = static_cast<float>(x) + 0.5f;
+		float centerY = static_cast<float>(y) + 0.5f;
+		float weight[3];
+		for (int e = 0; e < 3; e++) {
+			weight[e] = (triangle.edgeA[e] * (centerX - triangle.originX[e]) + triangle.edgeB[e] * (centerY - triangle.originY[e])) * triangle.inverseArea;
+		}
+		float inverseW = weight[0] * triangle.inverseW[0] + weight[1] * triangle.inverseW[1] + weight[2] * triangle.inverseW[2];
+		float u = weight[0] * triangle.texCoordW[0][0] + weight[1] * triangle.texCoordW[1][0] + weight[2] * triangle.texCoordW[2][0];
+		float v = weight[0] * triangle.texCoordW[0][1] + weight[1] * triangle.texCoordW[1][1] + weight[2] * triangle.texCoordW[2][1];
+		return sampleTexture(*texture, u / inverseW, v / inverseW);
+	}
+
+	void SoftwareRasterizer::rasterizeTile(uint32_t tile, std::atomic<size_t>& shaded)
+	{
+		int32_t tileX0 = static_cast<int32_t>((tile % tilesX) * TILE_SIZE);
+		int32_t tileY0 = static_cast<int32_t>((tile / tilesX) * TILE_SIZE);
+		int32_t tileX1 = std::min(tileX0 + static_cast<int32_t>(TILE_SIZE), static_cast<int32_t>(width));
+		int32_t tileY1 = std::min(tileY0 + static_cast<int32_t>(TILE_SIZE), static_cast<int32_t>(height));
+		// Spans may run into the row padding, never into the next tile
+		int32_t spanX1 = std::min(static_cast<int32_t>((tileX1 + SPAN - 1) / SPAN * SPAN), static_cast<int32_t>(stride));
+
+		size_t plane = static_cast<size_t>(stride) * height;
+		for (uint32_t s = 0; s < samples; s++) {
+			for (int32_t y = tileY0; y < tileY1; y++) {
+				size_t row = s * plane + static_cast<size_t>(y) * stride;
+				std::fill(depthSamples.begin() + row + tileX0, depthSamples.begin() + row + spanX1, 1.0f);
+				std::fill(colorSamples.begin() + row + tileX0, colorSamples.begin() + row + spanX1, clearColor);
+			}
+		}
+
+		SpanTarget target{ nullptr, plane, sampleXFor(samples), sampleYFor(samples), samples };
+		auto cover = simd && TransformKernels::hasAvx2() ? &SoftwareRasterizer::coverSpanAvx2 : &SoftwareRasterizer::coverSpanScalar;
+		static_assert(SPAN == sizeof(uint64_t), "Span masks are tested as one word");
+		uint8_t masks[SPAN];
+		size_t shadedPixels = 0;
+
+		for (const Batch& batch : batches) {
+			for (uint32_t index : batch.bins[tile]) {
+				const Triangle& triangle = batch.triangles[index];
+				int32_t y0 = std::max(tileY0, triangle.minY);
+				int32_t y1 = std::min(tileY1 - 1, triangle.maxY);
+				int32_t x0 = std::max(tileX0, triangle.minX) / static_cast<int32_t>(SPAN) * static_cast<int32_t>(SPAN);
+				int32_t x1 = std::min(tileX1 - 1, triangle.maxX);
+
+				for (int32_t y = y0; y <= y1; y++) {
+					size_t row = static_cast<size_t>(y) * stride;
+					for (int32_t x = x0; x <= x1; x += SPAN) {
+						target.depth = depthSamples.data() + row + x;
+						cover(triangle, x, y, target, masks);
+						uint64_t anyCovered;
+						std::memcpy(&anyCovered, masks, sizeof(anyCovered));
+						if (anyCovered == 0) continue;
+
+						for (uint32_t i = 0; i < SPAN; i++) {
+							if (masks[i] == 0 || x + static_cast<int32_t>(i) >= tileX1) continue;
+							uint32_t color = shade(triangle, x + static_cast<int32_t>(i), y);
+							shadedPixels++;
+							for (uint32_t s = 0; s < samples; s++) {
+								if (masks[i] & (1u << s)) colorSamples[s * plane + row + x + i] = color;
+							}
+						}
+					}
+				}
+			}
+		}
+		shaded.fetch_add(shadedPixels, std::memory_order_relaxed);
+
+		// Resolve, the average of every sample. Packed colors are R, G, B, A in memory on every supported target.
+		for (int32_t y = tileY0; y < tileY1; y++) {
+			size_t row = static_cast<size_t>(y) * stride;
+			uint8_t* output = image.data() + (static_cast<size_t>(y) * width + tileX0) * 4;
+			if (samples == 1) {
+				std::memcpy(output, colorSamples.data() + row + tileX0, static_cast<size_t>(tileX1 - tileX0) * 4);
+				continue;
+			}
+			for (int32_t x = tileX0; x < tileX1; x++, output += 4) {
+				uint32_t sum[4] = { 0, 0, 0, 0 };
+				for (uint32_t s = 0; s < samples; s++) {
+					uint32_t color = colorSamples[s * plane + row + x];
+					for (int c = 0; c < 4; c++) {
+						sum[c] += (color >> (8 * c)) & 0xFF;
+					}
+				}
+				for (int c = 0; c < 4; c++) {
+					output[c] = static_cast<uint8_t>((sum[c] + samples / 2) / samples);
+				}
+			}
+		}
+	}
+
+	bool SoftwareRasterizer::writeImage(const std::string& filePath, const uint8_t* pixels, uint32_t imageWidth, uint32_t imageHeight)
+	{
+		std::FILE* file = std::fopen(filePath.c_str(), "wb");
+		if (file == nullptr) return false;
+
+		std::fprintf(file, "P6\n%u %u\n255\n", imageWidth, imageHeight);
+		std::vector<uint8_t> row(static_cast<size_t>(imageWidth) * 3);
+		for (uint32_t y = 0; y < imageHeight; y++) {
+			const uint8_t* source = pixels + static_cast<size_t>(y) * imageWidth * 4;
+			for (uint32_t x = 0; x < imageWidth; x++) {
+				row[x * 3 + 0] = source[x * 4 + 0];
+				row[x * 3 + 1] = source[x * 4 + 1];
+				row[x * 3 + 2] = source[x * 4 + 2];
+			}
+			std::fwrite(row.data(), 1, row.size(), file);
+		}
+		return std::fclose(file) == 0;
+	}
+
+	ImageDifference SoftwareRasterizer::compare(const uint8_t* a, const uint8_t* b, uint32_t imageWidth, uint32_t imageHeight, int tolerance)
+	{
+		ImageDifference difference{};
+		size_t pixels = static_cast<size_t>(imageWidth) * imageHeight;
+		uint64_t total = 0;
+		for (size_t i = 0; i < pixels; i++) {
+			int worst = 0;
+			for (int c = 0; c < 4; c++) {
+				int channel = std::abs(static_cast<int>(a[i * 4 + c]) - static_cast<int>(b[i * 4 + c]));
+				worst = std::max(worst, channel);
+				total += channel;
+			}
+			difference.maxDifference = std::max(difference.maxDifference, worst);
+			if (worst > tolerance) difference.differingPixels++;
+		}
+		difference.meanDifference = pixels > 0 ? static_cast<double>(total) / (pixels * 4) : 0.0;
+		return difference;
+	}
+
+	const char* SoftwareRasterizer::activeKernel()
+	{
+		return TransformKernels::hasAvx2() ? "avx2" : "scalar";
+	}
+
+#if !defined(STARRY_AVX2_KERNELS)
+	// Only reachable when SoftwareRasterizerAvx2.cpp is built, see STARRY_ENABLE_AVX2
+	void SoftwareRasterizer::coverSpanAvx2(const Triangle& triangle, int32_t x, int32_t y, const SpanTarget& target, uint8_t* masks)
+	{
+		coverSpanScalar(triangle, x, y, target, masks);
+	}
+#endif
+}
@@ -0,0 +1,56 @@
+#include "SoftwareRasterizer.h"
+
+// Built with AVX2 code generation when STARRY_ENABLE_AVX2 is on, without FMA so every product rounds the
+// same way as in coverSpanScalar. Only called after the CPU check in TransformKernels.cpp passes.
+#if defined(STARRY_AVX2_KERNELS)
+#include <immintrin.h>
+
+namespace Starry
+{
+	void SoftwareRasterizer::coverSpanAvx2(const Triangle& triangle, int32_t x, int32_t y, const SpanTarget& target, uint8_t* masks)
+	{
+		static_assert(SPAN == 8, "One AVX register of pixels per span");
+
+		__m256 pixelX = _mm256_add_ps(_mm256_set1_ps(static_cast<float>(x)), _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f));
+		__m256 zero = _mm256_setzero_ps();
+		__m256 inverseArea = _mm256_set1_ps(triangle.inverseArea);
+
+		uint32_t sampleMasks[8] = {};
+		for (uint32_t s = 0; s < target.samples; s++) {
+			__m256 sampleX = _mm256_add_ps(pixelX, _mm256_set1_ps(target.sampleX[s]));
+			float sampleY = static_cast<float>(y) + target.sampleY[s];
+
+			__m256 edge[3];
+			__m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+			for (int e = 0; e < 3; e++) {
+				__m256 row = _mm256_set1_ps(triangle.edgeB[e] * (sampleY - triangle.originY[e]));
+				__m256 dx = _mm256_sub_ps(sampleX, _mm256_set1_ps(triangle.originX[e]));
+				edge[e] = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(triangle.edgeA[e]), dx), row);
+				__m256 covered = triangle.topLeft[e] ? _mm256_cmp_ps(edge[e], zero, _CMP_GE_OQ) : _mm256_cmp_ps(edge[e], zero, _CMP_GT_OQ);
+				inside = _mm256_and_ps(inside, covered);
+			}
+			if (_mm256_movemask_ps(inside) == 0) continue;
+
+			__m256 z = _mm256_add_ps(
+				_mm256_mul_ps(_mm256_set1_ps(triangle.depth[0]), _mm256_mul_ps(edge[0], inverseArea)),
+				_mm256_mul_ps(_mm256_set1_ps(triangle.depth[1]), _mm256_mul_ps(edge[1], inverseArea)));
+			z = _mm256_add_ps(z, _mm256_mul_ps(_mm256_set1_ps(triangle.depth[2]), _mm256_mul_ps(edge[2], inverseArea)));
+
+			float* depth = target.depth + s * target.samplePlane;
+			__m256 stored = _mm256_loadu_ps(depth);
+			__m256 pass = _mm256_and_ps(inside, _mm256_cmp_ps(z, stored, _CMP_LT_OQ));
+			_mm256_storeu_ps(depth, _mm256_blendv_ps(stored, z, pass));
+			sampleMasks[s] = static_cast<uint32_t>(_mm256_movemask_ps(pass));
+		}
+
+		// Sample major bits to pixel major
+		for (uint32_t i = 0; i < SPAN; i++) {
+			uint32_t mask = 0;
+			for (uint32_t s = 0; s < target.samples; s++) {
+				mask |= ((sampleMasks[s] >> i) & 1u) << s;
+			}
+			masks[i] = static_cast<uint8_t>(mask);
+		}
+	}
+}
+#endif
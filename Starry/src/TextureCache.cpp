@@ -0,0 +1,140 @@
+#include "TextureCache.h"
+
+#include "ContentHash.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+#include <vector>
+
+namespace Starry
+{
+	namespace
+	{
+		uint64_t alignUp(uint64_t value, uint64_t alignment)
+		{
+			return (value + alignment - 1) & ~(alignment - 1);
+		}
+	}
+
+	std::string TextureCache::cachePathFor(const std::string& sourcePath, const std::string& cacheDirectory, uint64_t sourceHash)
+	{
+		if (cacheDirectory.empty()) {
+			return sourcePath + ".stex";
+		}
+		std::filesystem::path source(sourcePath);
+		std::filesystem::path cached = std::filesystem::path(cacheDirectory) /
+			(source.stem().string() + "-" + hashToString(sourceHash) + ".stex");
+		return cached.string();
+	}
+
+	bool TextureCache::write(const std::string& filePath, const CookedTexture& texture, const TextureCookOptions& options,
+		uint64_t sourceHash, uint64_t sourceSize)
+	{
+		TextureCacheHeader header{};
+		header.version = VERSION;
+		header.format = static_cast<uint32_t>(texture.format);
+		header.compression = static_cast<uint32_t>(options.compression);
+		header.flags = flagsFor(options);
+		header.mipCount = static_cast<uint32_t>(texture.mips.size());
+		header.width = texture.width;
+		header.height = texture.height;
+		header.dataOffset = alignUp(sizeof(TextureCacheHeader) + texture.mips.size() * sizeof(TextureCacheMip), PAYLOAD_ALIGNMENT);
+		header.dataSize = texture.data.size();
+		header.sourceHash = sourceHash;
+		header.sourceSize = sourceSize;
+
+		std::vector<TextureCacheMip> mipTable(texture.mips.size());
+		for (size_t i = 0; i < texture.mips.size(); i++) {
+			mipTable[i] = { texture.mips[i].width, texture.mips[i].height, texture.mips[i].offset, texture.mips[i].size };
+		}
+
+		std::error_code error;
+		std::filesystem::path target(filePath);
+		if (target.has_parent_path()) {
+			std::filesystem::create_directories(target.parent_path(), error);
+		}
+
+		std::filesystem::path temporary = target;
+		temporary += ".tmp";
+
+		{
+			std::ofstream stream(temporary, std::ios::binary | std::ios::trunc);
+			if (!stream) return false;
+
+			static const char zeros[PAYLOAD_ALIGNMENT] = {};
+			uint64_t tableEnd = sizeof(header) + mipTable.size() * sizeof(TextureCacheMip);
+
+			stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			stream.write(reinterpret_cast<const char*>(mipTable.data()), static_cast<std::streamsize>(mipTable.size() * sizeof(TextureCacheMip)));
+			stream.write(zeros, static_cast<std::streamsize>(header.dataOffset - tableEnd));
+			stream.write(reinterpret_cast<const char*>(texture.data.data()), static_cast<std::streamsize>(texture.data.size()));
+
+			if (!stream.good()) {
+				stream.close();
+				std::filesystem::remove(temporary, error);
+				return false;
+			}
+		}
+
+		std::filesystem::rename(temporary, target, error);
+		if (error) {
+			std::filesystem::remove(temporary, error);
+			return false;
+		}
+		return true;
+	}
+
+	bool TextureCache::open(const std::string& filePath, uint64_t expectedSourceHash, uint64_t expectedSourceSize, const TextureCookOptions& options)
+	{
+		close();
+
+		if (!file.open(filePath) || file.size() < sizeof(TextureCacheHeader)) {
+			close();
+			return false;
+		}
+
+		std::memcpy(&header, file.data(), sizeof(header));
+
+		bool valid = std::memcmp(header.magic, TextureCacheHeader{}.magic, sizeof(header.magic)) == 0
+			&& header.version == VERSION
+			&& header.compression == static_cast<uint32_t>(options.compression)
+			&& header.flags == flagsFor(options)
+			&& header.format <= static_cast<uint32_t>(TextureFormat::BC3)
+			&& header.mipCount > 0
+			&& header.sourceHash == expectedSourceHash
+			&& header.sourceSize == expectedSourceSize
+			&& header.dataOffset % PAYLOAD_ALIGNMENT == 0
+			&& sizeof(TextureCacheHeader) + uint64_t(header.mipCount) * sizeof(TextureCacheMip) <= header.dataOffset
+			&& header.dataOffset + header.dataSize <= file.size();
+		if (valid) {
+			for (const TextureCacheMip& mip : mips()) {
+				valid = valid && mip.offset + mip.size <= header.dataSize;
+			}
+		}
+		if (!valid) {
+			close();
+			return false;
+		}
+		return true;
+	}
+
+	std::span<const TextureCacheMip> TextureCache::mips() const
+	{
+		if (!file.isOpen()) return {};
+		return { reinterpret_cast<const TextureCacheMip*>(file.data() + sizeof(TextureCacheHeader)), header.mipCount };
+	}
+
+	std::span<const uint8_t> TextureCache::payload() const
+	{
+		if (!file.isOpen()) return {};
+		return { reinterpret_cast<const uint8_t*>(file.data() + header.dataOffset), header.dataSize };
+	}
+
+	std::span<const uint8_t> TextureCache::mipData(size_t level) const
+	{
+		const TextureCacheMip& mip = mips()[level];
+		return { reinterpret_cast<const uint8_t*>(file.data() + header.dataOffset + mip.offset), mip.size };
+	}
+}
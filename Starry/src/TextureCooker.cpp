@@ -0,0 +1,385 @@
+#include "TextureCooker.h"
+
+#include "ContentHash.h"
+#include "JobSystem.h"
+#include "MappedFile.h"
+#include "Profiler.h"
+#include "TextureCache.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#define STARRY_SSE_KERNELS
+#include <emmintrin.h>
+#endif
+
+namespace Starry
+{
+	namespace
+	{
+		constexpr size_t BLOCK_TEXELS = 16;
+
+		// 4x4 block starting at (blockX, blockY), texels past the edge repeat the last row and column
+		void gatherBlock(const uint8_t* pixels, uint32_t width, uint32_t height, uint32_t blockX, uint32_t blockY, uint8_t block[BLOCK_TEXELS * 4])
+		{
+			for (uint32_t y = 0; y < 4; y++) {
+				uint32_t sourceY = std::min(blockY * 4 + y, height - 1);
+				for (uint32_t x = 0; x < 4; x++) {
+					uint32_t sourceX = std::min(blockX * 4 + x, width - 1);
+					std::memcpy(block + (y * 4 + x) * 4, pixels + (static_cast<size_t>(sourceY) * width + sourceX) * 4, 4);
+				}
+			}
+		}
+
+		uint16_t packRgb565(const float color[3])
+		{
+			auto quantize = [](float value, float scale) { return static_cast<uint16_t>(std::clamp(value * scale / 255.0f + 0.5f, 0.0f, scale)); };
+			return static_cast<uint16_t>((quantize(color[0], 31.0f) << 11) | (quantize(color[1], 63.0f) << 5) | quantize(color[2], 31.0f));
+		}
+
+		void unpackRgb565(uint16_t packed, int color[3])
+		{
+			int r = (packed >> 11) & 31;
+			int g = (packed >> 5) & 63;
+			int b = packed & 31;
+			color[0] = (r << 3) | (r >> 2);
+			color[1] = (g << 2) | (g >> 4);
+			color[2] = (b << 3) | (b >> 2);
+		}
+
+		// Endpoints on the block's principal axis, then every texel snapped to the nearest of the four
+		// palette colors. Writes the 8 byte BC1 color block, always in four color mode.
+		void encodeColorBlock(const uint8_t block[BLOCK_TEXELS * 4], uint8_t* output)
+		{
+			float mean[3] = { 0.0f, 0.0f, 0.0f };
+			for (size_t i = 0; i < BLOCK_TEXELS; i++) {
+				for (int c = 0; c < 3; c++) mean[c] += block[i * 4 + c];
+			}
+			for (int c = 0; c < 3; c++) mean[c] /= BLOCK_TEXELS;
+
+			float covariance[6] = {};
+			for (size_t i = 0; i < BLOCK_TEXELS; i++) {
+				float r = block[i * 4 + 0] - mean[0];
+				float g = block[i * 4 + 1] - mean[1];
+				float b = block[i * 4 + 2] - mean[2];
+				covariance[0] += r * r;
+				covariance[1] += r * g;
+				covariance[2] += r * b;
+				covariance[3] += g * g;
+				covariance[4] += g * b;
+				covariance[5] += b * b;
+			}
+
+			// Power iteration from the covariance row of the channel that varies most, a few steps are
+			// plenty for a 3x3 matrix
+			int widest = covariance[0] >= covariance[3] ? (covariance[0] >= covariance[5] ? 0 : 2) : (covariance[3] >= covariance[5] ? 1 : 2);
+			const int rows[3][3] = { { 0, 1, 2 }, { 1, 3, 4 }, { 2, 4, 5 } };
+			float axis[3] = { covariance[rows[widest][0]], covariance[rows[widest][1]], covariance[rows[widest][2]] };
+			if (covariance[rows[widest][widest]] < 1e-6f) {
+				axis[0] = axis[1] = axis[2] = 1.0f;
+			}
+			for (int iteration = 0; iteration < 4; iteration++) {
+				float next[3] = {
+					covariance[0] * axis[0] + covariance[1] * axis[1] + covariance[2] * axis[2],
+					covariance[1] * axis[0] + covariance[3] * axis[1] + covariance[4] * axis[2],
+					covariance[2] * axis[0] + covariance[4] * axis[1] + covariance[5] * axis[2]
+				};
+				float length = std::max({ std::fabs(next[0]), std::fabs(next[1]), std::fabs(next[2]) });
+				if (length < 1e-6f) break;
+				for (int c = 0; c < 3; c++) axis[c] = next[c] / length;
+			}
+
+			float minimum = 1e30f, maximum = -1e30f;
+			for (size_t i = 0; i < BLOCK_TEXELS; i++) {
+				float projected = (block[i * 4 + 0] - mean[0]) * axis[0] + (block[i * 4 + 1] - mean[1]) * axis[1] + (block[i * 4 + 2] - mean[2]) * axis[2];
+				minimum = std::min(minimum, projected);
+				maximum = std::max(maximum, projected);
+			}
+			// The axis is unit in its largest component, bring the projections back to color units
+			float axisLengthSquared = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2];
+			float high[3], low[3];
+			for (int c = 0; c < 3; c++) {
+				high[c] = mean[c] + axis[c] * maximum / axisLengthSquared;
+				low[c] = mean[c] + axis[c] * minimum / axisLengthSquared;
+			}
+
+			uint16_t color0 = packRgb565(high);
+			uint16_t color1 = packRgb565(low);
+			if (color0 < color1) std::swap(color0, color1);
+
+			int palette[4][3];
+			unpackRgb565(color0, palette[0]);
+			unpackRgb565(color1, palette[1]);
+			for (int c = 0; c < 3; c++) {
+				palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+				palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+			}
+
+			uint32_t indices = 0;
+			if (color0 != color1) {
+				for (size_t i = 0; i < BLOCK_TEXELS; i++) {
+					int best = 0;
+					int bestDistance = INT32_MAX;
+					for (int p = 0; p < 4; p++) {
+						int dr = block[i * 4 + 0] - palette[p][0];
+						int dg = block[i * 4 + 1] - palette[p][1];
+						int db = block[i * 4 + 2] - palette[p][2];
+						int distance = dr * dr + dg * dg + db * db;
+						if (distance < bestDistance) {
+							bestDistance = distance;
+							best = p;
+						}
+					}
+					indices |= static_cast<uint32_t>(best) << (i * 2);
+				}
+			}
+
+			output[0] = static_cast<uint8_t>(color0);
+			output[1] = static_cast<uint8_t>(color0 >> 8);
+			output[2] = static_cast<uint8_t>(color1);
+			output[3] = static_cast<uint8_t>(color1 >> 8);
+			std::memcpy(output + 4, &indices, 4);
+		}
+
+		// 8 byte BC3 alpha block in eight value mode between the block's extremes
+		void encodeAlphaBlock(const uint8_t block[BLOCK_TEXELS * 4], uint8_t* output)
+		{
+			int alpha0 = 0, alpha1 = 255;
+			for (size_t i = 0; i < BLOCK_TEXELS; i++) {
+				alpha0 = std::max<int>(alpha0, block[i * 4 + 3]);
+				alpha1 = std::min<int>(alpha1, block[i * 4 + 3]);
+			}
+
+			uint64_t indices = 0;
+			if (alpha0 != alpha1) {
+				int range = alpha0 - alpha1;
+				for (size_t i = 0; i < BLOCK_TEXELS; i++) {
+					// Step between alpha1 (0) and alpha0 (7), then the format's index order: 0 and 1 are
+					// the endpoints, 2..7 run from alpha0 down toward alpha1
+					int step = ((block[i * 4 + 3] - alpha1) * 7 + range / 2) / range;
+					uint64_t index = step == 7 ? 0 : step == 0 ? 1 : static_cast<uint64_t>(8 - step);
+					indices |= index << (i * 3);
+				}
+			}
+
+			output[0] = static_cast<uint8_t>(alpha0);
+			output[1] = static_cast<uint8_t>(alpha1);
+			for (int b = 0; b < 6; b++) {
+				output[2 + b] = static_cast<uint8_t>(indices >> (b * 8));
+			}
+		}
+
+		template <size_t BLOCK_BYTES, typename Encode>
+		void encodeBlocks(const uint8_t* pixels, uint32_t width, uint32_t height, uint8_t* blocks, Encode&& encode)
+		{
+			uint32_t blocksWide = (width + 3) / 4;
+			uint32_t blocksHigh = (height + 3) / 4;
+			JobSystem::get().parallelFor(blocksHigh, TextureCooker::PARALLEL_BLOCK_ROWS, [&](size_t begin, size_t end) {
+				uint8_t block[BLOCK_TEXELS * 4];
+				for (size_t blockY = begin; blockY < end; blockY++) {
+					for (uint32_t blockX = 0; blockX < blocksWide; blockX++) {
+						gatherBlock(pixels, width, height, blockX, static_cast<uint32_t>(blockY), block);
+						encode(block, blocks + (blockY * blocksWide + blockX) * BLOCK_BYTES);
+					}
+				}
+			});
+		}
+	}
+
+	size_t TextureCooker::levelSize(TextureFormat format, uint32_t width, uint32_t height)
+	{
+		size_t blocks = static_cast<size_t>((width + 3) / 4) * ((height + 3) / 4);
+		switch (format) {
+			case TextureFormat::BC1: return blocks * 8;
+			case TextureFormat::BC3: return blocks * 16;
+			default: return static_cast<size_t>(width) * height * 4;
+		}
+	}
+
+	bool TextureCooker::isOpaque(const TextureImageData& image)
+	{
+		for (size_t i = 3; i < image.pixels.size(); i += 4) {
+			if (image.pixels[i] != 255) return false;
+		}
+		return true;
+	}
+
+	void TextureCooker::downsample(const uint8_t* source, uint32_t width, uint32_t height, uint8_t* destination)
+	{
+		uint32_t outputWidth = std::max(1u, width / 2);
+		uint32_t outputHeight = std::max(1u, height / 2);
+
+		JobSystem::get().parallelFor(outputHeight, PARALLEL_ROWS, [&](size_t begin, size_t end) {
+			for (size_t y = begin; y < end; y++) {
+				const uint8_t* row0 = source + static_cast<size_t>(std::min<size_t>(y * 2, height - 1)) * width * 4;
+				const uint8_t* row1 = source + static_cast<size_t>(std::min<size_t>(y * 2 + 1, height - 1)) * width * 4;
+				uint8_t* output = destination + y * outputWidth * 4;
+
+				uint32_t x = 0;
+#if defined(STARRY_SSE_KERNELS)
+				// Four output texels per step from eight source texels on each row
+				if (width >= 2) {
+					const __m128i zero = _mm_setzero_si128();
+					const __m128i rounding = _mm_set1_epi16(2);
+					auto averagePairs = [&](__m128i top, __m128i bottom) {
+						__m128i low = _mm_add_epi16(_mm_unpacklo_epi8(top, zero), _mm_unpacklo_epi8(bottom, zero));
+						__m128i high = _mm_add_epi16(_mm_unpackhi_epi8(top, zero), _mm_unpackhi_epi8(bottom, zero));
+						low = _mm_add_epi16(low, _mm_srli_si128(low, 8));
+						high = _mm_add_epi16(high, _mm_srli_si128(high, 8));
+						return _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(low, high), rounding), 2);
+					};
+					for (; x + 4 <= outputWidth; x += 4) {
+						const uint8_t* top = row0 + x * 8;
+						const uint8_t* bottom = row1 + x * 8;
+						__m128i first = averagePairs(_mm_loadu_si128(reinterpret_cast<const __m128i*>(top)), _mm_loadu_si128(reinterpret_cast<const __m128i*>(bottom)));
+						__m128i second = averagePairs(_mm_loadu_si128(reinterpret_cast<const __m128i*>(top + 16)), _mm_loadu_si128(reinterpret_cast<const __m128i*>(bottom + 16)));
+						_mm_storeu_si128(reinterpret_cast<__m128i*>(output + x * 4), _mm_packus_epi16(first, second));
+					}
+				}
+#endif
+				for (; x < outputWidth; x++) {
+					size_t left = static_cast<size_t>(std::min(x * 2, width - 1)) * 4;
+					size_t right = static_cast<size_t>(std::min(x * 2 + 1, width - 1)) * 4;
+					for (int c = 0; c < 4; c++) {
+						output[x * 4 + c] = static_cast<uint8_t>((row0[left + c] + row0[right + c] + row1[left + c] + row1[right + c] + 2) >> 2);
+					}
+				}
+			}
+		});
+	}
+
+	void TextureCooker::encodeBC1(const uint8_t* pixels, uint32_t width, uint32_t height, uint8_t* blocks)
+	{
+		encodeBlocks<8>(pixels, width, height, blocks, [](const uint8_t* block, uint8_t* output) {
+			encodeColorBlock(block, output);
+		});
+	}
+
+	void TextureCooker::encodeBC3(const uint8_t* pixels, uint32_t width, uint32_t height, uint8_t* blocks)
+	{
+		encodeBlocks<16>(pixels, width, height, blocks, [](const uint8_t* block, uint8_t* output) {
+			encodeAlphaBlock(block, output);
+			encodeColorBlock(block, output + 8);
+		});
+	}
+
+	bool TextureCooker::cook(const TextureImageData& image, const TextureCookOptions& options, CookedTexture& cooked)
+	{
+		if (image.width == 0 || image.height == 0 || image.pixels.size() < static_cast<size_t>(image.width) * image.height * 4) {
+			return false;
+		}
+
+		switch (options.compression) {
+			case TextureCompression::NONE: cooked.format = TextureFormat::RGBA8; break;
+			case TextureCompression::BC1: cooked.format = TextureFormat::BC1; break;
+			case TextureCompression::BC3: cooked.format = TextureFormat::BC3; break;
+			case TextureCompression::AUTO: cooked.format = isOpaque(image) ? TextureFormat::BC1 : TextureFormat::BC3; break;
+		}
+		cooked.width = image.width;
+		cooked.height = image.height;
+		cooked.mips.clear();
+
+		uint32_t width = image.width;
+		uint32_t height = image.height;
+		uint64_t offset = 0;
+		while (true) {
+			uint64_t size = levelSize(cooked.format, width, height);
+			cooked.mips.push_back({ width, height, offset, size });
+			offset += size;
+			if (!options.mips || (width == 1 && height == 1)) break;
+			width = std::max(1u, width / 2);
+			height = std::max(1u, height / 2);
+		}
+		cooked.data.resize(offset);
+
+		// Each level filters the one before it, two scratch levels ping pong down the chain
+		std::vector<uint8_t> current;
+		std::vector<uint8_t> next;
+		const uint8_t* level = image.pixels.data();
+		for (size_t i = 0; i < cooked.mips.size(); i++) {
+			const TextureMip& mip = cooked.mips[i];
+			if (i > 0) {
+				const TextureMip& parent = cooked.mips[i - 1];
+				next.resize(static_cast<size_t>(mip.width) * mip.height * 4);
+				downsample(level, parent.width, parent.height, next.data());
+				current.swap(next);
+				level = current.data();
+			}
+
+			uint8_t* output = cooked.data.data() + mip.offset;
+			switch (cooked.format) {
+				case TextureFormat::BC1: encodeBC1(level, mip.width, mip.height, output); break;
+				case TextureFormat::BC3: encodeBC3(level, mip.width, mip.height, output); break;
+				default: std::memcpy(output, level, mip.size); break;
+			}
+		}
+		return true;
+	}
+
+	TextureCookStats TextureCooker::getStats()
+	{
+		TextureCookStats stats{};
+		stats.textures = cookedTextures.load(std::memory_order_relaxed);
+		stats.cacheHits = cacheHits.load(std::memory_order_relaxed);
+		stats.sourceBytes = sourceBytes.load(std::memory_order_relaxed);
+		stats.cookedBytes = cookedBytes.load(std::memory_order_relaxed);
+		return stats;
+	}
+
+	bool TextureCooker::cookFile(const std::string& filePath, const std::string& cacheDirectory, const TextureCookOptions& options,
+		CookedTexture& cooked, bool* cacheHit)
+	{
+		STARRY_PROFILE_SCOPE("Texture Cook");
+		if (cacheHit != nullptr) *cacheHit = false;
+
+		MappedFile source;
+		if (!source.open(filePath)) return false;
+
+		auto record = [&](bool hit) {
+			size_t uncompressed = 0;
+			for (const TextureMip& mip : cooked.mips) {
+				uncompressed += levelSize(TextureFormat::RGBA8, mip.width, mip.height);
+			}
+			cookedTextures.fetch_add(1, std::memory_order_relaxed);
+			cacheHits.fetch_add(hit ? 1 : 0, std::memory_order_relaxed);
+			sourceBytes.fetch_add(uncompressed, std::memory_order_relaxed);
+			cookedBytes.fetch_add(cooked.data.size(), std::memory_order_relaxed);
+			if (cacheHit != nullptr) *cacheHit = hit;
+		};
+
+		uint64_t sourceHash = hashBytes(source.data(), source.size());
+		std::string cachePath = TextureCache::cachePathFor(filePath, cacheDirectory, sourceHash);
+
+		TextureCache cache;
+		if (cache.open(cachePath, sourceHash, source.size(), options)) {
+			const TextureCacheHeader& header = cache.getHeader();
+			cooked.format = cache.getFormat();
+			cooked.width = header.width;
+			cooked.height = header.height;
+			cooked.mips.clear();
+			for (const TextureCacheMip& mip : cache.mips()) {
+				cooked.mips.push_back({ mip.width, mip.height, mip.offset, mip.size });
+			}
+			std::span<const uint8_t> payload = cache.payload();
+			cooked.data.assign(payload.begin(), payload.end());
+
+			record(true);
+			return true;
+		}
+
+		if (!decoder) return false;
+		TextureImageData image;
+		{
+			STARRY_PROFILE_SCOPE("Texture Decode");
+			if (!decoder(source.data(), source.size(), image)) return false;
+		}
+		if (!cook(image, options, cooked)) return false;
+
+		// A failed write only costs the next run another cook
+		TextureCache::write(cachePath, cooked, options, sourceHash, source.size());
+		record(false);
+		return true;
+	}
+}
@@ -1,61 +1,67 @@
 #include "Timer.h"
 
+#include "AsyncLog.h"
+
 #include <string>
 
 namespace Starry
 {
-	Timer::Timer() 
+	Timer::Timer()
 	{
 		startTime = std::chrono::high_resolution_clock::now();
 		currentTime = startTime.time_since_epoch().count();
 	}
-	Timer::~Timer() 
+	Timer::~Timer()
 	{
 		end();
 	}
-	void Timer::time() 
+	void Timer::time()
 	{
 		auto now_tp = std::chrono::high_resolution_clock::now();
 		uint64_t now = static_cast<uint64_t>(now_tp.time_since_epoch().count());
 
 		uint64_t delta = now - currentTime;
 
-		if (frameMetric.isHot == false) {
-			frameMetric.isHot = true;
+		if (!frameMetric.isHot.load(std::memory_order_relaxed)) {
+			frameMetric.isHot.store(true, std::memory_order_relaxed);
 		}
 		else {
 			frameMetric.totalTime += delta;
 			frameMetric.frameSamples++;
 			frameMetric.timeSinceFlush += delta;
+			frames.record(delta);
 		}
 		currentTime = now;
-		deltaTime = delta;
+		deltaTime.store(delta, std::memory_order_relaxed);
 		//if (frameMetric.isHot) { logFPS(); }
 	}
-	void Timer::stop() 
+	void Timer::stop()
 	{
 		time();
-		frameMetric.isHot = false;
+		frameMetric.isHot.store(false, std::memory_order_relaxed);
 	}
-	void Timer::end() 
+	void Timer::end()
 	{
 		currentTime = 0;
 		frameMetric.totalTime = 0;
 		frameMetric.frameSamples = 0;
-		frameMetric.isHot = false;
+		frameMetric.isHot.store(false, std::memory_order_relaxed);
+
+		frames.reset();
 	}
-	void Timer::logFPS() 
+	void Timer::logFPS()
 	{
 		if (!toLog || !hasMetric()) { return; }
 
 		frameMetric.timeSinceFlush = 0;
-		Alert("Current FPS: " + std::to_string(getFPS()), INFO_URGANT);
+		// Called from the render thread, which must not wait on the console
+		AsyncLog::get().post(LogLevel::INFO, "Current FPS: " + std::to_string(getFPS()));
 	}
-	int Timer::getFPS() 
+	int Timer::getFPS()
 	{
-		if (frameMetric.isHot == false) {
+		if (!frameMetric.isHot.load(std::memory_order_relaxed)) {
 			return -1;
 		}
-		return static_cast<int>(frameMetric.framesPerSecond());
+		return static_cast<int>(getFrameStats().fps + 0.5f);
 	}
-}
\ No newline at end of file
+}
@@ -0,0 +1,134 @@
+#include "TransformKernels.h"
+
+#if defined(_M_X64) || defined(__SSE2__)
+#define STARRY_SSE_KERNELS
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#define STARRY_NEON_KERNELS
+#include <arm_neon.h>
+#endif
+
+#if defined(STARRY_AVX2_KERNELS) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace Starry
+{
+	namespace
+	{
+		bool cpuHasAvx2()
+		{
+#if !defined(STARRY_AVX2_KERNELS)
+			return false;
+#elif defined(_MSC_VER)
+			int info[4];
+			__cpuid(info, 0);
+			if (info[0] < 7) return false;
+			__cpuid(info, 1);
+			bool osSavesYmm = (info[2] & (1 << 27)) && (_xgetbv(0) & 0x6) == 0x6;
+			bool fma = info[2] & (1 << 12);
+			__cpuidex(info, 7, 0);
+			return osSavesYmm && fma && (info[1] & (1 << 5));
+#else
+			return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+		}
+
+		const bool USE_AVX2 = cpuHasAvx2();
+	}
+
+	void TransformKernels::multiplyScalar(const glm::mat4& left, const glm::mat4* right, glm::mat4* output, size_t count)
+	{
+		for (size_t i = 0; i < count; i++) {
+			output[i] = left * right[i];
+		}
+	}
+
+	void TransformKernels::multiply(const glm::mat4& left, const glm::mat4* right, glm::mat4* output, size_t count)
+	{
+		if (USE_AVX2) {
+			multiplyAvx2(left, right, output, count);
+			return;
+		}
+
+#if defined(STARRY_SSE_KERNELS)
+		const float* l = &left[0][0];
+		__m128 column0 = _mm_loadu_ps(l + 0);
+		__m128 column1 = _mm_loadu_ps(l + 4);
+		__m128 column2 = _mm_loadu_ps(l + 8);
+		__m128 column3 = _mm_loadu_ps(l + 12);
+
+		for (size_t i = 0; i < count; i++) {
+			const float* r = &right[i][0][0];
+			float* o = &output[i][0][0];
+
+			// Load the whole right matrix first so output can alias it
+			__m128 r0 = _mm_loadu_ps(r + 0);
+			__m128 r1 = _mm_loadu_ps(r + 4);
+			__m128 r2 = _mm_loadu_ps(r + 8);
+			__m128 r3 = _mm_loadu_ps(r + 12);
+
+			for (__m128* column : { &r0, &r1, &r2, &r3 }) {
+				__m128 c = *column;
+				__m128 result = _mm_mul_ps(column0, _mm_shuffle_ps(c, c, 0x00));
+				result = _mm_add_ps(result, _mm_mul_ps(column1, _mm_shuffle_ps(c, c, 0x55)));
+				result = _mm_add_ps(result, _mm_mul_ps(column2, _mm_shuffle_ps(c, c, 0xAA)));
+				result = _mm_add_ps(result, _mm_mul_ps(column3, _mm_shuffle_ps(c, c, 0xFF)));
+				*column = result;
+			}
+
+			_mm_storeu_ps(o + 0, r0);
+			_mm_storeu_ps(o + 4, r1);
+			_mm_storeu_ps(o + 8, r2);
+			_mm_storeu_ps(o + 12, r3);
+		}
+#elif defined(STARRY_NEON_KERNELS)
+		const float* l = &left[0][0];
+		float32x4_t column0 = vld1q_f32(l + 0);
+		float32x4_t column1 = vld1q_f32(l + 4);
+		float32x4_t column2 = vld1q_f32(l + 8);
+		float32x4_t column3 = vld1q_f32(l + 12);
+
+		for (size_t i = 0; i < count; i++) {
+			// Four columns in one structured load, the whole matrix is read before anything is stored
+			float32x4x4_t r = vld1q_f32_x4(&right[i][0][0]);
+			float32x4x4_t result;
+			for (int c = 0; c < 4; c++) {
+				float32x4_t sum = vmulq_laneq_f32(column0, r.val[c], 0);
+				sum = vfmaq_laneq_f32(sum, column1, r.val[c], 1);
+				sum = vfmaq_laneq_f32(sum, column2, r.val[c], 2);
+				sum = vfmaq_laneq_f32(sum, column3, r.val[c], 3);
+				result.val[c] = sum;
+			}
+			vst1q_f32_x4(&output[i][0][0], result);
+		}
+#else
+		multiplyScalar(left, right, output, count);
+#endif
+	}
+
+	bool TransformKernels::hasAvx2()
+	{
+		return USE_AVX2;
+	}
+
+	const char* TransformKernels::activeKernel()
+	{
+		if (USE_AVX2) return "avx2";
+#if defined(STARRY_SSE_KERNELS)
+		return "sse2";
+#elif defined(STARRY_NEON_KERNELS)
+		return "neon";
+#else
+		return "scalar";
+#endif
+	}
+
+#if !defined(STARRY_AVX2_KERNELS)
+	// Only reachable when TransformKernelsAvx2.cpp is built, see STARRY_ENABLE_AVX2
+	void TransformKernels::multiplyAvx2(const glm::mat4& left, const glm::mat4* right, glm::mat4* output, size_t count)
+	{
+		multiplyScalar(left, right, output, count);
+	}
+#endif
+}
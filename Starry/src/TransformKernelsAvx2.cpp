@@ -0,0 +1,40 @@
+#include "TransformKernels.h"
+
+// Built with AVX2 and FMA code generation when STARRY_ENABLE_AVX2 is on. Only called after the
+// CPU check in TransformKernels.cpp passes.
+#if defined(STARRY_AVX2_KERNELS)
+#include <immintrin.h>
+
+namespace Starry
+{
+	void TransformKernels::multiplyAvx2(const glm::mat4& left, const glm::mat4* right, glm::mat4* output, size_t count)
+	{
+		// Every column of left in both 128 bit lanes, so one instruction produces two output columns
+		const float* l = &left[0][0];
+		__m256 column0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(l + 0));
+		__m256 column1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(l + 4));
+		__m256 column2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(l + 8));
+		__m256 column3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(l + 12));
+
+		for (size_t i = 0; i < count; i++) {
+			const float* r = &right[i][0][0];
+			float* o = &output[i][0][0];
+
+			__m256 columns01 = _mm256_loadu_ps(r + 0);
+			__m256 columns23 = _mm256_loadu_ps(r + 8);
+
+			__m256 result01 = _mm256_mul_ps(column0, _mm256_permute_ps(columns01, 0x00));
+			__m256 result23 = _mm256_mul_ps(column0, _mm256_permute_ps(columns23, 0x00));
+			result01 = _mm256_fmadd_ps(column1, _mm256_permute_ps(columns01, 0x55), result01);
+			result23 = _mm256_fmadd_ps(column1, _mm256_permute_ps(columns23, 0x55), result23);
+			result01 = _mm256_fmadd_ps(column2, _mm256_permute_ps(columns01, 0xAA), result01);
+			result23 = _mm256_fmadd_ps(column2, _mm256_permute_ps(columns23, 0xAA), result23);
+			result01 = _mm256_fmadd_ps(column3, _mm256_permute_ps(columns01, 0xFF), result01);
+			result23 = _mm256_fmadd_ps(column3, _mm256_permute_ps(columns23, 0xFF), result23);
+
+			_mm256_storeu_ps(o + 0, result01);
+			_mm256_storeu_ps(o + 8, result23);
+		}
+	}
+}
+#endif
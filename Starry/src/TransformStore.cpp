@@ -0,0 +1,203 @@
+#include "TransformStore.h"
+
+#include "Parallel.h"
+
+namespace Starry
+{
+	glm::mat4 LocalTransform::matrix() const
+	{
+		glm::mat4 result = glm::mat4_cast(rotation);
+		result[0] *= scale.x;
+		result[1] *= scale.y;
+		result[2] *= scale.z;
+		result[3] = glm::vec4(translation, 1.0f);
+		return result;
+	}
+
+	TransformStore::Handle TransformStore::create(const LocalTransform& local)
+	{
+		Handle handle;
+		if (freeHandles.empty()) {
+			handle = static_cast<Handle>(handleToDense.size());
+			handleToDense.push_back(0);
+			locals.emplace_back();
+			parents.push_back(INVALID_HANDLE);
+			firstChildren.push_back(INVALID_HANDLE);
+			nextSiblings.push_back(INVALID_HANDLE);
+			dirty.push_back(0);
+			dirtyHandles.push_back(INVALID_HANDLE);
+		}
+		else {
+			handle = freeHandles.back();
+			freeHandles.pop_back();
+		}
+
+		glm::mat4 matrix = local.matrix();
+		handleToDense[handle] = static_cast<uint32_t>(models.size());
+		models.push_back(matrix);
+		denseToHandle.push_back(handle);
+
+		locals[handle] = local;
+		parents[handle] = INVALID_HANDLE;
+		firstChildren[handle] = INVALID_HANDLE;
+		nextSiblings[handle] = INVALID_HANDLE;
+		// A reused handle may still be flagged from before it was destroyed, which only costs a recompute
+		return handle;
+	}
+
+	void TransformStore::destroy(Handle handle)
+	{
+		unlink(handle);
+		while (firstChildren[handle] != INVALID_HANDLE) {
+			setParent(firstChildren[handle], INVALID_HANDLE);
+		}
+
+		uint32_t dense = handleToDense[handle];
+		uint32_t last = static_cast<uint32_t>(models.size() - 1);
+
+		if (dense != last) {
+			models[dense] = models[last];
+			denseToHandle[dense] = denseToHandle[last];
+			handleToDense[denseToHandle[dense]] = dense;
+		}
+		models.pop_back();
+		denseToHandle.pop_back();
+
+		handleToDense[handle] = INVALID_HANDLE;
+		freeHandles.push_back(handle);
+	}
+
+	void TransformStore::setLocal(Handle handle, const LocalTransform& local)
+	{
+		locals[handle] = local;
+		markDirty(handle);
+	}
+
+	bool TransformStore::setParent(Handle handle, Handle parent)
+	{
+		if (parents[handle] == parent) return true;
+
+		for (Handle ancestor = parent; ancestor != INVALID_HANDLE; ancestor = parents[ancestor]) {
+			if (ancestor == handle) return false;
+		}
+
+		unlink(handle);
+		if (parent != INVALID_HANDLE) {
+			parents[handle] = parent;
+			nextSiblings[handle] = firstChildren[parent];
+			firstChildren[parent] = handle;
+		}
+		markDirty(handle);
+		return true;
+	}
+
+	void TransformStore::unlink(Handle handle)
+	{
+		Handle parent = parents[handle];
+		if (parent == INVALID_HANDLE) return;
+
+		if (firstChildren[parent] == handle) {
+			firstChildren[parent] = nextSiblings[handle];
+		}
+		else {
+			Handle sibling = firstChildren[parent];
+			while (nextSiblings[sibling] != handle) sibling = nextSiblings[sibling];
+			nextSiblings[sibling] = nextSiblings[handle];
+		}
+		parents[handle] = INVALID_HANDLE;
+		nextSiblings[handle] = INVALID_HANDLE;
+	}
+
+	void TransformStore::markDirty(Handle handle)
+	{
+		if (dirty[handle]) return;
+		dirty[handle] = 1;
+		dirtyHandles[dirtyCount.fetch_add(1, std::memory_order_relaxed)] = handle;
+	}
+
+	bool TransformStore::hasDirtyAncestor(Handle handle) const
+	{
+		for (Handle ancestor = parents[handle]; ancestor != INVALID_HANDLE; ancestor = parents[ancestor]) {
+			if (dirty[ancestor]) return true;
+		}
+		return false;
+	}
+
+	glm::mat4 TransformStore::computeWorld(Handle handle) const
+	{
+		if (concurrentWrites || (!dirty[handle] && !hasDirtyAncestor(handle))) return world(handle);
+
+		// Everything above the highest flagged ancestor is current, compose down from there
+		Handle top = handle;
+		for (Handle ancestor = parents[handle]; ancestor != INVALID_HANDLE; ancestor = parents[ancestor]) {
+			if (dirty[ancestor]) top = ancestor;
+		}
+
+		glm::mat4 result = locals[handle].matrix();
+		for (Handle node = parents[handle]; node != INVALID_HANDLE && node != parents[top]; node = parents[node]) {
+			result = locals[node].matrix() * result;
+		}
+		if (parents[top] != INVALID_HANDLE) {
+			result = world(parents[top]) * result;
+		}
+		return result;
+	}
+
+	size_t TransformStore::propagateDirty()
+	{
+		// Handles under a flagged ancestor are covered by that ancestor's pass
+		roots.clear();
+		size_t count = dirtyCount.exchange(0, std::memory_order_acquire);
+		for (size_t i = 0; i < count; i++) {
+			Handle handle = dirtyHandles[i];
+			if (handleToDense[handle] == INVALID_HANDLE) {
+				dirty[handle] = 0; // Destroyed since it was flagged
+				continue;
+			}
+			if (!hasDirtyAncestor(handle)) roots.push_back(handle);
+		}
+
+		// Roots are disjoint subtrees, so batches of them never write the same matrix
+		JobSystem& jobs = JobSystem::get();
+		size_t batchCount = roots.size() < PARALLEL_ROOTS ? 1 :
+			std::min(jobs.threadCount() * JobSystem::BATCHES_PER_THREAD, roots.size() / PARALLEL_ROOTS);
+		batches.resize(std::max(batches.size(), batchCount));
+		for (auto& batch : batches) {
+			batch.changed.clear();
+		}
+
+		runParallel(batchCount, [&](size_t i) {
+			size_t begin = (roots.size() * i) / batchCount;
+			size_t end = (roots.size() * (i + 1)) / batchCount;
+			for (size_t root = begin; root < end; root++) {
+				updateSubtree(roots[root], batches[i]);
+			}
+		});
+
+		size_t updated = 0;
+		for (const auto& batch : batches) {
+			updated += batch.changed.size();
+		}
+		return updated;
+	}
+
+	void TransformStore::updateSubtree(Handle root, UpdateBatch& batch)
+	{
+		batch.stack.clear();
+		batch.stack.push_back(root);
+		while (!batch.stack.empty()) {
+			Handle handle = batch.stack.back();
+			batch.stack.pop_back();
+
+			Handle parent = parents[handle];
+			glm::mat4 local = locals[handle].matrix();
+			models[handleToDense[handle]] = parent == INVALID_HANDLE ? local : models[handleToDense[parent]] * local;
+			dirty[handle] = 0;
+			batch.changed.push_back(handle);
+
+			for (Handle child = firstChildren[handle]; child != INVALID_HANDLE; child = nextSiblings[child]) {
+				batch.stack.push_back(child);
+			}
+		}
+	}
+}
@@ -0,0 +1,9 @@
+#include "VulkanBackend.h"
+
+namespace Starry
+{
+	VulkanBackend::VulkanBackend(std::shared_ptr<Render::Window>& window, const RenderConfig& configInput) : config(configInput)
+	{
+		context.Init(window, config);
+	}
+}